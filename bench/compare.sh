@@ -0,0 +1,63 @@
+#!/bin/sh
+# Compare a benchmark run against a baseline written by bench/run.sh and
+# exit with status 1 if any run regressed.
+#
+# usage: bench/compare.sh BASELINE LATEST
+#
+# A run regressed if its minimum got larger or went missing, if its wall
+# time grew by more than WALL_TOLERANCE percent (and WALL_FLOOR_MS
+# milliseconds, to ignore noise on short runs), or if it needed more than
+# DECISIONS_TOLERANCE percent more decisions. Decisions are only compared
+# when neither run had a probe time out, since they depend on the budget
+# otherwise.
+
+WALL_TOLERANCE=${WALL_TOLERANCE:-10}
+WALL_FLOOR_MS=${WALL_FLOOR_MS:-250}
+DECISIONS_TOLERANCE=${DECISIONS_TOLERANCE:-5}
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 BASELINE LATEST" >&2
+    exit 2
+fi
+if [ ! -f "$1" ]; then
+    echo "$0: no baseline at $1, run make bench-baseline first" >&2
+    exit 0
+fi
+
+awk -F, -v wall_tol="$WALL_TOLERANCE" -v wall_floor="$WALL_FLOOR_MS" \
+    -v dec_tol="$DECISIONS_TOLERANCE" '
+    FNR == 1 { next }
+    NR == FNR {
+        key = $1 "/" $2
+        base_min[key] = $5; base_timeouts[key] = $7
+        base_wall[key] = $8; base_dec[key] = $10
+        next
+    }
+    {
+        key = $1 "/" $2
+        if (!(key in base_wall)) {
+            printf "%-24s new run, minimum %s, %d ms\n", key, $5, $8
+            next
+        }
+
+        verdict = "ok"
+        if ($5 == "" && base_min[key] != "")
+            verdict = "REGRESSION (no minimum found)"
+        else if ($5 != "" && base_min[key] != "" && $5 + 0 > base_min[key] + 0)
+            verdict = "REGRESSION (minimum " base_min[key] " -> " $5 ")"
+        else if ($8 > base_wall[key] * (1 + wall_tol / 100) \
+                 && $8 - base_wall[key] > wall_floor)
+            verdict = "REGRESSION (wall time)"
+        else if ($7 == 0 && base_timeouts[key] == 0 && base_dec[key] > 0 \
+                 && $10 > base_dec[key] * (1 + dec_tol / 100))
+            verdict = "REGRESSION (decisions)"
+        else if ($5 != "" && base_min[key] != "" && $5 + 0 < base_min[key] + 0)
+            verdict = "improved (minimum " base_min[key] " -> " $5 ")"
+
+        if (verdict ~ /^REGRESSION/) failed = 1
+        wall_change = base_wall[key] ? \
+            100 * ($8 - base_wall[key]) / base_wall[key] : 0
+        printf "%-24s %8d ms -> %8d ms (%+6.1f%%)  %s\n", key,
+               base_wall[key], $8, wall_change, verdict
+    }
+    END { exit failed }' "$1" "$2"
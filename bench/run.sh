@@ -0,0 +1,55 @@
+#!/bin/sh
+# Run every pattern under every engine configuration and write one CSV
+# line per run. The JSON statistics of each run are kept next to the CSV.
+#
+# usage: bench/run.sh [-b BUDGET] [-c CONFIGS] [-o OUTPUT] PATTERN...
+
+budget=30
+configs=bench/configs
+output=bench/latest.csv
+
+while getopts b:c:o: opt; do
+    case $opt in
+    b) budget=$OPTARG ;;
+    c) configs=$OPTARG ;;
+    o) output=$OPTARG ;;
+    *) echo "usage: $0 [-b BUDGET] [-c CONFIGS] [-o OUTPUT] PATTERN..." >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+    echo "$0: no patterns given" >&2
+    exit 2
+fi
+if [ ! -x ./gol-sat ]; then
+    echo "$0: ./gol-sat not found, run make first" >&2
+    exit 2
+fi
+
+runs=${output%.csv}.runs
+mkdir -p "$runs" || exit 1
+
+echo "pattern,config,budget,exit,minimum,probes,timeouts,wall_ms,engine_ms,decisions,backtracks,set_cells,consistifies,conflicts,max_depth" >"$output"
+
+grep -v -e '^#' -e '^[[:space:]]*$' "$configs" | while read -r config args; do
+    for pattern in "$@"; do
+        name=$(basename "$pattern" .txt)
+        json=$runs/$name-$config.json
+
+        rm -f "$json"
+        start=$(date +%s%N)
+        # shellcheck disable=SC2086
+        ./gol-sat -t "$budget" -j "$json" $args "$pattern" >/dev/null 2>&1
+        status=$?
+        end=$(date +%s%N)
+
+        printf '%s,%s,%s,%s,' "$name" "$config" "$budget" "$status" >>"$output"
+        wall_ms=$(((end - start) / 1000000))
+        awk -v wall_ms=$wall_ms -f bench/summary.awk "$json" 2>/dev/null \
+            >>"$output" || echo ",,,$wall_ms,,,,,,," >>"$output"
+
+        echo "$name/$config: exit $status" >&2
+    done
+done
@@ -0,0 +1,149 @@
+#!/bin/sh
+# Scaling study: generate random targets of growing size with gol-gen,
+# minimize each of them with gol-sat and summarize how solve time and
+# probe count grow with the size. Every target has a known predecessor,
+# whose population is recorded as an upper bound of the minimum.
+#
+# usage: bench/scaling.sh [-b BUDGET] [-d DENSITY] [-k KIND] [-n SEEDS]
+#                         [-o OUTPUT] SIZE...
+#
+# A SIZE is either N for an N x N target or COLSxROWS. Sizes that lifesrc
+# cannot search are listed as unsupported. If gnuplot is installed, the
+# results are also plotted next to the CSV.
+
+budget=30
+density=35
+kind=random
+seeds=3
+output=bench/scaling.csv
+
+# largest board lifesrc accepts, see ROW_MAX and COL_MAX in lifesrc.h
+max_rows=49
+max_cols=132
+
+while getopts b:d:k:n:o: opt; do
+    case $opt in
+    b) budget=$OPTARG ;;
+    d) density=$OPTARG ;;
+    k) kind=$OPTARG ;;
+    n) seeds=$OPTARG ;;
+    o) output=$OPTARG ;;
+    *) echo "usage: $0 [-b BUDGET] [-d DENSITY] [-k KIND] [-n SEEDS]" \
+            "[-o OUTPUT] SIZE..." >&2
+       exit 2 ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+    echo "$0: no sizes given" >&2
+    exit 2
+fi
+if [ ! -x ./gol-sat ] || [ ! -x ./gol-gen ]; then
+    echo "$0: ./gol-sat or ./gol-gen not found, run make first" >&2
+    exit 2
+fi
+
+runs=${output%.csv}.runs
+mkdir -p "$runs" || exit 1
+
+echo "cols,rows,cells,seed,bound,exit,minimum,probes,timeouts,wall_ms,engine_ms,decisions,backtracks,set_cells,consistifies,conflicts,max_depth" >"$output"
+
+for size in "$@"; do
+    case $size in
+    *x*) cols=${size%x*} rows=${size#*x} ;;
+    *) cols=$size rows=$size ;;
+    esac
+
+    seed=1
+    while [ "$seed" -le "$seeds" ]; do
+        name=$runs/${cols}x$rows-$seed
+        prefix="$cols,$rows,$((cols * rows)),$seed"
+
+        if ! ./gol-gen -c "$cols" -r "$rows" -d "$density" -k "$kind" \
+            -s "$seed" -p "$name.pred" >"$name.txt"; then
+            echo "$0: cannot generate a ${cols}x$rows target" >&2
+            exit 1
+        fi
+        bound=$(tail -n +2 "$name.pred" | tr -cd X | wc -c)
+
+        if [ "$rows" -gt $max_rows ] || [ "$cols" -gt $max_cols ]; then
+            echo "$prefix,$bound,unsupported,,,,,,,,,,," >>"$output"
+            echo "${cols}x$rows/$seed: unsupported" >&2
+            seed=$((seed + 1))
+            continue
+        fi
+
+        rm -f "$name.json"
+        start=$(date +%s%N)
+        ./gol-sat -t "$budget" -j "$name.json" "$name.txt" >/dev/null 2>&1
+        status=$?
+        end=$(date +%s%N)
+
+        wall_ms=$(((end - start) / 1000000))
+        printf '%s,%s,%s,' "$prefix" "$bound" "$status" >>"$output"
+        awk -v wall_ms=$wall_ms -f bench/summary.awk "$name.json" \
+            2>/dev/null >>"$output" || echo ",,,$wall_ms,,,,,,," >>"$output"
+
+        echo "${cols}x$rows/$seed: exit $status" >&2
+        seed=$((seed + 1))
+    done
+done
+
+# medians per size, runs that hit a timeout count as taking the budget
+awk -F, '
+    function median(list, n,    i, j, t, a) {
+        n = split(list, a, " ")
+        for (i = 2; i <= n; i++)
+            for (j = i; j > 1 && a[j - 1] + 0 > a[j] + 0; j--) {
+                t = a[j]; a[j] = a[j - 1]; a[j - 1] = t
+            }
+        return n ? a[int((n + 1) / 2)] : "-"
+    }
+    NR == 1 { next }
+    {
+        key = $1 "x" $2
+        if (!(key in seen)) { seen[key] = 1; order[++count] = key }
+        runs[key]++
+        if ($6 == "unsupported") { unsupported[key]++; next }
+        if ($6 == 0 && $9 == 0) solved[key]++
+        if ($7 != "") gap[key] = gap[key] " " ($5 - $7)
+        wall[key] = wall[key] " " $10
+        probes[key] = probes[key] " " $8
+    }
+    END {
+        printf "%-9s %5s %7s %12s %8s %11s\n", "size", "runs", "solved",
+               "wall ms", "probes", "bound-min"
+        for (i = 1; i <= count; i++) {
+            key = order[i]
+            if (unsupported[key]) {
+                printf "%-9s %5d %7s %12s %8s %11s\n", key, runs[key],
+                       "-", "unsupported", "-", "-"
+                continue
+            }
+            printf "%-9s %5d %7d %12s %8s %11s\n", key, runs[key],
+                   solved[key], median(wall[key]), median(probes[key]),
+                   median(gap[key])
+        }
+    }' "$output"
+
+if command -v gnuplot >/dev/null 2>&1; then
+    gnuplot <<GNUPLOT
+set datafile separator ","
+set terminal png size 1000,450
+set output "${output%.csv}.png"
+set multiplot layout 1,2
+set key off
+set xlabel "cells"
+set logscale y
+set ylabel "wall time (ms)"
+plot "$output" every ::1 using 3:(\$6 eq "unsupported" ? NaN : \$10) with points pt 7
+unset logscale y
+set ylabel "probes"
+plot "$output" every ::1 using 3:(\$6 eq "unsupported" ? NaN : \$8) with points pt 7
+unset multiplot
+GNUPLOT
+    echo "-- Plot written to ${output%.csv}.png" >&2
+fi
+
+exit 0
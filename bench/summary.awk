@@ -0,0 +1,21 @@
+# Turn the JSON statistics written by `gol-sat -j` into the CSV fields
+#   minimum,probes,timeouts,wall_ms,engine_ms,decisions,backtracks,
+#   set_cells,consistifies,conflicts,max_depth
+# The wall time is measured by the caller and passed in as wall_ms.
+
+/"minimum"/ {
+    gsub(/[",]/, "")
+    minimum = ($2 == "null") ? "" : $2
+}
+
+/"total"/ {
+    gsub(/[{}":,]/, " ")
+    for (i = 2; i < NF; i += 2) total[$i] = $(i + 1)
+}
+
+END {
+    printf "%s,%s,%s,%d,%.1f,%s,%s,%s,%s,%s,%s\n", minimum, total["probes"],
+           total["timeouts"], wall_ms, total["engine_ns"] / 1e6,
+           total["decisions"], total["backtracks"], total["set_cells"],
+           total["consistifies"], total["conflicts"], total["max_depth"]
+}
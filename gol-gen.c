@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "step.h"
+
+/* side length of the patches laid down by the "clusters" soups */
+#define CLUSTER_SIZE 4
+
+enum _golgen_kind {
+    GOLGEN_KIND_RANDOM,
+    GOLGEN_KIND_SYMMETRIC,
+    GOLGEN_KIND_CLUSTERS
+};
+
+struct _golgen_options {
+    int width;
+    int height;
+    int density;
+    unsigned long seed;
+    enum _golgen_kind kind;
+    int steps;
+    char *predecessor;
+};
+
+static void
+_golgen_usage(char *program)
+{
+    printf("Usage: %s [OPTIONS]...\n"
+           "Write a target pattern obtained by stepping a random soup, so "
+           "that it has an\nancestor with as many cells as the soup.\n"
+           "Options:\n"
+           "  -h          Display this help message\n"
+           "  -c COLS     Width of the target (default is 16)\n"
+           "  -r ROWS     Height of the target (default is 16)\n"
+           "  -d DENSITY  Percentage of live cells in the soup "
+           "(default is 35)\n",
+           program);
+    printf("  -s SEED     Seed of the random soup (default is 1)\n"
+           "  -k KIND     Soup kind: random, symmetric (mirrored left to "
+           "right) or\n"
+           "              clusters (%dx%d random patches) (default is "
+           "random)\n"
+           "  -g STEPS    Generations to step the soup (default is 1)\n"
+           "  -p FILE     Also write the soup, which is an ancestor, "
+           "to FILE\n",
+           CLUSTER_SIZE, CLUSTER_SIZE);
+}
+
+static int
+_golgen_parse(int argc, char **argv, struct _golgen_options *options)
+{
+    int opt;
+    extern char *optarg;
+
+    options->width = options->height = 16;
+    options->density = 35;
+    options->seed = 1;
+    options->kind = GOLGEN_KIND_RANDOM;
+    options->steps = 1;
+    options->predecessor = NULL;
+
+    while ((opt = getopt(argc, argv, "c:r:d:s:k:g:p:h")) != -1) {
+        switch (opt) {
+        case 'c':
+            options->width = atoi(optarg);
+            break;
+        case 'r':
+            options->height = atoi(optarg);
+            break;
+        case 'd':
+            options->density = atoi(optarg);
+            break;
+        case 's':
+            options->seed = strtoul(optarg, NULL, 10);
+            break;
+        case 'k':
+            if (strcmp(optarg, "random") == 0)
+                options->kind = GOLGEN_KIND_RANDOM;
+            else if (strcmp(optarg, "symmetric") == 0)
+                options->kind = GOLGEN_KIND_SYMMETRIC;
+            else if (strcmp(optarg, "clusters") == 0)
+                options->kind = GOLGEN_KIND_CLUSTERS;
+            else {
+                fprintf(stderr, "Unknown soup kind: %s\n", optarg);
+                return 0;
+            }
+            break;
+        case 'g':
+            options->steps = atoi(optarg);
+            break;
+        case 'p':
+            options->predecessor = optarg;
+            break;
+        case 'h':
+        default:
+            _golgen_usage(argv[0]);
+            return 0;
+        }
+    }
+
+    /* the soup keeps a dead margin, so that nothing is born outside */
+    if (options->width < 3 || options->height < 3) {
+        fprintf(stderr, "Targets must be at least 3x3\n");
+        return 0;
+    }
+    if (options->density < 0 || options->density > 100) {
+        fprintf(stderr, "Density must be a percentage\n");
+        return 0;
+    }
+    if (options->steps < 1) {
+        fprintf(stderr, "Steps must be positive\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+/* portable generator, so that a seed gives the same soup everywhere */
+static int
+_golgen_random_percent(unsigned long *state)
+{
+    *state = (*state * 1103515245ul + 12345ul) & 0xfffffffful;
+    return (int)((*state >> 16) % 100);
+}
+
+static void
+_golgen_soup(const struct _golgen_options *options, unsigned char *cells)
+{
+    const int width = options->width, height = options->height;
+    unsigned long state = options->seed;
+    int x, y, dx, dy;
+
+    memset(cells, 0, (size_t)width * height);
+
+    switch (options->kind) {
+    case GOLGEN_KIND_RANDOM:
+        for (y = 1; y < height - 1; ++y)
+            for (x = 1; x < width - 1; ++x)
+                cells[x + y * width] =
+                    _golgen_random_percent(&state) < options->density;
+        break;
+    case GOLGEN_KIND_SYMMETRIC:
+        for (y = 1; y < height - 1; ++y) {
+            for (x = 1; x < width / 2; ++x) {
+                const int alive =
+                    _golgen_random_percent(&state) < options->density;
+
+                cells[x + y * width] = (unsigned char)alive;
+                cells[(width - 1 - x) + y * width] = (unsigned char)alive;
+            }
+            /* the middle column of odd widths */
+            if (width % 2)
+                cells[width / 2 + y * width] =
+                    _golgen_random_percent(&state) < options->density;
+        }
+        break;
+    case GOLGEN_KIND_CLUSTERS:
+        /* patches start sparsely enough to cover about `density` percent */
+        for (y = 1; y < height - 1; ++y) {
+            for (x = 1; x < width - 1; ++x) {
+                if (_golgen_random_percent(&state) * CLUSTER_SIZE
+                        * CLUSTER_SIZE
+                    >= options->density)
+                {
+                    continue;
+                }
+                for (dy = 0; dy < CLUSTER_SIZE && y + dy < height - 1; ++dy)
+                    for (dx = 0; dx < CLUSTER_SIZE && x + dx < width - 1;
+                         ++dx)
+                        cells[(x + dx) + (y + dy) * width] =
+                            _golgen_random_percent(&state) < 50;
+            }
+        }
+        break;
+    }
+}
+
+static void
+_golgen_print(const unsigned char *cells, int width, int height, FILE *out)
+{
+    int x, y;
+
+    fprintf(out, "%d %d\n", width, height);
+    for (y = 0; y < height; ++y) {
+        for (x = 0; x < width; ++x)
+            fputc(cells[x + y * width] ? 'X' : '.', out);
+        fputc('\n', out);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    struct _golgen_options options;
+    unsigned char *soup, *target, *swap;
+    int exit_status = EXIT_FAILURE, step;
+
+    if (!_golgen_parse(argc, argv, &options)) return EXIT_FAILURE;
+
+    soup = malloc((size_t)options.width * options.height);
+    target = malloc((size_t)options.width * options.height);
+    if (!soup || !target) {
+        perror("malloc");
+        goto _cleanup;
+    }
+
+    _golgen_soup(&options, soup);
+    if (options.predecessor) {
+        FILE *f_predecessor = fopen(options.predecessor, "w");
+
+        if (!f_predecessor) {
+            perror(options.predecessor);
+            goto _cleanup;
+        }
+        _golgen_print(soup, options.width, options.height, f_predecessor);
+        fclose(f_predecessor);
+    }
+
+    /* every generation in between must fit the board as well */
+    for (step = 0; step < options.steps; ++step) {
+        if (golsat_step(soup, target, options.width, options.height) != 0) {
+            fprintf(stderr, "Soup grew outside of the target\n");
+            goto _cleanup;
+        }
+        swap = soup;
+        soup = target;
+        target = swap;
+    }
+
+    _golgen_print(soup, options.width, options.height, stdout);
+    exit_status = EXIT_SUCCESS;
+
+_cleanup:
+    free(soup);
+    free(target);
+
+    return exit_status;
+}
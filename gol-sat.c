@@ -5,29 +5,60 @@
 #include <time.h>
 #include <math.h>
 
-#include <sys/wait.h>
+#include <poll.h>
 #include <errno.h>
 
 #include "commandline.h"
+#include "coordinator.h"
+#include "daemon.h"
 #include "pattern.h"
-#include "popen2.h"
-
-#define LIFESRC_START_SEARCH " \n"
-#define LIFESRC_QUIT         "q\ny\n"
-#define LIFESRC_EXEC         LIFESRC_START_SEARCH LIFESRC_QUIT
-#define LIFESRC_EXEC_LEN     (sizeof(LIFESRC_EXEC) - 1)
+#include "orphan.h"
+#include "protocol.h"
+#include "runner.h"
+#include "session.h"
+#include "stats.h"
+#include "step.h"
+#include "tiling.h"
+#include "worker.h"
 
 #define TMPFILE_NAME "tmp.txt"
+#define CUBEFILE_NAME "cubes.txt"
+#define TILEFILE_NAME "tile.txt"
+#define NOGOODFILE_NAME "nogoods.txt"
+/* longest line of a cube file, see CUBE_LINE_SIZE */
+#define CUBELINE_SIZE (GOLSAT_CUBE_MAX * 20)
+/* longest name of the files handed to lifesrc */
+#define FILENAME_SIZE 64
+/* seconds between the progress estimates of lifesrc */
+#define PROGRESS_SECS 5
+/* share of a probe searched from which its time left is always shown */
+#define PROGRESS_TRUSTED 0.01
+/* thousands of failed frontiers each lifesrc remembers, 16 bytes each */
+#define MEMO_THOUSANDS 1000
+/* times a tile is solved again before the one before it is, each time ruling
+ * out more cells, up to NOGOOD_MAX */
+#define TILE_RETRIES 16
 
-#define MAX_TOTAL_TIME_SECS 8 * 60
+/* the files handed to lifesrc, each pool process of a daemon has its own */
+static char _golsat_tmpfile[FILENAME_SIZE] = TMPFILE_NAME;
+static char _golsat_cubefile[FILENAME_SIZE] = CUBEFILE_NAME;
+static char _golsat_tilefile[FILENAME_SIZE] = TILEFILE_NAME;
+static char _golsat_nogoodfile[FILENAME_SIZE] = NOGOODFILE_NAME;
+/* the engine checkpoint of the probe of a session, NULL if not kept */
+static const char *_golsat_checkpoint;
+/* the next lifesrc run goes on from the checkpoint instead */
+static int _golsat_resume;
 
 struct _golsat_next {
-    char *last_state;
+    struct golsat_result *result;
     int live_cells;
+    time_t took;
+    struct golsat_probe_stats stats;
 };
 
 struct _golsat_timeout {
     time_t start_time;
+    int total;
     int remaining_total;
     int unused_time;
 };
@@ -41,49 +72,617 @@ _golsat_next_timeout(const struct golsat_pattern *pat,
     return (timer->remaining_total / max_iterations) + timer->unused_time;
 }
 
-static struct _golsat_next
-_golsat_next_search(const char command[1024])
+/* orderings that restarts and portfolio runs take in turn */
+static const char *_golsat_orderings[] = { "", "-oa", "-ow", "-om", "-f" };
+
+/* a lifesrc run of the probe going on, and how many came before it */
+struct _golsat_slot {
+    struct golsat_runner runner;
+    int active;
+    unsigned long runs;
+};
+
+/* the cubes of a split probe, which are searched in turn by the slots */
+struct _golsat_cubes {
+    unsigned long count;
+    unsigned long next; /* numbered from 1, like the lines of the file */
+    unsigned long refuted;
+};
+
+/* the Luby sequence 1 1 2 1 1 2 4 1 1 2 ..., starting at `i` = 1 */
+static unsigned long
+_golsat_luby(unsigned long i)
 {
-    struct popen2 exec = { 0 };
-    ssize_t bytes_read;
-    int exec_status;
+    unsigned long size = 1;
 
-    char output[2048] = { 0 };
-    struct _golsat_next result = { NULL, 0 };
+    for (;;) {
+        while (size < i)
+            size = size * 2 + 1;
+        if (size == i) return (size + 1) / 2;
+        /* the sequence repeats itself before its next power of two */
+        i -= size / 2;
+        size = 1;
+    }
+}
 
-    if (popen2(command, &exec) != 0) {
-        perror("popen2");
-        return result;
+/*
+ * Add the engine counters of a run and keep its result if it is the first
+ * one found. Returns the status of the run.
+ */
+static int
+_golsat_next_update(struct _golsat_next *next, struct golsat_result *result)
+{
+    int status;
+
+    if (!result) return REPORT_STOPPED;
+
+    next->stats.has_engine = 1;
+    next->stats.decisions += result->decisions;
+    next->stats.backtracks += result->backtracks;
+    next->stats.set_cells += result->set_cells;
+    next->stats.consistifies += result->consistifies;
+    next->stats.conflicts += result->conflicts;
+    if (result->max_depth > next->stats.max_depth)
+        next->stats.max_depth = result->max_depth;
+    next->stats.engine_ns += result->nanoseconds;
+
+    status = result->status;
+    if (status == REPORT_FOUND && !next->result) {
+        next->result = result;
+        next->live_cells = result->live_cells;
+        return status;
     }
+    golsat_result_cleanup(result);
+
+    return status;
+}
 
-    write(exec.to_child, LIFESRC_EXEC, LIFESRC_EXEC_LEN);
-    close(exec.to_child);
+/*
+ * The lifesrc options of a probe, returns their length. lifesrc searches
+ * the generations before the target jointly, the cell limit applying to
+ * the first one only.
+ */
+static int
+_golsat_arguments(char *arguments,
+                  const struct golsat_pattern *pat,
+                  const struct golsat_options *options,
+                  const int max_cells)
+{
+    const int len =
+        sprintf(arguments, "-r%d -c%d -g%d -a -p -mt%d -e%d -M%d",
+                pat->height, pat->width, options->steps + 1, max_cells,
+                PROGRESS_SECS, MEMO_THOUSANDS);
 
-    while ((bytes_read = read(exec.from_child, output, sizeof(output) - 1))
-           > 0) {
-        output[bytes_read] = '\0';
+    if (!options->rule_text) return len;
+    return len + sprintf(arguments + len, " -R%s", options->rule_text);
+}
 
-        if ((sscanf(output, "Found object (gen %*d, cells %d",
-                    &result.live_cells))) {
-            const size_t start_idx = strcspn(output, "\n") + 1,
-                         length = strspn(output + start_idx, "OX1.0 \n");
-            result.last_state = strndup(output + start_idx, length);
-            if (!result.last_state) perror("strndup");
-            break;
+/* start a lifesrc command line, returns its length */
+static int
+_golsat_command(char command[1024],
+                const struct golsat_pattern *pat,
+                const struct golsat_options *options,
+                const int max_cells,
+                const int timeout)
+{
+    /* lifesrc reports its counters on SIGTERM, `-k` covers a stuck one */
+    const int len =
+        sprintf(command, "timeout -k 1 %d %s ", timeout,
+                golsat_runner_engine(options->engine_options));
+
+    return len + _golsat_arguments(command + len, pat, options, max_cells);
+}
+
+/*
+ * Start the next run of a slot, which has the remaining time of the probe.
+ * For a split probe this searches the next cube. Otherwise runs are spread
+ * over the orderings and, with restarts, have a conflict limit following
+ * the Luby sequence. Returns 0 if no run was started.
+ */
+static int
+_golsat_slot_start(struct _golsat_slot *slot,
+                   const int index,
+                   const struct golsat_pattern *pat,
+                   const struct golsat_options *options,
+                   const int max_cells,
+                   const int timeout,
+                   struct _golsat_cubes *cubes)
+{
+    const size_t orderings =
+        sizeof(_golsat_orderings) / sizeof *_golsat_orderings;
+    const unsigned long run = slot->runs,
+                        seed = run * options->portfolio + index;
+    char command[1024];
+    int len;
+
+    if (_golsat_resume) {
+        /* the checkpoint holds the options of the search, not -e or -M */
+        sprintf(command, "timeout -k 1 %d %s -l %s -db%d %s -e%d -M%d",
+                timeout, golsat_runner_engine(options->engine_options),
+                _golsat_checkpoint, GOLSAT_SESSION_DUMP, _golsat_checkpoint,
+                PROGRESS_SECS, MEMO_THOUSANDS);
+        _golsat_resume = 0;
+    }
+    else {
+        len = _golsat_command(command, pat, options, max_cells, timeout);
+        if (cubes) {
+            if (cubes->next > cubes->count) return 0;
+            len += sprintf(command + len, " -k%lu %s", cubes->next++,
+                           _golsat_cubefile);
         }
-        else if (!strncmp(output, "No such object",
-                          sizeof("No such object") - 1)) {
-            break;
+        else {
+            if (seed)
+                len += sprintf(command + len, " %s -S%lu",
+                               _golsat_orderings[seed % orderings], seed);
+            if (options->restart_unit)
+                len += sprintf(command + len, " -C%lu",
+                               _golsat_luby(run + 1) * options->restart_unit);
         }
-        else if (!strncmp(output, "Timeout", sizeof("Timeout") - 1)) {
-            result.live_cells = -1;
-            break;
+        if (_golsat_checkpoint)
+            len += sprintf(command + len, " -db%d %s", GOLSAT_SESSION_DUMP,
+                           _golsat_checkpoint);
+        sprintf(command + len, " %s -i %s", options->engine_options,
+                _golsat_tmpfile);
+    }
+
+    if (!golsat_runner_start(&slot->runner, command)) return 0;
+    ++slot->runs;
+
+    return 1;
+}
+
+/*
+ * Keep the progress estimate of a run of the probe if it is the best one
+ * so far, and show it along with the time the rest of the probe would
+ * take at the same pace. Every cube counts as an equal part of a probe.
+ * Extrapolating from a tiny fraction gives wild times, which are only
+ * shown once they fit in the `timeout` of the probe.
+ */
+static void
+_golsat_next_progress(struct _golsat_next *next,
+                      struct golsat_runner *runner,
+                      const struct _golsat_cubes *cubes,
+                      const unsigned long elapsed_ns,
+                      const int timeout,
+                      FILE *f_stderr)
+{
+    double fraction = runner->progress.fraction, left;
+
+    runner->progressed = 0;
+    if (cubes) fraction = (cubes->refuted + fraction) / cubes->count;
+    if (next->stats.has_progress && fraction <= next->stats.progress) return;
+
+    next->stats.has_progress = 1;
+    next->stats.progress = fraction;
+    next->stats.progress_ns = elapsed_ns;
+    if (fraction <= 0) return;
+
+    left = elapsed_ns / 1e9 * (1 - fraction) / fraction;
+    if (fraction >= PROGRESS_TRUSTED || left <= timeout - elapsed_ns / 1e9)
+        fprintf(f_stderr, "\t-- %.2f%% searched, about %.0f secs left\n",
+                fraction * 100, left);
+    else
+        fprintf(f_stderr, "\t-- %.2f%% searched, time left unknown\n",
+                fraction * 100);
+}
+
+/*
+ * Run the lifesrc searches of a probe until one of them finds a
+ * predecessor or proves there is none, or until all of them time out.
+ * A split probe has no predecessor once all of its cubes are refuted.
+ */
+static void
+_golsat_next_search(const struct golsat_pattern *pat,
+                    const struct golsat_options *options,
+                    const int max_cells,
+                    const int timeout,
+                    struct _golsat_cubes *cubes,
+                    struct _golsat_next *next,
+                    FILE *f_stderr)
+{
+    struct _golsat_slot slots[GOLSAT_PORTFOLIO_MAX];
+    struct pollfd fds[GOLSAT_PORTFOLIO_MAX];
+    int indices[GOLSAT_PORTFOLIO_MAX];
+    const unsigned long clock_start = golsat_stats_clock();
+    int i, j, count, active = 0, stopping = 0;
+
+    for (i = 0; i < options->portfolio; ++i) {
+        slots[i].runs = 0;
+        slots[i].active = _golsat_slot_start(&slots[i], i, pat, options,
+                                             max_cells, timeout, cubes);
+        active += slots[i].active;
+    }
+
+    while (active) {
+        for (count = i = 0; i < options->portfolio; ++i) {
+            if (!slots[i].active) continue;
+            fds[count].fd = slots[i].runner.exec.from_child;
+            fds[count].events = POLLIN;
+            indices[count++] = i;
+        }
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) continue;
+            /* fall back to reading the runs one after the other */
+            perror("poll");
+            for (j = 0; j < count; ++j)
+                fds[j].revents = POLLIN;
+        }
+
+        for (j = 0; j < count; ++j) {
+            struct _golsat_slot *slot = &slots[indices[j]];
+            int status, elapsed;
+
+            if (!fds[j].revents) continue;
+            if (golsat_runner_read(&slot->runner)) {
+                if (slot->runner.progressed)
+                    _golsat_next_progress(next, &slot->runner, cubes,
+                                          golsat_stats_clock() - clock_start,
+                                          timeout, f_stderr);
+                continue;
+            }
+
+            status =
+                _golsat_next_update(next, golsat_runner_finish(&slot->runner));
+            slot->active = 0;
+            --active;
+
+            if (status == REPORT_NOT_EXIST
+                && (!cubes || ++cubes->refuted == cubes->count))
+            {
+                next->live_cells = 0;
+            }
+
+            if (next->result || next->live_cells == 0) {
+                /* the others can only confirm the outcome, stop them */
+                if (stopping) continue;
+                for (i = 0; i < options->portfolio; ++i)
+                    if (slots[i].active) golsat_runner_stop(&slots[i].runner);
+                stopping = 1;
+                continue;
+            }
+
+            elapsed =
+                (int)((golsat_stats_clock() - clock_start) / 1000000000ul);
+            if ((!cubes && !options->restart_unit) || elapsed >= timeout)
+                continue;
+            slot->active = _golsat_slot_start(slot, indices[j], pat, options,
+                                              max_cells, timeout - elapsed,
+                                              cubes);
+            active += slot->active;
+        }
+    }
+
+    for (i = 0; i < options->portfolio; ++i)
+        next->stats.runs += slots[i].runs;
+
+    /* no decisive result means every run was stopped, mostly by `timeout` */
+}
+
+/* merges the results of the jobs of a distributed probe */
+struct _golsat_gather {
+    struct _golsat_next *next;
+    struct _golsat_cubes *cubes;
+};
+
+static int
+_golsat_gather(void *data, size_t job, struct golsat_result *result)
+{
+    struct _golsat_gather *gather = data;
+    const int status = _golsat_next_update(gather->next, result);
+
+    (void)job;
+    if (status == REPORT_NOT_EXIST
+        && (!gather->cubes || ++gather->cubes->refuted == gather->cubes->count))
+    {
+        gather->next->live_cells = 0;
+    }
+
+    return gather->next->result || gather->next->live_cells == 0;
+}
+
+/*
+ * Like _golsat_next_search(), but the searches are run by the workers of
+ * the coordinator: a split probe has a job per cube, and otherwise the
+ * probe itself is the only job.
+ */
+static void
+_golsat_next_distribute(struct golsat_coordinator *coordinator,
+                        const struct golsat_pattern *pat,
+                        const struct golsat_options *options,
+                        const int max_cells,
+                        const int timeout,
+                        struct _golsat_cubes *cubes,
+                        struct _golsat_next *next)
+{
+    const unsigned long deadline =
+        golsat_stats_clock() + (unsigned long)timeout * 1000000000ul;
+    struct _golsat_gather gather;
+    struct golsat_jobs jobs;
+    char line[CUBELINE_SIZE];
+    FILE *f_cubes = NULL;
+    int len;
+
+    len = _golsat_arguments(jobs.arguments, pat, options, max_cells);
+    sprintf(jobs.arguments + len, " %s", options->engine_options);
+    jobs.cubes = NULL;
+    jobs.count = 1;
+
+    if (cubes) {
+        if (!(f_cubes = fopen(_golsat_cubefile, "r"))
+            || !(jobs.cubes = calloc(cubes->count, sizeof *jobs.cubes)))
+        {
+            perror(_golsat_cubefile);
+            if (f_cubes) fclose(f_cubes);
+            return;
         }
+        for (jobs.count = 0; jobs.count < cubes->count
+                             && fgets(line, sizeof(line), f_cubes);
+             ++jobs.count)
+        {
+            line[strcspn(line, "\n")] = '\0';
+            if (!(jobs.cubes[jobs.count] = malloc(strlen(line) + 1))) break;
+            strcpy(jobs.cubes[jobs.count], line);
+        }
+        fclose(f_cubes);
+        /* a cube left out is never refuted, so the probe stays undecided */
+    }
+
+    gather.next = next;
+    gather.cubes = cubes;
+    next->stats.runs += golsat_coordinator_run(coordinator, &jobs, deadline,
+                                               &_golsat_gather, &gather);
+
+    if (jobs.cubes) {
+        while (jobs.count)
+            free(jobs.cubes[--jobs.count]);
+        free(jobs.cubes);
+    }
+}
+
+/*
+ * Split a probe into cubes written to the cube file. Returns 1 if there
+ * are cubes to search, and 0 if the split decided the probe already or
+ * did not finish.
+ */
+static int
+_golsat_next_split(const struct golsat_pattern *pat,
+                   const struct golsat_options *options,
+                   const int max_cells,
+                   const int timeout,
+                   struct _golsat_cubes *cubes,
+                   struct _golsat_next *next)
+{
+    struct golsat_runner runner;
+    char command[1024];
+    FILE *f_cubes;
+    int len, status, c;
+
+    len = _golsat_command(command, pat, options, max_cells, timeout);
+    sprintf(command + len, " -K%d %s %s -i %s", options->cube_cells,
+            _golsat_cubefile, options->engine_options, _golsat_tmpfile);
+
+    if (!golsat_runner_start(&runner, command)) return 0;
+    ++next->stats.runs;
+    while (golsat_runner_read(&runner))
+        continue;
+
+    status = _golsat_next_update(next, golsat_runner_finish(&runner));
+    if (status == REPORT_NOT_EXIST) next->live_cells = 0;
+    if (status != REPORT_SPLIT) return 0;
+
+    if (!(f_cubes = fopen(_golsat_cubefile, "r"))) {
+        perror(_golsat_cubefile);
+        return 0;
+    }
+    cubes->count = 0;
+    while ((c = fgetc(f_cubes)) != EOF)
+        if (c == '\n') ++cubes->count;
+    fclose(f_cubes);
+    cubes->next = 1;
+    cubes->refuted = 0;
+
+    return cubes->count != 0;
+}
+
+/*
+ * Check that an ancestor found by lifesrc, its unknown cells taken as
+ * dead, evolves into the pattern within the board, ignoring the unknown
+ * cells of the pattern. Returns 0 if it does not, or on allocation failure.
+ */
+static int
+_golsat_verify(const struct golsat_result *result,
+               const struct golsat_pattern *pat,
+               const struct golsat_options *options)
+{
+    struct golsat_board *board, *next, *swap;
+    int ok = 0, x, y, step;
+
+    board = golsat_board_create(pat->width, pat->height);
+    next = golsat_board_create(pat->width, pat->height);
+    if (!board || !next) goto _cleanup;
+
+    for (y = 0; y < pat->height; ++y)
+        for (x = 0; x < pat->width; ++x)
+            golsat_board_set(board, x, y,
+                             golsat_result_get_cell(result, x, y)
+                                 == GOLSAT_CELLSTATE_ALIVE);
+
+    for (step = 0; step < options->steps; ++step) {
+        if (golsat_board_step(board, next, &options->rule) != 0)
+            goto _cleanup;
+        swap = board;
+        board = next;
+        next = swap;
+    }
+
+    for (y = 0; y < pat->height; ++y) {
+        for (x = 0; x < pat->width; ++x) {
+            const enum golsat_cellstate cell =
+                golsat_pattern_get_cell(pat, x, y);
+
+            if (cell != GOLSAT_CELLSTATE_UNKNOWN
+                && (cell == GOLSAT_CELLSTATE_ALIVE)
+                       != golsat_board_get(board, x, y))
+            {
+                goto _cleanup;
+            }
+        }
+    }
+    ok = 1;
+
+_cleanup:
+    if (board) golsat_board_cleanup(board);
+    if (next) golsat_board_cleanup(next);
+
+    return ok;
+}
+
+/*
+ * Run a lifesrc probe, a `max_cells` of 0 means no cell limit. The
+ * searches are handed out to workers if there is a `coordinator`.
+ */
+static struct _golsat_next
+_golsat_probe(struct golsat_coordinator *coordinator,
+              const struct golsat_pattern *pat,
+              const struct golsat_options *options,
+              const int max_cells,
+              struct _golsat_timeout *timer,
+              struct golsat_stats *stats,
+              FILE *f_stderr)
+{
+    int timeout = _golsat_next_timeout(pat, timer);
+    struct _golsat_next next = { 0 };
+    struct _golsat_cubes cubes;
+    time_t iter_start;
+    unsigned long clock_start;
+
+    /* `timeout 0` would never expire */
+    if (timeout < 1) timeout = 1;
+
+    if (max_cells)
+        fprintf(f_stderr,
+                "-- Searching for mt value: %d\t| Timeout: %d seconds\n",
+                max_cells, timeout);
+    else
+        fprintf(f_stderr,
+                "-- Searching for any predecessor\t| Timeout: %d seconds\n",
+                timeout);
+
+    iter_start = time(NULL);
+    clock_start = golsat_stats_clock();
+    next.live_cells = -1;
+    if ((!options->cube_cells || !max_cells) && coordinator) {
+        _golsat_next_distribute(coordinator, pat, options, max_cells,
+                                timeout, NULL, &next);
+    }
+    else if (!options->cube_cells || !max_cells) {
+        _golsat_next_search(pat, options, max_cells, timeout, NULL, &next,
+                            f_stderr);
+    }
+    else if (_golsat_next_split(pat, options, max_cells, timeout, &cubes,
+                                &next))
+    {
+        const int elapsed =
+            (int)((golsat_stats_clock() - clock_start) / 1000000000ul);
+
+        fprintf(f_stderr, "\t-- Split into %lu cubes\n", cubes.count);
+        if (elapsed < timeout && coordinator)
+            _golsat_next_distribute(coordinator, pat, options, max_cells,
+                                    timeout - elapsed, &cubes, &next);
+        else if (elapsed < timeout)
+            _golsat_next_search(pat, options, max_cells, timeout - elapsed,
+                                &cubes, &next, f_stderr);
+    }
+    /* an ancestor that does not check out is as good as none found */
+    if (next.result && !_golsat_verify(next.result, pat, options)) {
+        fprintf(stderr, "-- Error: lifesrc found a wrong ancestor with %d "
+                        "cells\n",
+                next.live_cells);
+        golsat_result_cleanup(next.result);
+        next.result = NULL;
+        next.live_cells = -1;
     }
-    waitpid(exec.child_pid, &exec_status, 0);
-    assert(WIFEXITED(exec_status) != 0 && "lifesrc terminated abnormally");
+    next.stats.wall_ns = golsat_stats_clock() - clock_start;
+    next.took = time(NULL) - iter_start;
+    timer->unused_time = timeout - next.took;
+    timer->remaining_total =
+        timer->total - (time(NULL) - timer->start_time);
+
+    next.stats.max_cells = max_cells;
+    next.stats.live_cells = next.live_cells;
+    if (next.result)
+        next.stats.outcome = GOLSAT_OUTCOME_FOUND;
+    else if (next.live_cells != -1)
+        next.stats.outcome = GOLSAT_OUTCOME_NONE;
+    else
+        next.stats.outcome = GOLSAT_OUTCOME_TIMEOUT;
+    if (!golsat_stats_add(stats, &next.stats)) perror("golsat_stats_add");
 
-    return result;
+    return next;
+}
+
+/*
+ * Run a probe as part of a `session`, if any. The outcome is taken from
+ * its journal when an earlier run got that far, with the time it took
+ * then, and is added to it otherwise.
+ */
+static struct _golsat_next
+_golsat_session_probe(struct golsat_session *session,
+                      struct golsat_coordinator *coordinator,
+                      const struct golsat_pattern *pat,
+                      const struct golsat_options *options,
+                      const int max_cells,
+                      struct _golsat_timeout *timer,
+                      struct golsat_stats *stats,
+                      FILE *f_stderr)
+{
+    struct golsat_session_probe probe;
+    struct _golsat_next next = { 0 };
+    int timeout;
+
+    if (!session)
+        return _golsat_probe(coordinator, pat, options, max_cells, timer,
+                             stats, f_stderr);
+
+    if (!golsat_session_replay(session, max_cells, &probe)) {
+        _golsat_resume = golsat_session_begin(session, max_cells);
+        if (_golsat_resume)
+            fprintf(f_stderr, "-- Resuming the interrupted probe from its "
+                              "checkpoint\n");
+        next = _golsat_probe(coordinator, pat, options, max_cells, timer,
+                             stats, f_stderr);
+        _golsat_resume = 0;
+
+        probe.max_cells = max_cells;
+        probe.outcome = next.stats.outcome;
+        probe.live_cells = next.live_cells;
+        probe.wall_ns = next.stats.wall_ns;
+        probe.result = next.result;
+        if (!golsat_session_end(session, &probe))
+            fprintf(stderr, "-- Error: Cannot write the session journal\n");
+
+        return next;
+    }
+
+    if ((timeout = _golsat_next_timeout(pat, timer)) < 1) timeout = 1;
+    fprintf(f_stderr, "-- Replaying mt value: %d from the session journal\n",
+            max_cells);
+    next.result = probe.result;
+    next.live_cells = probe.live_cells;
+    next.took = (time_t)(probe.wall_ns / 1000000000ul);
+    /* the time spent by the earlier run counts against the limit */
+    timer->start_time -= next.took;
+    timer->unused_time = timeout - next.took;
+    timer->remaining_total =
+        timer->total - (time(NULL) - timer->start_time);
+
+    next.stats.max_cells = max_cells;
+    next.stats.outcome = probe.outcome;
+    next.stats.live_cells = probe.live_cells;
+    next.stats.wall_ns = probe.wall_ns;
+    if (!golsat_stats_add(stats, &next.stats)) perror("golsat_stats_add");
+
+    return next;
 }
 
 static int
@@ -92,7 +691,7 @@ _golsat_convert_cnv_to_lifesrc_format(const struct golsat_pattern *pat)
     FILE *f_tmp;
     int y, x;
 
-    if (!(f_tmp = fopen(TMPFILE_NAME, "wb"))) {
+    if (!(f_tmp = fopen(_golsat_tmpfile, "wb"))) {
         perror("-- Error: tmpfile failed");
         return 0;
     }
@@ -117,85 +716,476 @@ _golsat_convert_cnv_to_lifesrc_format(const struct golsat_pattern *pat)
     return 1;
 }
 
-static void
-_golsat_print_cnv(char *lifesrc_board,
-                  const int width,
-                  const int height,
-                  FILE *out)
+/* the contents of a whole file, NULL on failure */
+static char *
+_golsat_read_text(const char *path)
+{
+    FILE *f_text;
+    char *text = NULL;
+    long size;
 
+    if (!(f_text = fopen(path, "rb"))) return NULL;
+    if (fseek(f_text, 0, SEEK_END) == 0 && (size = ftell(f_text)) >= 0
+        && fseek(f_text, 0, SEEK_SET) == 0
+        && (text = malloc((size_t)size + 1)))
+    {
+        text[fread(text, 1, (size_t)size, f_text)] = '\0';
+    }
+    fclose(f_text);
+
+    return text;
+}
+
+/* print a board using `alive` and `dead`, a NULL result prints all dead */
+static void
+_golsat_print_board(const struct golsat_result *result,
+                    const int width,
+                    const int height,
+                    const char alive,
+                    const char dead,
+                    FILE *out)
 {
-    fprintf(out, "%d %d\n", width, height);
+    int x, y;
 
-    /* UNSAT */
-    if (!lifesrc_board) {
-        int i, j;
-        for (i = 0; i < height; ++i) {
-            for (j = 0; j < width; ++j) {
-                fputc('0', out);
+    fprintf(out, "%d %d\n", width, height);
+    for (y = 0; y < height; ++y) {
+        for (x = 0; x < width; ++x) {
+            if (!result) {
+                fputc(dead, out);
+                continue;
+            }
+            switch (golsat_result_get_cell(result, x, y)) {
+            case GOLSAT_CELLSTATE_ALIVE:
+                fputc(alive, out);
+                break;
+            case GOLSAT_CELLSTATE_DEAD:
+                fputc(dead, out);
+                break;
+            case GOLSAT_CELLSTATE_UNKNOWN:
+                fputc('?', out);
+                break;
             }
-            fputc('\n', out);
         }
+        fputc('\n', out);
+    }
+}
+
+/* show the statistics of the probes, and write them to the -j file */
+static void
+_golsat_report_stats(const struct golsat_stats *stats,
+                     const struct golsat_options *options,
+                     FILE *f_stderr)
+{
+    FILE *f_stats;
+
+    fprintf(f_stderr, "-- Probe statistics:\n");
+    golsat_stats_print_table(stats, f_stderr);
+    if (!options->stats_file) return;
+
+    if (!(f_stats = fopen(options->stats_file, "w"))) {
+        fprintf(stderr, "-- Error: Cannot write %s\n", options->stats_file);
         return;
     }
+    golsat_stats_print_json(stats, options->pattern, f_stats);
+    fclose(f_stats);
+}
 
-    do {
-        switch (*lifesrc_board) {
-        case 'O':
-            fputc('1', out);
-            break;
-        case '.':
-            fputc('0', out);
+/*
+ * Search the board of a tile for an ancestor, the cells given by the tiles
+ * solved before it coming from the tile file. A tile solved again breaks
+ * the ties of the order another way, as restarts do, and rules out the
+ * `nogoods` lines unless NULL, which are cells it gave before to tiles
+ * that then had no ancestor.
+ */
+static void
+_golsat_tile_search(struct golsat_tiling *tiling,
+                    const struct golsat_tile *tile,
+                    const struct golsat_options *options,
+                    const unsigned attempt,
+                    const char *nogoods,
+                    const int timeout,
+                    struct _golsat_next *next,
+                    FILE *f_stderr)
+{
+    struct golsat_options tile_options = *options;
+    char engine_options[GOLSAT_ENGINE_OPTIONS_MAX + 2 * FILENAME_SIZE + 48];
+    struct golsat_pattern *board;
+    FILE *f_tile;
+    int len;
+
+    if (!(f_tile = fopen(_golsat_tilefile, "w"))) {
+        perror(_golsat_tilefile);
+        return;
+    }
+    board = golsat_tiling_board(tiling, tile, f_tile);
+    if (fclose(f_tile) != 0 || !board
+        || !_golsat_convert_cnv_to_lifesrc_format(board))
+    {
+        if (board) golsat_pattern_cleanup(board);
+        return;
+    }
+    if (nogoods) {
+        if (!(f_tile = fopen(_golsat_nogoodfile, "w"))) {
+            perror(_golsat_nogoodfile);
+            golsat_pattern_cleanup(board);
+            return;
+        }
+        fputs(nogoods, f_tile);
+        if (fclose(f_tile) != 0) {
+            golsat_pattern_cleanup(board);
+            return;
+        }
+    }
+
+    /* the dynamic order refutes a board far sooner than the others */
+    len = sprintf(engine_options, "%s -ip %s -oa", options->engine_options,
+                  _golsat_tilefile);
+    if (attempt) len += sprintf(engine_options + len, " -S%u", attempt);
+    if (nogoods)
+        sprintf(engine_options + len, " -kx %s", _golsat_nogoodfile);
+    tile_options.engine_options = engine_options;
+
+    _golsat_next_search(board, &tile_options, 0, timeout, NULL, next,
+                        f_stderr);
+    golsat_pattern_cleanup(board);
+}
+
+/*
+ * Whether the board of `failed` is found to have no ancestor within a
+ * second, before the `deadline` clock, with the loose cells of `tiling`.
+ */
+static int
+_golsat_tile_refuted(struct golsat_tiling *tiling,
+                     const struct golsat_tile *failed,
+                     const struct golsat_options *options,
+                     const char *nogoods,
+                     const unsigned long deadline,
+                     FILE *f_stderr)
+{
+    struct _golsat_next next = { 0 };
+
+    if (golsat_stats_clock() >= deadline) return 0;
+    next.result = NULL;
+    next.live_cells = -1;
+    _golsat_tile_search(tiling, failed, options, 0, nogoods, 1, &next,
+                        f_stderr);
+    if (next.result) golsat_result_cleanup(next.result);
+
+    return next.live_cells == 0;
+}
+
+/*
+ * Find which of the cells given to the board of `failed` by the tiles
+ * from `floor` on it has no ancestor with (see tiling.h), storing them in
+ * `cells`. The cells of each tile are left loose in turn, those of the
+ * tiles solved first first, and are kept loose if the board still has
+ * none. Then so are the cells of the last tile needed one by one, as they
+ * are what that tile rules out. Returns the number of cells stored.
+ */
+static int
+_golsat_tile_core(struct golsat_tiling *tiling,
+                  const struct golsat_tile *failed,
+                  const int floor,
+                  const struct golsat_options *options,
+                  const char *nogoods,
+                  const unsigned long deadline,
+                  int *cells,
+                  FILE *f_stderr)
+{
+    int loose[GOLSAT_TILE_BOARD_MAX * GOLSAT_TILE_BOARD_MAX];
+    unsigned char needed[GOLSAT_TILE_BOARD_MAX * GOLSAT_TILE_BOARD_MAX];
+    int count, kept = 0, first = 0, last = 0, owner, end, i;
+
+    count = golsat_tiling_given(tiling, failed, floor, cells);
+    memset(needed, 0, sizeof needed);
+    tiling->loose = loose;
+    tiling->loose_count = 0;
+    for (i = 0; i < count; i = end) {
+        owner = golsat_tiling_owner(tiling, cells[i]);
+        for (end = i;
+             end < count && golsat_tiling_owner(tiling, cells[end]) == owner;
+             ++end)
+            loose[tiling->loose_count++] = cells[end];
+        if (_golsat_tile_refuted(tiling, failed, options, nogoods, deadline,
+                                 f_stderr))
+            continue;
+        tiling->loose_count -= end - i;
+        memset(needed + i, 1, (size_t)(end - i));
+        first = i;
+        last = end;
+    }
+    (void)first; (void)last;
+    tiling->loose_count = 0;
+
+    for (i = 0; i < count; ++i)
+        if (needed[i]) cells[kept++] = cells[i];
+
+    return kept;
+}
+
+/*
+ * Append a `nogood` line to the nogoods of a tile, which are NULL while it
+ * has none. Returns 0 on allocation failure.
+ */
+static int
+_golsat_add_nogood(char **nogoods, const char *nogood)
+{
+    const size_t len = *nogoods ? strlen(*nogoods) : 0;
+    char *grown;
+
+    if (!(grown = realloc(*nogoods, len + strlen(nogood) + 1))) return 0;
+    strcpy(grown + len, nogood);
+    *nogoods = grown;
+
+    return 1;
+}
+
+/*
+ * Find an ancestor `options->steps` generations back of a pattern too
+ * large to be searched at once, a tile at a time (see tiling.h), writing
+ * its rows to `out` as they become final. A tile which times out is solved
+ * again with twice the time. A tile without an ancestor takes the search
+ * back to its neighbour solved last, to be solved another way, as far back
+ * as the band above the one reached. That neighbour rules out the cells it
+ * gave the tile, until a tile before it changes. The ancestor is not
+ * minimized. Returns the exit status of gol-sat.
+ */
+static int
+_golsat_tiled(const struct golsat_options *options,
+              FILE *f_pattern,
+              FILE *out,
+              FILE *f_stderr)
+{
+    const unsigned long clock_start = golsat_stats_clock();
+    unsigned long started;
+    struct golsat_tiling *tiling;
+    struct golsat_stats *stats;
+    struct golsat_tile tile, failed;
+    struct _golsat_next next = { 0 };
+    unsigned *attempts; /* of the tiles from `floor` on */
+    char **nogoods;     /* of the tiles from `floor` on, NULL if none */
+    char *nogood;
+    /* the cells a tile without an ancestor needs */
+    int cells[GOLSAT_TILE_BOARD_MAX * GOLSAT_TILE_BOARD_MAX], count;
+    int exit_status = EXIT_FAILURE, index = 0, floor = 0, reached = -1;
+    int tiles, ring, left, timeout, timeouts = 0, joined = 0, i;
+
+    if (!(stats = golsat_stats_create())) {
+        perror("golsat_stats_create");
+        return EXIT_FAILURE;
+    }
+    if (!(tiling = golsat_tiling_create(f_pattern, out, options->tile_size,
+                                        options->steps, &options->rule)))
+    {
+        fprintf(f_stderr, "-- Error: Pattern creation failed.\n");
+        golsat_stats_cleanup(stats);
+        return EXIT_FAILURE;
+    }
+    tiles = tiling->columns * tiling->bands;
+    ring = 2 * tiling->columns;
+    attempts = calloc(ring, sizeof *attempts);
+    if (!(nogoods = calloc(ring, sizeof *nogoods)) || !attempts) {
+        perror("calloc");
+        goto _cleanup;
+    }
+    fprintf(f_stderr, "-- Solving %dx%d tiles in %d bands of %d\n",
+            options->tile_size, options->tile_size, tiling->bands,
+            tiling->columns);
+
+    while (index < tiles) {
+        if (!joined) golsat_tiling_tile(tiling, index, &tile);
+        if (tile.band > reached) {
+            /* the band above the one before can no longer change */
+            reached = tile.band;
+            floor = reached > 0 ? (reached - 1) * tiling->columns : 0;
+            fprintf(f_stderr, "-- Band %d of %d\n", reached + 1,
+                    tiling->bands);
+            if (reached > 1
+                && !golsat_tiling_commit(tiling,
+                                         (reached - 1) * tiling->size))
+            {
+                fprintf(stderr, "-- Error: The tiles found do not evolve "
+                                "into the pattern\n");
+                break;
+            }
+        }
+
+        left = options->time_limit
+               - (int)((golsat_stats_clock() - clock_start) / 1000000000ul);
+        if (left <= 0) {
+            fprintf(f_stderr, "-- Error: Total time limit reached\n");
             break;
-        case '\n':
-        case '\0':
-            fputc(*lifesrc_board, out);
+        }
+        /*
+         * What is left is shared by the tiles left, as probes share it,
+         * a tile which timed out taking twice its share each time.
+         */
+        if ((timeout = left / (tiles - index)) < 1) timeout = 1;
+        timeout <<= timeouts;
+        if (timeout > left) timeout = left;
+
+        next.result = NULL;
+        next.live_cells = -1;
+        next.stats.has_progress = 0;
+        started = golsat_stats_clock();
+        /* a tile which timed out breaks the ties another way too */
+        _golsat_tile_search(tiling, &tile, options,
+                            attempts[index % ring] + timeouts,
+                            nogoods[index % ring], timeout, &next, f_stderr);
+        if (next.result) {
+            golsat_tiling_keep(tiling, &tile, next.result);
+            golsat_result_cleanup(next.result);
+            timeouts = joined = 0;
+            if (++index < tiles) {
+                attempts[index % ring] = 0;
+                free(nogoods[index % ring]);
+                nogoods[index % ring] = NULL;
+            }
+            continue;
+        }
+        if (next.live_cells == -1
+            && golsat_stats_clock() - started
+                   < (unsigned long)timeout * 1000000000ul)
+        {
+            /* lifesrc gave up before its time, it would again */
+            fprintf(f_stderr, "-- Error: The search of tile %d, %d failed\n",
+                    tile.column, tile.band);
             break;
-        case ' ':
+        }
+        if (next.live_cells == -1) {
+            fprintf(f_stderr, "\t-- Timeout for tile %d, %d after %d secs\n",
+                    tile.column, tile.band, timeout);
+            if (timeout < left) ++timeouts;
+            continue;
+        }
+        timeouts = 0;
+        if (index == 0) {
+            /* nothing was given to the first tile, its board has no way */
+            fprintf(f_stderr, "\t-- No ancestor %d generations back "
+                              "exists\n",
+                    options->steps);
             break;
-        case '?':
-        default:
-            fputc('?', out);
+        }
+
+        fprintf(f_stderr, "\t-- No ancestor for tile %d, %d\n", tile.column,
+                tile.band);
+        failed = tile;
+        count = _golsat_tile_core(
+            tiling, &failed, floor, options, nogoods[index % ring],
+            clock_start + options->time_limit * 1000000000ul, cells,
+            f_stderr);
+        /* back to the tile solved last which the tile needs cells of */
+        for (index = -1, i = 0; i < count; ++i)
+            if (golsat_tiling_owner(tiling, cells[i]) > index)
+                index = golsat_tiling_owner(tiling, cells[i]);
+        if (index != -1) golsat_tiling_tile(tiling, index, &tile);
+        if (index != -1 && ++attempts[index % ring] <= TILE_RETRIES) {
+            /* those cells of that tile are known not to work */
+            if ((nogood = golsat_tiling_nogood(tiling, &tile, cells, count))
+                && !_golsat_add_nogood(&nogoods[index % ring], nogood))
+                perror("realloc");
+            free(nogood);
+            /* and it is solved with the tile, if the board is not too big */
+            joined = golsat_tiling_join(tiling, &tile, &failed);
+        }
+        else if (index != -1) {
+            /* solved too many times, back to the neighbour before it */
+            while ((index = golsat_tiling_backjump(tiling, &tile, floor))
+                       != -1
+                   && ++attempts[index % ring] > TILE_RETRIES)
+            {
+                golsat_tiling_tile(tiling, index, &tile);
+            }
+            joined = 0;
+        }
+        if (index == -1) {
+            fprintf(f_stderr, "-- Error: No ancestor found for tile %d, %d "
+                              "within its band and the one above\n",
+                    failed.column, failed.band);
             break;
         }
-    } while (*++lifesrc_board != '\0');
+        if (!joined) golsat_tiling_tile(tiling, index, &tile);
+        fprintf(f_stderr, "\t-- Solving tile %d, %d again%s\n", tile.column,
+                tile.band, joined ? " along with the tiles after it" : "");
+    }
+
+    if (index == tiles && golsat_tiling_commit(tiling, tiling->height)) {
+        fprintf(f_stderr, "-- Ancestor with %d cells found\n",
+                tiling->live_cells);
+        stats->minimum = tiling->live_cells;
+        exit_status = EXIT_SUCCESS;
+    }
+    else if (index == tiles) {
+        fprintf(stderr, "-- Error: The tiles found do not evolve into the "
+                        "pattern\n");
+    }
+    golsat_tiling_abandon(tiling);
+
+    next.stats.wall_ns = golsat_stats_clock() - clock_start;
+    next.stats.live_cells = exit_status == EXIT_SUCCESS ? tiling->live_cells
+                                                        : -1;
+    next.stats.outcome = exit_status == EXIT_SUCCESS ? GOLSAT_OUTCOME_FOUND
+                                                     : GOLSAT_OUTCOME_TIMEOUT;
+    /* the progress is that of the tiles */
+    next.stats.has_progress = 1;
+    next.stats.progress = (double)(index > 0 ? index : 0) / tiles;
+    next.stats.progress_ns = next.stats.wall_ns;
+    if (!golsat_stats_add(stats, &next.stats)) perror("golsat_stats_add");
+    _golsat_report_stats(stats, options, f_stderr);
+
+_cleanup:
+    for (i = 0; nogoods && i < ring; ++i)
+        free(nogoods[i]);
+    free(nogoods);
+    free(attempts);
+    golsat_tiling_cleanup(tiling);
+    golsat_stats_cleanup(stats);
+
+    return exit_status;
 }
 
-int
-main(int argc, char **argv)
+/*
+ * Minimize the ancestor `options->steps` generations back of the pattern
+ * read from `f_pattern`, printing the best one found to `out`. Returns
+ * the exit status of gol-sat.
+ */
+static int
+_golsat_minimize(const struct golsat_options *options,
+                 FILE *f_pattern,
+                 FILE *out,
+                 FILE *f_stderr)
 {
     int exit_status = EXIT_FAILURE;
 
-    struct golsat_options options = { 0 };
     struct golsat_pattern *pat = NULL;
+    struct golsat_orphan orphan;
     struct _golsat_next next;
 
-    char command[1024];
-    FILE *f_pattern, *f_stderr;
-
     int low = 0, high, mid, best_value;
-    char *current_best = NULL;
+    struct golsat_result *current_best = NULL;
 
     struct _golsat_timeout timer = { 0 };
-    time_t iter_start, actual_time;
+    struct golsat_stats *stats;
+
+    struct golsat_coordinator *coordinator = NULL;
+    struct golsat_session *session = NULL;
+    char *lifesrc_text = NULL;
+
+    if (options->tile_size)
+        return _golsat_tiled(options, f_pattern, out, f_stderr);
 
     timer.start_time = time(NULL);
-    timer.remaining_total = MAX_TOTAL_TIME_SECS;
+    timer.total = timer.remaining_total = options->time_limit;
     timer.unused_time = 0;
 
-    if (!golsat_commandline_parse(argc, argv, &options)) {
-        return EXIT_FAILURE;
-    }
-    f_stderr = options.debug_enable ? stderr : fopen("/dev/null", "w");
-
-    fprintf(f_stderr, "-- Reading pattern from file: %s\n", options.pattern);
-    if (!(f_pattern = fopen(options.pattern, "r"))) {
-        fprintf(f_stderr, "-- Error: Cannot open %s\n", options.pattern);
+    if (!(stats = golsat_stats_create())) {
+        perror("golsat_stats_create");
         return EXIT_FAILURE;
     }
 
     if (!(pat = golsat_pattern_create(f_pattern))) {
         fprintf(f_stderr, "-- Error: Pattern creation failed.\n");
-        goto _cleanup_file;
+        goto _cleanup_stats;
     }
     high = pat->width * pat->height;
 
@@ -204,38 +1194,100 @@ main(int argc, char **argv)
         goto _cleanup_pat;
     }
 
-    while (low <= high) {
-        const int timeout = _golsat_next_timeout(pat, &timer);
+    if ((options->listen_address || options->session_file)
+        && !(lifesrc_text = _golsat_read_text(_golsat_tmpfile)))
+    {
+        perror(_golsat_tmpfile);
+        goto _cleanup_pat;
+    }
 
-        mid = (low + high) / 2;
+    if (options->session_file) {
+        if (!(session = golsat_session_open(
+                  options->session_file, lifesrc_text, options->steps,
+                  options->rule_text ? options->rule_text : "B3/S23",
+                  pat->width, pat->height)))
+        {
+            fprintf(f_stderr, "-- Error: Cannot open the session journal "
+                              "%s\n",
+                    options->session_file);
+            goto _cleanup_pat;
+        }
+        /* only a single local run per probe can be checkpointed */
+        if (options->portfolio == 1 && !options->restart_unit
+            && !options->cube_cells && !options->listen_address)
+        {
+            _golsat_checkpoint = session->checkpoint;
+        }
+    }
 
-        sprintf(command,
-                "timeout %d ./lifesrc -r%d -c%d -g2 -a -p -mt%d -i %s"
-                " || echo 'Timeout'",
-                timeout, pat->height, pat->width, mid, TMPFILE_NAME);
+    if (options->listen_address) {
+        if (!(coordinator = golsat_coordinator_create(
+                     options->listen_address, lifesrc_text)))
+        {
+            fprintf(f_stderr, "-- Error: Cannot coordinate workers on %s\n",
+                    options->listen_address);
+            goto _cleanup_pat;
+        }
+        fprintf(f_stderr, "-- Handing searches out to workers on %s\n",
+                options->listen_address);
+    }
 
+    /*
+     * Garden of Eden pre-check: an orphan tile rules out any ancestor. The
+     * tiles are those of Life, other rules go without.
+     */
+    if (!options->rule_text && golsat_orphan_scan(pat, &orphan)) {
         fprintf(f_stderr,
-                "-- Searching for mt value: %d\t| Timeout: %d seconds\n", mid,
-                timeout);
+                "-- Orphan tile %dx%d at x: %d, y: %d has no predecessor\n",
+                orphan.width, orphan.height, orphan.x, orphan.y);
+        low = high + 1;
+    }
+    else {
+        /* search without a cell limit, its population bounds the minimum */
+        next = _golsat_session_probe(session, coordinator, pat, options, 0,
+                                     &timer, stats, f_stderr);
 
-        iter_start = time(NULL);
-        next = _golsat_next_search(command);
-        actual_time = time(NULL) - iter_start;
-        timer.unused_time = timeout - actual_time;
-        timer.remaining_total =
-            MAX_TOTAL_TIME_SECS - (time(NULL) - timer.start_time);
+        if (next.result != NULL) {
+            fprintf(f_stderr,
+                    "\t-- Found predecessor with %d cells (took %ld secs)\n",
+                    next.live_cells, next.took);
+            current_best = next.result;
+            best_value = next.live_cells;
+            high = next.live_cells - 1;
+        }
+        else if (next.live_cells != -1) {
+            if (options->steps == 1)
+                fprintf(f_stderr, "\t-- No predecessor exists without a "
+                                  "cell limit, pattern is a Garden of Eden\n");
+            else
+                fprintf(f_stderr, "\t-- No ancestor %d generations back "
+                                  "exists without a cell limit\n",
+                        options->steps);
+            low = high + 1;
+        }
+        else {
+            fprintf(f_stderr, "\t-- Timeout without a cell limit\n");
+        }
+
+        if (options->minimize_disable) low = high + 1;
+    }
+
+    while (low <= high) {
+        mid = (low + high) / 2;
+        next = _golsat_session_probe(session, coordinator, pat, options,
+                                     mid, &timer, stats, f_stderr);
 
         if (timer.remaining_total <= 0) {
             fprintf(f_stderr, "-- Error: Total time limit reached\n");
             break;
         }
 
-        if (next.last_state != NULL) {
+        if (next.result != NULL) {
             fprintf(f_stderr,
                     "\t-- Found solution for mt value: %d (took %ld secs)\n",
-                    next.live_cells, actual_time);
-            if (current_best) free(current_best);
-            current_best = next.last_state;
+                    next.live_cells, next.took);
+            if (current_best) golsat_result_cleanup(current_best);
+            current_best = next.result;
             best_value = next.live_cells;
             high = next.live_cells - 1;
         }
@@ -244,25 +1296,143 @@ main(int argc, char **argv)
                     next.live_cells == -1 ? "Timeout" : "No solution", mid);
             low = mid + 1;
         }
-
-        if (options.minimize_disable) break;
     }
 
     if (!current_best) {
         fprintf(f_stderr, "-- Error: No SAT solution found\n");
     }
     else {
-        fprintf(f_stderr,
-                "-- Minimum mt value for SAT solution: %d\n%d %d\n%s\n",
-                best_value, pat->width, pat->height, current_best);
+        fprintf(f_stderr, "-- Minimum mt value for SAT solution: %d\n",
+                best_value);
+        _golsat_print_board(current_best, pat->width, pat->height, 'O', '.',
+                            f_stderr);
+        stats->minimum = best_value;
         exit_status = EXIT_SUCCESS;
     }
-    _golsat_print_cnv(current_best, pat->width, pat->height, stdout);
+    _golsat_print_board(current_best, pat->width, pat->height, '1', '0',
+                        out);
+
+    _golsat_report_stats(stats, options, f_stderr);
 
 _cleanup_pat:
-    if (current_best) free(current_best);
+    if (coordinator) golsat_coordinator_cleanup(coordinator);
+    if (session) golsat_session_cleanup(session);
+    _golsat_checkpoint = NULL;
+    free(lifesrc_text);
+    if (current_best) golsat_result_cleanup(current_best);
     golsat_pattern_cleanup(pat);
-_cleanup_file:
+_cleanup_stats:
+    golsat_stats_cleanup(stats);
+
+    return exit_status;
+}
+
+/* what the processes of a daemon solve requests with */
+struct _golsat_service {
+    const struct golsat_options *options;
+    FILE *f_stderr;
+};
+
+/* solve a request sent to a daemon, the daemon's options being defaults */
+static int
+_golsat_solve(void *data, const struct golsat_request *request, FILE *out)
+{
+    const struct _golsat_service *service = data;
+    struct golsat_options options = *service->options;
+    FILE *f_pattern;
+    int exit_status;
+
+    /* the options come from a client, they may only tune the search */
+    if (request->time_limit <= 0
+        || strlen(request->engine_options) > GOLSAT_ENGINE_OPTIONS_MAX
+        || !golsat_runner_tuning(request->engine_options))
+    {
+        fprintf(stderr, "-- Error: invalid request %lu\n", request->id);
+        return EXIT_FAILURE;
+    }
+    options.time_limit = request->time_limit;
+    options.engine_options = request->engine_options;
+    options.stats_file = NULL;
+    /* the journal would be shared by every request */
+    options.session_file = NULL;
+
+    fprintf(service->f_stderr, "-- Request %lu\n", request->id);
+    if (!(f_pattern = fmemopen(request->pattern, strlen(request->pattern),
+                               "r")))
+    {
+        perror("fmemopen");
+        return EXIT_FAILURE;
+    }
+    /* the processes of the pool share the directory */
+    sprintf(_golsat_tmpfile, "golsat-%ld.txt", (long)getpid());
+    sprintf(_golsat_cubefile, "golsat-%ld.cubes", (long)getpid());
+    sprintf(_golsat_tilefile, "golsat-%ld.tile", (long)getpid());
+    sprintf(_golsat_nogoodfile, "golsat-%ld.nogoods", (long)getpid());
+    exit_status = _golsat_minimize(&options, f_pattern, out,
+                                   service->f_stderr);
+    fclose(f_pattern);
+    remove(_golsat_tmpfile);
+    remove(_golsat_cubefile);
+    remove(_golsat_tilefile);
+    remove(_golsat_nogoodfile);
+
+    return exit_status;
+}
+
+int
+main(int argc, char **argv)
+{
+    int exit_status = EXIT_FAILURE;
+    struct golsat_options options = { 0 };
+    FILE *f_pattern, *f_stderr;
+
+    if (!golsat_commandline_parse(argc, argv, &options)) {
+        return EXIT_FAILURE;
+    }
+    if (options.worker_address) {
+        return golsat_worker_run(options.worker_address) ? EXIT_SUCCESS
+                                                         : EXIT_FAILURE;
+    }
+
+    f_stderr = options.debug_enable ? stderr : fopen("/dev/null", "w");
+
+    if (options.daemon_address) {
+        struct _golsat_service service;
+
+        service.options = &options;
+        service.f_stderr = f_stderr;
+        /* the coordinator would listen once per request */
+        options.listen_address = NULL;
+        fprintf(f_stderr, "-- Answering requests on %s with %d processes\n",
+                options.daemon_address, options.pool);
+        golsat_daemon_run(options.daemon_address, options.pool,
+                          &_golsat_solve, &service);
+        return EXIT_FAILURE;
+    }
+    if (options.submit_address) {
+        struct golsat_request request;
+
+        if (!(request.pattern = _golsat_read_text(options.pattern))) {
+            fprintf(stderr, "-- Error: Cannot open %s\n", options.pattern);
+            return EXIT_FAILURE;
+        }
+        request.id = (unsigned long)getpid();
+        request.time_limit = options.time_limit;
+        request.engine_options = options.engine_options;
+        exit_status =
+            golsat_daemon_submit(options.submit_address, &request, stdout);
+        free(request.pattern);
+
+        return exit_status;
+    }
+
+    fprintf(f_stderr, "-- Reading pattern from file: %s\n", options.pattern);
+    if (!(f_pattern = fopen(options.pattern, "r"))) {
+        fprintf(f_stderr, "-- Error: Cannot open %s\n", options.pattern);
+        return EXIT_FAILURE;
+    }
+    exit_status = _golsat_minimize(&options, f_pattern, stdout, f_stderr);
+
     fclose(f_pattern);
     if (options.debug_enable) fclose(f_stderr);
 
@@ -0,0 +1,338 @@
+/*
+ * Life search program - engine check.
+ * Searches for the parents of random targets with one engine alone at
+ * a time, and then with every engine on a thread of its own all at
+ * once, and checks that each engine did exactly the same work both
+ * times.  Any state that engines share behind each other's backs shows
+ * up as a difference in their counters.
+ *
+ * The search module is included directly, as for the micro benchmarks.
+ */
+
+#include "search.c"
+
+#include <pthread.h>
+#include <unistd.h>
+
+
+/*
+ * One search and what came of it.
+ */
+typedef struct
+{
+	int		rows;		/* size of the target */
+	int		cols;
+	Bool		dynamic;	/* order by conflict activity */
+	long		memoSize;	/* entries of the frontier memo */
+	unsigned long	seed;		/* seed of the random soup */
+	Status		status;		/* how the search ended */
+	int		cellCount;	/* live cells of the parent found */
+	unsigned long	hash;		/* hash of the parent found */
+	Stats		stats;		/* work done, apart from the time */
+} Check;
+
+
+static	Rules	lifeRules;	/* rules of every search */
+static	long	conflicts;	/* conflicts after which a search stops */
+
+
+static	void	usage(void);
+static	void *	runCheck(void *);
+static	int	makeSoup(Bool [ROW_MAX + 2][COL_MAX + 2], const Check *);
+static	Status	setTarget(Engine *, Bool [ROW_MAX + 2][COL_MAX + 2]);
+static	Bool	sameWork(const Check *, const Check *);
+static	void	printCheck(const char *, const Check *);
+
+
+/*
+ * The searches, which differ in their size and in the routines they
+ * go through.
+ */
+static	const Check	checkTable[] =
+{
+	{12, 12, FALSE, 0, 1},
+	{12, 12, TRUE, 0, 2},
+	{16, 16, FALSE, 100000, 3},
+	{16, 16, TRUE, 100000, 4},
+	{20, 14, FALSE, 100000, 5},
+	{14, 20, TRUE, 0, 6},
+	{24, 24, FALSE, 100000, 7},
+	{24, 24, TRUE, 100000, 8}
+};
+
+#define	CHECK_COUNT	((int) (sizeof(checkTable) / sizeof(checkTable[0])))
+
+
+int
+main(int argc, char ** argv)
+{
+	Check		alone[CHECK_COUNT];
+	Check		together[CHECK_COUNT];
+	pthread_t	threads[CHECK_COUNT];
+	int		failures;
+	int		opt;
+	int		i;
+
+	conflicts = 100000;
+
+	while ((opt = getopt(argc, argv, "C:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'C':
+				conflicts = atol(optarg);
+				break;
+
+			default:
+				usage();
+				exit(1);
+		}
+	}
+
+	if (conflicts <= 0)
+	{
+		usage();
+		exit(1);
+	}
+
+	lifeRules.bornRules[3] = ON;
+	lifeRules.liveRules[2] = ON;
+	lifeRules.liveRules[3] = ON;
+	initRules(&lifeRules);
+
+	for (i = 0; i < CHECK_COUNT; i++)
+	{
+		alone[i] = checkTable[i];
+		runCheck(&alone[i]);
+	}
+
+	for (i = 0; i < CHECK_COUNT; i++)
+	{
+		together[i] = checkTable[i];
+
+		if (pthread_create(&threads[i], NULL, runCheck, &together[i]))
+			fatal("Cannot create thread");
+	}
+
+	for (i = 0; i < CHECK_COUNT; i++)
+		pthread_join(threads[i], NULL);
+
+	failures = 0;
+
+	for (i = 0; i < CHECK_COUNT; i++)
+	{
+		printCheck("alone", &alone[i]);
+
+		if (sameWork(&alone[i], &together[i]))
+			continue;
+
+		printCheck("threaded", &together[i]);
+		failures++;
+	}
+
+	printf("%d of %d engines did the same work on threads\n",
+		CHECK_COUNT - failures, CHECK_COUNT);
+
+	return (failures ? 1 : 0);
+}
+
+
+static void
+usage(void)
+{
+	fprintf(stderr, "usage: enginecheck [-C conflicts]\n");
+}
+
+
+/*
+ * Search for a parent of the target of a check with an engine of its
+ * own, like a headless search given the target with -i does.
+ */
+static void *
+runCheck(void * arg)
+{
+	Bool		soup[ROW_MAX + 2][COL_MAX + 2];
+	Check *		check;
+	Engine *	eng;
+	const Cell *	cell;
+	int		row;
+	int		col;
+
+	check = (Check *) arg;
+	eng = newEngine(&lifeRules);
+
+	if (eng == NULL)
+		fatal("Cannot allocate search engine");
+
+	eng->rowMax = check->rows;
+	eng->colMax = check->cols;
+	eng->genMax = 2;
+	eng->parent = TRUE;
+	eng->allObjects = TRUE;
+	eng->orderDynamic = check->dynamic;
+	eng->memoSize = check->memoSize;
+	eng->conflictLimit = conflicts;
+
+	/*
+	 * The soup is a parent, and leaving room for more cells than
+	 * it has lets some of the searches find one before the limit.
+	 */
+	eng->maxCount = makeSoup(soup, check) * 3 / 2;
+
+	if (initCells(eng) != OK)
+		fatal(eng->error);
+
+	eng->inited = TRUE;
+	eng->curStatus = setTarget(eng, soup);
+	eng->baseSet = eng->nextSet;
+
+	if (eng->curStatus == OK)
+		eng->curStatus = search(eng);
+
+	check->status = eng->interrupted ? ERROR : eng->curStatus;
+	check->cellCount = eng->cellCount;
+	check->stats = eng->stats;
+	check->stats.nanoSeconds = 0;
+	check->hash = 0;
+
+	for (row = 1; (check->status == FOUND) && (row <= eng->rowMax); row++)
+	{
+		for (col = 1; col <= eng->colMax; col++)
+		{
+			cell = findCell(eng, row, col, 0);
+			check->hash = check->hash * 31 + cell->state;
+		}
+	}
+
+	freeEngine(eng);
+
+	return NULL;
+}
+
+
+/*
+ * Fill the board of a check with a random soup which leaves its
+ * outermost cells dead, so that nothing outside of the board disturbs
+ * the soup.  Returns the number of live cells.
+ */
+static int
+makeSoup(Bool soup[ROW_MAX + 2][COL_MAX + 2], const Check * check)
+{
+	unsigned long	seed;
+	int		count;
+	int		row;
+	int		col;
+
+	memset(soup, 0, sizeof(Bool) * (ROW_MAX + 2) * (COL_MAX + 2));
+	seed = check->seed;
+	count = 0;
+
+	for (row = 2; row < check->rows; row++)
+	{
+		for (col = 2; col < check->cols; col++)
+		{
+			seed = seed * 1103515245 + 12345;
+			soup[row][col] = (((seed >> 16) % 100) < 35);
+			count += soup[row][col];
+		}
+	}
+
+	return count;
+}
+
+
+/*
+ * Set generation 1 to the next generation of a soup.
+ */
+static Status
+setTarget(Engine * eng, Bool soup[ROW_MAX + 2][COL_MAX + 2])
+{
+	static	const int	deltas[8][2] =
+	{
+		{-1, -1}, {-1, 0}, {-1, 1}, {0, -1},
+		{0, 1}, {1, -1}, {1, 0}, {1, 1}
+	};
+	State	state;
+	int	count;
+	int	row;
+	int	col;
+	int	i;
+
+	for (row = 1; row <= eng->rowMax; row++)
+	{
+		for (col = 1; col <= eng->colMax; col++)
+		{
+			count = 0;
+
+			for (i = 0; i < 8; i++)
+				count += soup[row + deltas[i][0]][col + deltas[i][1]];
+
+			state = soup[row][col] ?
+				eng->rules->liveRules[count] :
+				eng->rules->bornRules[count];
+
+			if (proceed(eng, findCell(eng, row, col, 1), state,
+				FALSE) != OK)
+			{
+				return NOT_EXIST;
+			}
+		}
+	}
+
+	return OK;
+}
+
+
+/*
+ * Return whether two runs of a check ended alike after the same work.
+ */
+static Bool
+sameWork(const Check * check1, const Check * check2)
+{
+	return ((check1->status == check2->status) &&
+		(check1->cellCount == check2->cellCount) &&
+		(check1->hash == check2->hash) &&
+		!memcmp(&check1->stats, &check2->stats, sizeof(Stats)));
+}
+
+
+static void
+printCheck(const char * how, const Check * check)
+{
+	printf("%-8s %3dx%-3d %-7s %6s %9lu %9lu %11lu %10lu\n", how,
+		check->rows, check->cols,
+		check->dynamic ? "dynamic" : "static",
+		(check->status == FOUND) ? "found" :
+		((check->status == NOT_EXIST) ? "none" : "limit"),
+		check->stats.decisions, check->stats.conflicts,
+		check->stats.setCells, check->stats.consistifies);
+}
+
+
+/*
+ * Report a fatal error and exit.
+ */
+void
+fatal(const char * msg)
+{
+	fprintf(stderr, "enginecheck: %s\n", msg);
+	exit(1);
+}
+
+
+/*
+ * The search loop can dump its state and report its progress, which
+ * none of the checks asks it to do.
+ */
+void
+dumpState(Engine * eng, const char * file)
+{
+}
+
+
+void
+reportProgress(Engine * eng)
+{
+}
+
+/* END CODE */
@@ -4,6 +4,18 @@
  */
 
 #include "lifesrc.h"
+#include "report.h"
+
+#include <stddef.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if HEADLESS_FLAG
+#include <signal.h>
+#include <time.h>
+#endif
 
 #define	VERSION	"3.8+lcsmuller1"
 
@@ -13,56 +25,120 @@
  */
 static	Bool	noWait;		/* don't wait for commands after loading */
 static	Bool	setAll;		/* set all cells from initial file */
+static	Rules	rules;		/* rules shared by the searches */
 static	Bool	isLife;		/* whether the rules are for standard Life */
 static	char	ruleString[20];	/* rule string for printouts */
 static	long	foundCount;	/* number of objects found */
 static	char *	initFile;	/* file containing initial cells */
+static	char *	parentFile;	/* file containing cells of generation 0 */
 static	char *	loadFile;	/* file to load state from */
+static	char *	splitFile;	/* file to write cubes to */
+static	int	splitCells;	/* number of cells in each cube */
+static	char *	cubeFile;	/* file to read a cube from */
+static	long	cubeIndex;	/* line of the cube in that file */
+static	char *	nogoodFile;	/* file to read nogoods from */
+static	Bool	dumpBinary;	/* dumps are binary checkpoints */
+
+#if HEADLESS_FLAG
+static	Engine *	signalEngine;	/* engine stopped by signals */
+#endif
 
 
 /*
  * Local procedures
  */
 static	void		usage(void);
-static	void		getSetting(const char *);
-static	void		getBackup(const char *);
-static	void		getClear(const char *);
-static	void		getExclude(const char *);
-static	void		getFreeze(const char *);
-static	void		excludeCone(int, int, int);
-static	void		freezeCell(int, int);
-static	Status		loadState(const char *);
-static	Status		readFile(const char *);
+static	void		getSetting(Engine *, const char *);
+static	void		getBackup(Engine *, const char *);
+static	void		getClear(Engine *, const char *);
+static	void		getExclude(Engine *, const char *);
+static	void		getFreeze(Engine *, const char *);
+static	void		excludeCone(Engine *, int, int, int);
+static	void		freezeCell(Engine *, int, int);
+static	Status		loadState(Engine *, const char *);
+static	void		dumpCheckpoint(Engine *, const char *);
+static	Status		loadCheckpoint(Engine *, const char *);
+static	void		fileStatus(const char *, const char *);
+static	Status		readFile(Engine *, const char *, int);
+static	void		readSupport(Engine *, const char *);
+static	Status		readCube(Engine *, const char *, long);
+static	Status		readNogoods(Engine *, const char *);
 static	Bool		confirm(const char *);
 static	Bool		setRules(const char *);
 static	long		getNum(const char **, int);
+
+#if HEADLESS_FLAG
+static	unsigned char *	putNum(unsigned char *, unsigned long, int);
+static	void		stopSearch(int);
+#endif
 static	const char *	getStr(const char *, const char *);
 
 
 /*
- * Table of addresses of parameters which are loaded and saved.
+ * Layout of the start of a binary dump file.  It is followed by the
+ * parameters as ints, then the settings as ints holding the index of the
+ * cell shifted left by two, its ON state bit and its free bit, and then
+ * bitmaps of the cells excluded from the search and of the frozen cells
+ * of generation 0.  All of it is in the byte order of the writer.
+ */
+typedef struct
+{
+	char	magic[4];	/* CHECKPOINT_MAGIC */
+	int	version;	/* CHECKPOINT_VERSION */
+	int	byteOrder;	/* CHECKPOINT_ORDER as the writer stores it */
+	int	paramCount;	/* number of parameters */
+	int	setCount;	/* number of settings */
+	int	baseCount;	/* settings made before searching */
+	int	cellCount;	/* number of cells in each generation */
+	char	rule[20];	/* rule string, empty for Life */
+} Checkpoint;
+
+#define	CHECKPOINT_ORDER	0x01020304
+
+#define	checkpointIndex(eng, row, col, gen) \
+	((((gen) * (eng)->rowMax) + (row) - 1) * (eng)->colMax + (col) - 1)
+
+
+/*
+ * Table of offsets of parameters in an engine which are loaded and saved.
  * Changing this table may invalidate old dump files, unless new
  * parameters are added at the end and default to zero.
  * When changed incompatibly, the dump file version should be incremented.
- * The table is ended with a NULL pointer.
  */
-static	int *	paramTable[] =
+static	const size_t	paramTable[] =
 {
-	&curStatus,
-	&rowMax, &colMax, &genMax, &rowTrans, &colTrans,
-	&rowSym, &colSym, &pointSym, &fwdSym, &bwdSym,
-	&flipRows, &flipCols, &flipQuads,
-	&parent, &allObjects, &nearCols, &maxCount,
-	&useRow, &useCol, &colCells, &colWidth, &follow,
-	&orderWide, &orderGens, &orderMiddle, &followGens,
-	NULL
+	offsetof(Engine, curStatus),
+	offsetof(Engine, rowMax), offsetof(Engine, colMax),
+	offsetof(Engine, genMax), offsetof(Engine, rowTrans),
+	offsetof(Engine, colTrans), offsetof(Engine, rowSym),
+	offsetof(Engine, colSym), offsetof(Engine, pointSym),
+	offsetof(Engine, fwdSym), offsetof(Engine, bwdSym),
+	offsetof(Engine, flipRows), offsetof(Engine, flipCols),
+	offsetof(Engine, flipQuads), offsetof(Engine, parent),
+	offsetof(Engine, allObjects), offsetof(Engine, nearCols),
+	offsetof(Engine, maxCount), offsetof(Engine, useRow),
+	offsetof(Engine, useCol), offsetof(Engine, colCells),
+	offsetof(Engine, colWidth), offsetof(Engine, follow),
+	offsetof(Engine, orderWide), offsetof(Engine, orderGens),
+	offsetof(Engine, orderMiddle), offsetof(Engine, followGens),
+	offsetof(Engine, lookCells), offsetof(Engine, orderDynamic),
+	offsetof(Engine, orderSeed), offsetof(Engine, conflictLimit)
 };
 
+#define	paramEnd	(paramTable + sizeof(paramTable) / sizeof(size_t))
+#define	paramValue(eng, param)	(*(int *) ((char *) (eng) + *(param)))
+
 
 int
 main(int argc, char ** argv)
 {
+	Engine *	eng;
 	const char *	str;
+	Status		status;
+#if HEADLESS_FLAG
+	FILE *		fp;
+	long		cubeCount;
+#endif
 
 	if (--argc <= 0)
 	{
@@ -75,11 +151,16 @@ main(int argc, char ** argv)
 	if (!setRules("3/23"))
 		fatal("Cannot set Life rules!");
 
+	eng = newEngine(&rules);
+
+	if (eng == NULL)
+		fatal("Cannot allocate search engine");
+
 	/*
 	 * Set a couple of defaults.
 	 */
-	viewFreq = 10 * VIEW_MULT;
-	colMax = 75;
+	eng->viewFreq = 10 * VIEW_MULT;
+	eng->colMax = 75;
 
 	/*
 	 * Collect the command line options.
@@ -107,21 +188,21 @@ main(int argc, char ** argv)
 				/*
 				 * Set number of rows.
 				 */
-				rowMax = atoi(str);
+				eng->rowMax = atoi(str);
 				break;
 
 			case 'c':
 				/*
 				 * Set number of columns.
 				 */
-				colMax = atoi(str);
+				eng->colMax = atoi(str);
 				break;
 
 			case 'g':
 				/*
 				 * Set number of generations.
 				 */
-				genMax = atoi(str);
+				eng->genMax = atoi(str);
 				break;
 
 			case 't':
@@ -131,11 +212,11 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'r':
-						rowTrans = atoi(str);
+						eng->rowTrans = atoi(str);
 						break;
 
 					case 'c':
-						colTrans = atoi(str);
+						eng->colTrans = atoi(str);
 						break;
 
 					default:
@@ -151,31 +232,31 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'r':
-						flipRows = 1;
+						eng->flipRows = 1;
 
 						if (*str)
-							flipRows = atoi(str);
+							eng->flipRows = atoi(str);
 
 						break;
 
 					case 'c':
-						flipCols = 1;
+						eng->flipCols = 1;
 
 						if (*str)
-							flipCols = atoi(str);
+							eng->flipCols = atoi(str);
 
 						break;
 
 					case 'q':
-						flipQuads = TRUE;
+						eng->flipQuads = TRUE;
 						break;
 
 					case 'g':
-						followGens = TRUE;
+						eng->followGens = TRUE;
 						break;
 
 					case '\0':
-						follow = TRUE;
+						eng->follow = TRUE;
 						break;
 
 					default:
@@ -191,31 +272,31 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'r':
-						rowSym = 1;
+						eng->rowSym = 1;
 
 						if (*str)
-							rowSym = atoi(str);
+							eng->rowSym = atoi(str);
 
 						break;
 
 					case 'c':
-						colSym = 1;
+						eng->colSym = 1;
 
 						if (*str)
-							colSym = atoi(str);
+							eng->colSym = atoi(str);
 
 						break;
 
 					case 'p':
-						pointSym = TRUE;
+						eng->pointSym = TRUE;
 						break;
 
 					case 'f':
-						fwdSym = TRUE;
+						eng->fwdSym = TRUE;
 						break;
 
 					case 'b':
-						bwdSym = TRUE;
+						eng->bwdSym = TRUE;
 						break;
 
 					default:
@@ -231,7 +312,7 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'c':
-						nearCols = atoi(str);
+						eng->nearCols = atoi(str);
 						break;
 
 					default:
@@ -247,7 +328,7 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'c':
-						colWidth = atoi(str);
+						eng->colWidth = atoi(str);
 						break;
 
 					default:
@@ -263,11 +344,11 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'r':
-						useRow = atoi(str);
+						eng->useRow = atoi(str);
 						break;
 
 					case 'c':
-						useCol = atoi(str);
+						eng->useCol = atoi(str);
 						break;
 
 					default:
@@ -278,15 +359,22 @@ main(int argc, char ** argv)
 
 			case 'd':
 				/*
-				 * Get dump frequency.
+				 * Get dump frequency, and whether the dumps
+				 * are binary checkpoints.
 				 */
-				dumpFreq = atol(str) * DUMP_MULT;
-				dumpFile = DUMP_FILE;
+				if (*str == 'b')
+				{
+					dumpBinary = TRUE;
+					str++;
+				}
+
+				eng->dumpFreq = atol(str) * DUMP_MULT;
+				eng->dumpFile = DUMP_FILE;
 
 				if ((argc > 0) && (**argv != '-'))
 				{
 					argc--;
-					dumpFile = *argv++;
+					eng->dumpFile = *argv++;
 				}
 
 				break;
@@ -295,7 +383,7 @@ main(int argc, char ** argv)
 				/*
 				 * Set view frequency.
 				 */
-				viewFreq = atol(str) * VIEW_MULT;
+				eng->viewFreq = atol(str) * VIEW_MULT;
 				break;
 
 			case 'l':
@@ -314,12 +402,23 @@ main(int argc, char ** argv)
 
 			case 'i':
 				/*
-				 * Read initial file.
+				 * Read initial file, or the file of the cells
+				 * of generation 0.
 				 */
+				if (*str == 'p')
+				{
+					if ((argc <= 0) || (**argv == '-'))
+						fatal("Missing generation 0 file name");
+
+					parentFile = *argv++;
+					argc--;
+					break;
+				}
+
 				if (*str == 'd')
 				{
 					setAll = TRUE;
-					setDeep = TRUE;
+					eng->setDeep = TRUE;
 				}
 				else if (*str != 'n')
 					setAll = TRUE;
@@ -340,12 +439,12 @@ main(int argc, char ** argv)
 					/*
 					 * Output file name
 					 */
-					outputCols = atol(str);
+					eng->outputCols = atol(str);
 
 					if ((argc <= 0) || (**argv == '-'))
 						fatal("Missing output file name");
 
-					outputFile = *argv++;
+					eng->outputFile = *argv++;
 					argc--;
 					break;
 				}
@@ -358,15 +457,19 @@ main(int argc, char ** argv)
 					switch (*str++)
 					{
 						case 'w':
-							orderWide = TRUE;
+							eng->orderWide = TRUE;
 							break;
 
 						case 'g':
-							orderGens = TRUE;
+							eng->orderGens = TRUE;
 							break;
 
 						case 'm':
-							orderMiddle = TRUE;
+							eng->orderMiddle = TRUE;
+							break;
+
+						case 'a':
+							eng->orderDynamic = TRUE;
 							break;
 
 						default:
@@ -383,11 +486,11 @@ main(int argc, char ** argv)
 				switch (*str++)
 				{
 					case 'c':
-						colCells = atoi(str);
+						eng->colCells = atoi(str);
 						break;
 
 					case 't':
-						maxCount = atoi(str);
+						eng->maxCount = atoi(str);
 						break;
 
 					default:
@@ -400,14 +503,14 @@ main(int argc, char ** argv)
 				/*
 				 * Find parents only.
 				 */
-				parent = TRUE;
+				eng->parent = TRUE;
 				break;
 
 			case 'a':
 				/*
 				 * Find all objects.
 				 */
-				allObjects = TRUE;
+				eng->allObjects = TRUE;
 				break;
 
 			case 'D':
@@ -426,6 +529,100 @@ main(int argc, char ** argv)
 
 				break;
 
+			case 'L':
+				/*
+				 * Set number of cells to look ahead at.
+				 */
+				eng->lookCells = atoi(str);
+				break;
+
+			case 'K':
+				/*
+				 * Split the search into cubes written to a file.
+				 */
+				splitCells = atoi(str);
+
+				if ((splitCells <= 0) || (splitCells > CUBE_MAX))
+					fatal("Bad number of cube cells");
+
+				if ((argc <= 0) || (**argv == '-'))
+					fatal("Missing cube file name");
+
+				splitFile = *argv++;
+				argc--;
+				break;
+
+			case 'k':
+				/*
+				 * Search only within a cube read from a file,
+				 * or outside of the nogoods read from one.
+				 */
+				if (*str == 'x')
+				{
+					if ((argc <= 0) || (**argv == '-'))
+						fatal("Missing nogood file name");
+
+					nogoodFile = *argv++;
+					argc--;
+					break;
+				}
+
+				cubeIndex = atol(str);
+
+				if (cubeIndex <= 0)
+					fatal("Bad cube number");
+
+				if ((argc <= 0) || (**argv == '-'))
+					fatal("Missing cube file name");
+
+				cubeFile = *argv++;
+				argc--;
+				break;
+
+			case 'S':
+				/*
+				 * Set seed for breaking ties in the search order.
+				 */
+				eng->orderSeed = atoi(str);
+				break;
+
+			case 'C':
+				/*
+				 * Set number of conflicts to stop searching after.
+				 */
+				eng->conflictLimit = atoi(str);
+				break;
+
+			case 'e':
+				/*
+				 * Set seconds between progress estimates.
+				 */
+				eng->progressFreq = atol(str);
+				break;
+
+			case 'M':
+				/*
+				 * Set size of the memo of failed frontiers.
+				 */
+				eng->memoSize = atol(str) * MEMO_MULT;
+
+				if (eng->memoSize < 0)
+					fatal("Bad frontier memo size");
+
+				break;
+
+			case 'z':
+				/*
+				 * Set distance from the last generation which
+				 * generation 0 is searched to.
+				 */
+				eng->sparseDist = atoi(str);
+
+				if (eng->sparseDist <= 0)
+					fatal("Bad sparse distance");
+
+				break;
+
 			default:
 				ttyClose();
 
@@ -436,28 +633,54 @@ main(int argc, char ** argv)
 		}
 	}
 
-	if (parent &&
-		(rowTrans || colTrans || flipQuads || flipRows || flipCols))
+	if (eng->parent &&
+		(eng->rowTrans || eng->colTrans || eng->flipQuads ||
+		eng->flipRows || eng->flipCols))
 	{
 		fatal("Cannot specify translations or flips with -p");
 	}
 
-	if ((pointSym != 0) + (rowSym || colSym) + (fwdSym || bwdSym) > 1)
+	if ((eng->pointSym != 0) + (eng->rowSym || eng->colSym) +
+		(eng->fwdSym || eng->bwdSym) > 1)
 		fatal("Conflicting symmetries specified");
 
-	if ((fwdSym || bwdSym || flipQuads) && (rowMax != colMax))
+	if ((eng->fwdSym || eng->bwdSym || eng->flipQuads) &&
+		(eng->rowMax != eng->colMax))
 		fatal("Rows must equal cols with -sf, -sb, or -fq");
 
-	if ((rowTrans || colTrans) + (flipQuads != 0) > 1)
+	if ((eng->rowTrans || eng->colTrans) + (eng->flipQuads != 0) > 1)
 		fatal("Conflicting translation or flipping specified");
 
-	if ((rowTrans && flipRows) || (colTrans && flipCols))
+	if ((eng->rowTrans && eng->flipRows) ||
+		(eng->colTrans && eng->flipCols))
 		fatal("Conflicting translation or flipping specified");
 
-	if ((useRow < 0) || (useRow > rowMax))
+	if ((eng->useRow < 0) || (eng->useRow > eng->rowMax))
 		fatal("Bad row for -ur");
 
-	if ((useCol < 0) || (useCol > colMax))
+#if !HEADLESS_FLAG
+	if (splitFile)
+		fatal("Splitting into cubes needs a headless build");
+
+	/*
+	 * Backing up by hand would make the memo take frontiers which
+	 * were not searched through for failed ones.
+	 */
+	if (eng->memoSize)
+		fatal("The frontier memo needs a headless build");
+#else
+	/*
+	 * Standard output carries the result frame, so headless builds
+	 * only write binary dumps, which print nothing when they work.
+	 */
+	if (eng->dumpFreq)
+		dumpBinary = TRUE;
+#endif
+
+	if (splitFile && !eng->lookCells)
+		eng->lookCells = CUBE_LOOK;
+
+	if ((eng->useCol < 0) || (eng->useCol > eng->colMax))
 		fatal("Bad column for -uc");
 
 	if (!ttyOpen())
@@ -467,9 +690,18 @@ main(int argc, char ** argv)
 	 * Check for loading state from file or reading initial
 	 * object from file.
 	 */
+	/*
+	 * A sparse search takes the cells of the last generation which
+	 * can be ON from the initial file, before making its own cells.
+	 * Dumps do not hold them, so searches which are dumped or loaded
+	 * are never sparse.
+	 */
+	if (!initFile || loadFile || eng->dumpFreq)
+		eng->sparseDist = 0;
+
 	if (loadFile)
 	{
-		if (loadState(loadFile) != OK)
+		if (loadState(eng, loadFile) != OK)
 		{
 			ttyClose();
 			exit(1);
@@ -477,86 +709,215 @@ main(int argc, char ** argv)
 	}
 	else
 	{
-		initCells();
+		if (eng->sparseDist)
+			readSupport(eng, initFile);
+
+		if (initCells(eng) != OK)
+			fatal(eng->error);
 
 		if (initFile)
 		{
-			if (readFile(initFile) != OK)
+			status = readFile(eng, initFile,
+				eng->parent ? (eng->genMax - 1) : 0);
+
+			if (status == NOT_EXIST)
+			{
+				ttyStatus("Inconsistent state in \"%s\"\n",
+					initFile);
+			}
+
+			if (status != OK)
 			{
 				ttyClose();
 				exit(1);
 			}
 
-			baseSet = nextSet;
+			eng->baseSet = eng->nextSet;
+		}
+
+		/*
+		 * The cells of generation 0 given by a file are never
+		 * backed up.  If they are inconsistent with the initial
+		 * cells then there is nothing to search.
+		 */
+		if (parentFile)
+		{
+			status = readFile(eng, parentFile, 0);
+
+			if (status == ERROR)
+			{
+				ttyClose();
+				exit(1);
+			}
+
+			if (status == NOT_EXIST)
+				eng->curStatus = NOT_EXIST;
+
+			eng->baseSet = eng->nextSet;
+		}
+
+		/*
+		 * The cells of a cube are never backed up.  A cube which
+		 * is inconsistent leaves nothing to search.
+		 */
+		if (cubeFile)
+		{
+			status = readCube(eng, cubeFile, cubeIndex);
+
+			if (status == ERROR)
+			{
+				ttyClose();
+				exit(1);
+			}
+
+			if (status == NOT_EXIST)
+				eng->curStatus = NOT_EXIST;
+
+			eng->baseSet = eng->nextSet;
+		}
+
+		if (nogoodFile && (readNogoods(eng, nogoodFile) != OK))
+		{
+			ttyClose();
+			exit(1);
+		}
+
+		/*
+		 * Settings which leave no cell to choose are the object
+		 * itself, which searching would take for an object found
+		 * before and back up from.
+		 */
+		if ((eng->curStatus == OK) &&
+			((*eng->getUnknown)(eng) == NULL_CELL))
+		{
+			eng->curStatus = FOUND;
 		}
 	}
 
+#if PARENT_FLAG
+	/*
+	 * The parent engine leaves out everything which other searches
+	 * need, so make sure that this is not one of them.  This is done
+	 * after loading, which can change the parameters.
+	 */
+	if (!eng->parent || eng->rowSym || eng->colSym || eng->pointSym ||
+		eng->fwdSym || eng->bwdSym || eng->nearCols ||
+		eng->colWidth || eng->useCol)
+	{
+		fatal("The parent engine needs -p and no -s, -nc, -wc or -uc");
+	}
+#endif
+
 	/*
 	 * If we are looking for parents, then set the current generation
 	 * to the last one so that it can be input easily.  Then get the
 	 * commands to initialize the cells, unless we were told to not wait.
 	 */
-	if (parent)
-		curGen = genMax - 1;
+	if (eng->parent)
+		eng->curGen = eng->genMax - 1;
 
+#if !HEADLESS_FLAG
 	if (noWait && !quiet)
-		printGen(0);
+		printGen(eng, 0);
 	else
-		getCommands();
+		getCommands(eng);
+#endif
+
+	eng->inited = TRUE;
 
-	inited = TRUE;
+#if HEADLESS_FLAG
+	/*
+	 * Let a terminating signal stop the search early, so that the
+	 * work done so far still gets reported.
+	 */
+	signalEngine = eng;
+	signal(SIGTERM, stopSearch);
+	signal(SIGINT, stopSearch);
+	clock_gettime(CLOCK_MONOTONIC, &eng->startTime);
+	eng->reportTime = eng->startTime;
+
+	/*
+	 * When splitting, the cubes are the result and nothing
+	 * is searched.  A split which is not found to be complete
+	 * or impossible is reported with the OK status.
+	 */
+	if (splitFile && (eng->curStatus == OK))
+	{
+		fp = fopen(splitFile, "w");
+
+		if (fp == NULL)
+			fatal("Cannot create cube file");
+
+		eng->curStatus = splitSearch(eng, splitCells, fp, &cubeCount);
+
+		if (fclose(fp))
+			fatal("Error writing cube file");
+
+		reportResult(eng);
+		exit(0);
+	}
+#endif
 
 	/*
 	 * Initial commands are complete, now look for the object.
 	 */
 	while (TRUE)
 	{
-		if (curStatus == OK)
-			curStatus = search();
+		if (eng->curStatus == OK)
+			eng->curStatus = search(eng);
 
-		if ((curStatus == FOUND) && useRow &&
-			(rowInfo[useRow].onCount == 0))
+		if ((eng->curStatus == FOUND) && eng->useRow &&
+			(eng->rowInfo[eng->useRow].onCount == 0))
 		{
-			curStatus = OK;
+			eng->curStatus = OK;
 			continue;
 		}
 
-		if ((curStatus == FOUND) && !allObjects && subPeriods())
+		if ((eng->curStatus == FOUND) && !eng->allObjects &&
+			subPeriods(eng))
 		{
-			curStatus = OK;
+			eng->curStatus = OK;
 			continue;
 		}
 
-		if (dumpFreq)
+#if HEADLESS_FLAG
+		/*
+		 * There is no terminal to take further commands from,
+		 * so report how the search ended and stop.
+		 */
+		reportResult(eng);
+		exit(0);
+#else
+		if (eng->dumpFreq)
 		{
-			dumpcount = 0;
-			dumpState(dumpFile);
+			eng->dumpcount = 0;
+			dumpState(eng, eng->dumpFile);
 		}
 
-		quitOk = (curStatus == NOT_EXIST);
+		eng->quitOk = (eng->curStatus == NOT_EXIST);
 
-		curGen = 0;
+		eng->curGen = 0;
 
-		if (outputFile == NULL)
+		if (eng->outputFile == NULL)
 		{
-			getCommands();
+			getCommands(eng);
 			continue;
 		}
 
 		/*
 		 * Here if results are going to a file.
 		 */
-		if (curStatus == FOUND)
+		if (eng->curStatus == FOUND)
 		{
-			curStatus = OK;
+			eng->curStatus = OK;
 
 			if (!quiet)
 			{
-				printGen(0);
+				printGen(eng, 0);
 				ttyStatus("Object %ld found.\n", ++foundCount);
 			}
 
-			writeGen(outputFile, TRUE);
+			writeGen(eng, eng->outputFile, TRUE);
 			continue;
 		}
 
@@ -567,9 +928,11 @@ main(int argc, char ** argv)
 
 		if (!quiet)
 			printf("Search completed, file \"%s\" contains %ld object%s\n",
-				outputFile, foundCount, (foundCount == 1) ? "" : "s");
+				eng->outputFile, foundCount,
+				(foundCount == 1) ? "" : "s");
 
 		exit(0);
+#endif
 	}
 }
 
@@ -579,15 +942,15 @@ main(int argc, char ** argv)
  * Commands are ended by a blank line.
  */
 void
-getCommands(void)
+getCommands(Engine * eng)
 {
 	const char *	cp;
 	const char *	cmd;
 	char		buf[LINE_SIZE];
 
-	dumpcount = 0;
-	viewCount = 0;
-	printGen(curGen);
+	eng->dumpcount = 0;
+	eng->viewCount = 0;
+	printGen(eng, eng->curGen);
 
 	while (TRUE)
 	{
@@ -616,65 +979,66 @@ getCommands(void)
 				/*
 				 * Print previous generation.
 			 	 */
-				printGen((curGen + genMax - 1) % genMax);
+				printGen(eng, (eng->curGen + eng->genMax - 1) %
+					eng->genMax);
 				break;
 
 			case 'n':
 				/*
 				 * Print next generation.
 				 */
-				printGen((curGen + 1) % genMax);
+				printGen(eng, (eng->curGen + 1) % eng->genMax);
 				break;
 
 			case 's':
 				/*
 				 * Add a cell setting.
 				 */
-				getSetting(cp);
+				getSetting(eng, cp);
 				break;
 
 			case 'b':
 				/*
 				 * Back up the search.
 				 */
-				getBackup(cp);
+				getBackup(eng, cp);
 				break;
 
 			case 'c':
 				/*
 				 * Clear an area.
 				 */
-				getClear(cp);
+				getClear(eng, cp);
 				break;
 
 			case 'v':
 				/*
 				 * Set viewing frequency.
 				 */
-				viewFreq = atol(cp) * VIEW_MULT;
-				printGen(curGen);
+				eng->viewFreq = atol(cp) * VIEW_MULT;
+				printGen(eng, eng->curGen);
 				break;
 
 			case 'w':
 				/*
 				 * Write generation to a file.
 				 */
-				writeGen(cp, FALSE);
+				writeGen(eng, cp, FALSE);
 				break;
 
 			case 'd':
 				/*
 				 * Dump state to a file.
 				 */
-				dumpState(cp);
+				dumpState(eng, cp);
 				break;
 
 			case 'N':
 				/*
 				 * Find next object.
 				 */
-				if (curStatus == FOUND)
-					curStatus = OK;
+				if (eng->curStatus == FOUND)
+					eng->curStatus = OK;
 
 				return;
 
@@ -683,7 +1047,7 @@ getCommands(void)
 				/*
 				 * Quit program.
 				 */
-				if (quitOk || confirm("Really quit? "))
+				if (eng->quitOk || confirm("Really quit? "))
 				{
 					ttyClose();
 					exit(0);
@@ -695,14 +1059,14 @@ getCommands(void)
 				/*
 				 * Exclude cells from the search.
 				 */
-				getExclude(cp);
+				getExclude(eng, cp);
 				break;
 
 			case 'f':
 				/*
 				 * Free state of cells.
 				 */
-				getFreeze(cp);
+				getFreeze(eng, cp);
 				break;
 	
 			case '\n':
@@ -718,7 +1082,7 @@ getCommands(void)
 				 */
 				if (isDigit(*cmd))
 				{
-					getSetting(cmd);
+					getSetting(eng, cmd);
 					break;
 				}
 
@@ -736,7 +1100,7 @@ getCommands(void)
  * the setting, so that the setting is permanent.
  */
 static void
-getSetting(const char * cp)
+getSetting(Engine * eng, const char * cp)
 {
 	int	row;
 	int	col;
@@ -769,23 +1133,24 @@ getSetting(const char * cp)
 		return;
 	}
 
-	if ((row <= 0) || (row > rowMax) || (col <= 0) || (col > colMax) ||
-		((state != 0) && (state != 1)))
+	if ((row <= 0) || (row > eng->rowMax) || (col <= 0) ||
+		(col > eng->colMax) || ((state != 0) && (state != 1)))
 	{
 		ttyStatus("Illegal cell value\n");
 
 		return;
 	}
 
-	if (proceed(findCell(row, col, curGen), state, FALSE) != OK)
+	if (proceed(eng, findCell(eng, row, col, eng->curGen), state,
+		FALSE) != OK)
 	{
 		ttyStatus("Inconsistent state for cell\n");
 
 		return;
 	}
 
-	baseSet = nextSet;
-	printGen(curGen);
+	eng->baseSet = eng->nextSet;
+	printGen(eng, eng->curGen);
 }
 
 
@@ -796,7 +1161,7 @@ getSetting(const char * cp)
  * is obvious that the current search state is useless.
  */
 static void
-getBackup(const char * cp)
+getBackup(Engine * eng, const char * cp)
 {
 	Cell *	cell;
 	State	state;
@@ -827,11 +1192,11 @@ getBackup(const char * cp)
 
 	while (count > 0)
 	{
-		cell = backup();
+		cell = backup(eng);
 
 		if (cell == NULL_CELL)
 		{
-			printGen(curGen);
+			printGen(eng, eng->curGen);
 			ttyStatus("Backed up over all possibilities\n");
 
 			return;
@@ -844,16 +1209,16 @@ getBackup(const char * cp)
 
 		cell->state = UNK;
 
-		if (go(cell, state, FALSE) != OK)
+		if (go(eng, cell, state, FALSE) != OK)
 		{
-			printGen(curGen);
+			printGen(eng, eng->curGen);
 			ttyStatus("Backed up over all possibilities\n");
 
 			return;
 		}
 	}
 
-	printGen(curGen);
+	printGen(eng, eng->curGen);
 }
 
 
@@ -863,7 +1228,7 @@ getBackup(const char * cp)
  * clearing the whole area, then confirmation is required.
  */
 static void
-getClear(const char * cp)
+getClear(Engine * eng, const char * cp)
 {
 	int	beggen;
 	int	begRow;
@@ -880,14 +1245,14 @@ getClear(const char * cp)
 	 * Assume we are doing just this generation, but if the 'cg'
 	 * command was given, then clear in all generations.
 	 */
-	beggen = curGen;
-	endGen = curGen;
+	beggen = eng->curGen;
+	endGen = eng->curGen;
 
 	if (*cp == 'g')
 	{
 		cp++;
 		beggen = 0;
-		endGen = genMax - 1;
+		endGen = eng->genMax - 1;
 	}
 
 	while (isBlank(*cp))
@@ -910,12 +1275,12 @@ getClear(const char * cp)
 
 		begRow = 1;
 		begCol = 1;
-		endRow = rowMax;
-		endCol = colMax;
+		endRow = eng->rowMax;
+		endCol = eng->colMax;
 	}
 
-	if ((begRow < 1) || (begRow > endRow) || (endRow > rowMax) ||
-		(begCol < 1) || (begCol > endCol) || (endCol > colMax))
+	if ((begRow < 1) || (begRow > endRow) || (endRow > eng->rowMax) ||
+		(begCol < 1) || (begCol > endCol) || (endCol > eng->colMax))
 	{
 		ttyStatus("Illegal clear coordinates");
 
@@ -928,12 +1293,12 @@ getClear(const char * cp)
 		{
 			for (gen = beggen; gen <= endGen; gen++)
 			{
-				cell = findCell(row, col, gen);
+				cell = findCell(eng, row, col, gen);
 
 				if (cell->state != UNK)
 					continue;
 
-				if (proceed(cell, OFF, FALSE) != OK)
+				if (proceed(eng, cell, OFF, FALSE) != OK)
 				{
 					ttyStatus("Inconsistent state for cell\n");
 
@@ -943,8 +1308,8 @@ getClear(const char * cp)
 		}
 	}
 
-	baseSet = nextSet;
-	printGen(curGen);
+	eng->baseSet = eng->nextSet;
+	printGen(eng, eng->curGen);
 }
 
 
@@ -953,7 +1318,7 @@ getClear(const char * cp)
  * This simply means that such cells will not be selected for setting.
  */
 static void
-getExclude(const char * cp)
+getExclude(Engine * eng, const char * cp)
 {
 	int	begRow;
 	int	begCol;
@@ -986,8 +1351,8 @@ getExclude(const char * cp)
 		endCol = getNum(&cp, -1);
 	}
 
-	if ((begRow < 1) || (begRow > endRow) || (endRow > rowMax) ||
-		(begCol < 1) || (begCol > endCol) || (endCol > colMax))
+	if ((begRow < 1) || (begRow > endRow) || (endRow > eng->rowMax) ||
+		(begCol < 1) || (begCol > endCol) || (endCol > eng->colMax))
 	{
 		ttyStatus("Illegal exclusion coordinates");
 
@@ -997,10 +1362,10 @@ getExclude(const char * cp)
 	for (row = begRow; row <= endRow; row++)
 	{
 		for (col = begCol; col <= endCol; col++)
-			excludeCone(row, col, curGen);
+			excludeCone(eng, row, col, eng->curGen);
 	}
 
-	printGen(curGen);
+	printGen(eng, eng->curGen);
 }
 
 
@@ -1009,14 +1374,14 @@ getExclude(const char * cp)
  * specified cell from searching.
  */
 static void
-excludeCone(int row, int col, int gen)
+excludeCone(Engine * eng, int row, int col, int gen)
 {
 	int	tGen;
 	int	tRow;
 	int	tCol;
 	int	dist;
 
-	for (tGen = genMax; tGen >= gen; tGen--)
+	for (tGen = eng->genMax; tGen >= gen; tGen--)
 	{
 		dist = tGen - gen;
 
@@ -1024,7 +1389,8 @@ excludeCone(int row, int col, int gen)
 		{
 			for (tCol = col - dist; tCol <= col + dist; tCol++)
 			{
-				findCell(tRow, tCol, tGen)->choose = FALSE;
+				findCell(eng, tRow, tCol, tGen)->choose =
+					FALSE;
 			}
 		}
 	}
@@ -1036,7 +1402,7 @@ excludeCone(int row, int col, int gen)
  * generations are the same.
  */
 static void
-getFreeze(const char * cp)
+getFreeze(Engine * eng, const char * cp)
 {
 	int	begRow;
 	int	begCol;
@@ -1069,8 +1435,8 @@ getFreeze(const char * cp)
 		endCol = getNum(&cp, -1);
 	}
 
-	if ((begRow < 1) || (begRow > endRow) || (endRow > rowMax) ||
-		(begCol < 1) || (begCol > endCol) || (endCol > colMax))
+	if ((begRow < 1) || (begRow > endRow) || (endRow > eng->rowMax) ||
+		(begCol < 1) || (begCol > endCol) || (endCol > eng->colMax))
 	{
 		ttyStatus("Illegal freeze coordinates");
 
@@ -1080,10 +1446,10 @@ getFreeze(const char * cp)
 	for (row = begRow; row <= endRow; row++)
 	{
 		for (col = begCol; col <= endCol; col++)
-			freezeCell(row, col);
+			freezeCell(eng, row, col);
 	}
 
-	printGen(curGen);
+	printGen(eng, eng->curGen);
 }
 
 
@@ -1095,22 +1461,32 @@ getFreeze(const char * cp)
  * to have the same state.
  */
 void
-freezeCell(int row, int col)
+freezeCell(Engine * eng, int row, int col)
 {
 	int	gen;
 	Cell *	cell0;
 	Cell *	cell;
 
-	cell0 = findCell(row, col, 0);
+#if PARENT_FLAG
+	/*
+	 * The parent engine does not follow loops.
+	 */
+	fatal("The parent engine cannot freeze cells");
+#endif
+
+	cell0 = findCell(eng, row, col, 0);
 
-	for (gen = 0; gen < genMax; gen++)
+	for (gen = 0; gen < eng->genMax; gen++)
 	{
-		cell = findCell(row, col, gen);
+		cell = findCell(eng, row, col, gen);
 
 		cell->frozen = TRUE;
 
-		loopCells(cell0, cell);
+		loopCells(eng, cell0, cell);
 	}
+
+	if (eng->error)
+		fatal(eng->error);
 }
 
 
@@ -1119,7 +1495,7 @@ freezeCell(int row, int col)
  * This also sets the current generation.
  */
 void
-printGen(int gen)
+printGen(Engine * eng, int gen)
 {
 	int		row;
 	int		col;
@@ -1127,22 +1503,26 @@ printGen(int gen)
 	const Cell *	cell;
 	const char *	msg;
 
-	curGen = gen;
+	eng->curGen = gen;
 
-	switch (curStatus)
+	switch (eng->curStatus)
 	{
-		case NOT_EXIST:	msg = "No such object"; break;
+		case NOT_EXIST:
+			msg = eng->sparse ?
+				"No such object near the last generation" :
+				"No such object";
+			break;
 		case FOUND:	msg = "Found object"; break;
 		default:	msg = ""; break;
 	}
 
 	count = 0;
 
-	for (row = 1; row <= rowMax; row++)
+	for (row = 1; row <= eng->rowMax; row++)
 	{
-		for (col = 1; col <= colMax; col++)
+		for (col = 1; col <= eng->colMax; col++)
 		{
-			count += (findCell(row, col, gen)->state == ON);
+			count += (findCell(eng, row, col, gen)->state == ON);
 		}
 	}
 
@@ -1159,106 +1539,108 @@ printGen(int gen)
 			msg, ruleString, gen, count);
 	}
 
-	ttyPrintf(" -r%d -c%d -g%d", rowMax, colMax, genMax);
+	ttyPrintf(" -r%d -c%d -g%d", eng->rowMax, eng->colMax, eng->genMax);
 
-	if (rowTrans)
-		ttyPrintf(" -tr%d", rowTrans);
+	if (eng->rowTrans)
+		ttyPrintf(" -tr%d", eng->rowTrans);
 
-	if (colTrans)
-		ttyPrintf(" -tc%d", colTrans);
+	if (eng->colTrans)
+		ttyPrintf(" -tc%d", eng->colTrans);
 
-	if (flipRows == 1)
+	if (eng->flipRows == 1)
 		ttyPrintf(" -fr");
 
-	if (flipRows > 1)
-		ttyPrintf(" -fr%d", flipRows);
+	if (eng->flipRows > 1)
+		ttyPrintf(" -fr%d", eng->flipRows);
 
-	if (flipCols == 1)
+	if (eng->flipCols == 1)
 		ttyPrintf(" -fc");
 
-	if (flipCols > 1)
-		ttyPrintf(" -fc%d", flipCols);
+	if (eng->flipCols > 1)
+		ttyPrintf(" -fc%d", eng->flipCols);
 
-	if (flipQuads)
+	if (eng->flipQuads)
 		ttyPrintf(" -fq");
 
-	if (rowSym == 1)
+	if (eng->rowSym == 1)
 		ttyPrintf(" -sr");
 
-	if (rowSym > 1)
-		ttyPrintf(" -sr%d", rowSym);
+	if (eng->rowSym > 1)
+		ttyPrintf(" -sr%d", eng->rowSym);
 
-	if (colSym == 1)
+	if (eng->colSym == 1)
 		ttyPrintf(" -sc");
 
-	if (colSym > 1)
-		ttyPrintf(" -sc%d", colSym);
+	if (eng->colSym > 1)
+		ttyPrintf(" -sc%d", eng->colSym);
 
-	if (pointSym)
+	if (eng->pointSym)
 		ttyPrintf(" -sp");
 
-	if (fwdSym)
+	if (eng->fwdSym)
 		ttyPrintf(" -sf");
 
-	if (bwdSym)
+	if (eng->bwdSym)
 		ttyPrintf(" -sb");
 
-	if (orderGens || orderWide || orderMiddle)
+	if (eng->orderGens || eng->orderWide || eng->orderMiddle)
 	{
 		ttyPrintf(" -o");
 
-		if (orderGens)
+		if (eng->orderGens)
 			ttyPrintf("g");
 
-		if (orderWide)
+		if (eng->orderWide)
 			ttyPrintf("w");
 
-		if (orderMiddle)
+		if (eng->orderMiddle)
 			ttyPrintf("m");
 	}
 
-	if (follow)
+	if (eng->follow)
 		ttyPrintf(" -f");
 
-	if (followGens)
+	if (eng->followGens)
 		ttyPrintf(" -fg");
 
-	if (parent)
+	if (eng->parent)
 		ttyPrintf(" -p");
 
-	if (allObjects)
+	if (eng->allObjects)
 		ttyPrintf(" -a");
 
-	if (useRow)
-		ttyPrintf(" -ur%d", useRow);
+	if (eng->useRow)
+		ttyPrintf(" -ur%d", eng->useRow);
 
-	if (useCol)
-		ttyPrintf(" -uc%d", useCol);
+	if (eng->useCol)
+		ttyPrintf(" -uc%d", eng->useCol);
 
-	if (nearCols)
-		ttyPrintf(" -nc%d", nearCols);
+	if (eng->nearCols)
+		ttyPrintf(" -nc%d", eng->nearCols);
 
-	if (maxCount)
-		ttyPrintf(" -mt%d", maxCount);
+	if (eng->maxCount)
+		ttyPrintf(" -mt%d", eng->maxCount);
 
-	if (colCells)
-		ttyPrintf(" -mc%d", colCells);
+	if (eng->colCells)
+		ttyPrintf(" -mc%d", eng->colCells);
 
-	if (colWidth)
-		ttyPrintf(" -wc%d", colWidth);
+	if (eng->colWidth)
+		ttyPrintf(" -wc%d", eng->colWidth);
 
-	if (viewFreq)
-		ttyPrintf(" -v%ld", viewFreq / VIEW_MULT);
+	if (eng->viewFreq)
+		ttyPrintf(" -v%ld", eng->viewFreq / VIEW_MULT);
 
-	if (dumpFreq)
-		ttyPrintf(" -d%ld %s", dumpFreq / DUMP_MULT, dumpFile);
+	if (eng->dumpFreq)
+		ttyPrintf(" -d%ld %s", eng->dumpFreq / DUMP_MULT,
+			eng->dumpFile);
 
-	if (outputFile)
+	if (eng->outputFile)
 	{
-		if (outputCols)
-			ttyPrintf(" -o%d %s", outputCols, outputFile);
+		if (eng->outputCols)
+			ttyPrintf(" -o%d %s", eng->outputCols,
+				eng->outputFile);
 		else
-			ttyPrintf(" -o %s", outputFile);
+			ttyPrintf(" -o %s", eng->outputFile);
 
 		if (foundCount)
 			ttyPrintf(" [%d]", foundCount);
@@ -1266,11 +1648,11 @@ printGen(int gen)
 
 	ttyPrintf("\n");
 
-	for (row = 1; row <= rowMax; row++)
+	for (row = 1; row <= eng->rowMax; row++)
 	{
-		for (col = 1; col <= colMax; col++)
+		for (col = 1; col <= eng->colMax; col++)
 		{
-			cell = findCell(row, col, gen);
+			cell = findCell(eng, row, col, gen);
 
 			switch (cell->state)
 			{
@@ -1298,7 +1680,7 @@ printGen(int gen)
 			 * If wide output, print only one character,
 			 * else print both characters.
 			 */
-			ttyWrite(msg, (colMax < 40) + 1);
+			ttyWrite(msg, (eng->colMax < 40) + 1);
 		}
 
 		ttyWrite("\n", 1);
@@ -1316,7 +1698,7 @@ printGen(int gen)
  * Filename of "." means write to stdout.
  */
 void
-writeGen(const char * file, Bool append)
+writeGen(Engine * eng, const char * file, Bool append)
 {
 	FILE *		fp;
 	const Cell *	cell;
@@ -1348,16 +1730,16 @@ writeGen(const char * file, Bool append)
 	/*
 	 * First find the minimum bounds on the object.
 	 */
-	minRow = rowMax;
-	minCol = colMax;
+	minRow = eng->rowMax;
+	minCol = eng->colMax;
 	maxRow = 1;
 	maxCol = 1;
 
-	for (row = 1; row <= rowMax; row++)
+	for (row = 1; row <= eng->rowMax; row++)
 	{
-		for (col = 1; col <= colMax; col++)
+		for (col = 1; col <= eng->colMax; col++)
 		{
-			cell = findCell(row, col, curGen);
+			cell = findCell(eng, row, col, eng->curGen);
 
 			if (cell->state == OFF)
 				continue;
@@ -1394,7 +1776,7 @@ writeGen(const char * file, Bool append)
 	{
 		for (col = minCol; col <= maxCol; col++)
 		{
-			cell = findCell(row, col, curGen);
+			cell = findCell(eng, row, col, eng->curGen);
 
 			switch (cell->state)
 			{
@@ -1429,16 +1811,143 @@ writeGen(const char * file, Bool append)
 	if (fp != stdout)
 		ttyStatus("\"%s\" written\n", file);
 
-	quitOk = TRUE;
+	eng->quitOk = TRUE;
 }
 
 
+#if HEADLESS_FLAG
+/*
+ * Report the result of the search on stdout as a REPORT_RESULT frame.
+ * This is the only output made by headless builds.  See report.h for
+ * the layout of the frame.
+ */
+void
+reportResult(Engine * eng)
+{
+	unsigned char	buf[REPORT_HEADER + REPORT_RESULT_SIZE +
+				2 * REPORT_PLANE_SIZE(ROW_MAX, COL_MAX)];
+	unsigned char *	cp;
+	unsigned char *	onPlane;
+	unsigned char *	unkPlane;
+	const Cell *	cell;
+	struct timespec	endTime;
+	int		planeSize;
+	int		bit;
+	int		row;
+	int		col;
+	Bool		found;
+	Bool		hasUnk;
+
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+	eng->stats.nanoSeconds =
+		(endTime.tv_sec - eng->startTime.tv_sec) * 1000000000L
+		+ (endTime.tv_nsec - eng->startTime.tv_nsec);
+
+	found = (eng->curStatus == FOUND) && !eng->interrupted;
+	planeSize = found ? REPORT_PLANE_SIZE(eng->rowMax, eng->colMax) : 0;
+	hasUnk = FALSE;
+
+	onPlane = buf + REPORT_HEADER + REPORT_RESULT_SIZE;
+	unkPlane = onPlane + planeSize;
+	memset(onPlane, 0, planeSize * 2);
+
+	bit = 0;
+
+	for (row = 1; found && (row <= eng->rowMax); row++)
+	{
+		for (col = 1; col <= eng->colMax; col++, bit++)
+		{
+			cell = findCell(eng, row, col, 0);
+
+			if (cell->state == ON)
+				onPlane[bit / 8] |= 0x80 >> (bit % 8);
+
+			if (cell->state == UNK)
+			{
+				unkPlane[bit / 8] |= 0x80 >> (bit % 8);
+				hasUnk = TRUE;
+			}
+		}
+	}
+
+	if (hasUnk)
+		planeSize *= 2;
+
+	cp = buf;
+	*cp++ = REPORT_MAGIC0;
+	*cp++ = REPORT_MAGIC1;
+	*cp++ = REPORT_RESULT;
+	*cp++ = REPORT_VERSION;
+	cp = putNum(cp, REPORT_RESULT_SIZE + planeSize, 4);
+	/*
+	 * A sparse search only tells that no object has generation 0 near
+	 * the last generation, so it ends like a stopped one then.
+	 */
+	*cp++ = found ? REPORT_FOUND :
+		(eng->interrupted ? REPORT_STOPPED :
+		((eng->curStatus == OK) ? REPORT_SPLIT :
+		(eng->sparse ? REPORT_STOPPED : REPORT_NOT_EXIST)));
+	*cp++ = hasUnk ? REPORT_HAS_UNK : 0;
+	cp = putNum(cp, eng->cellCount, 4);
+	cp = putNum(cp, eng->stats.decisions, 8);
+	cp = putNum(cp, eng->stats.backtracks, 8);
+	cp = putNum(cp, eng->stats.setCells, 8);
+	cp = putNum(cp, eng->stats.consistifies, 8);
+	cp = putNum(cp, eng->stats.conflicts, 8);
+	cp = putNum(cp, eng->stats.maxDepth, 4);
+	cp = putNum(cp, eng->stats.nanoSeconds, 8);
+	cp = putNum(cp, eng->rowMax, 2);
+	cp = putNum(cp, eng->colMax, 2);
+
+	fwrite(buf, 1, (cp - buf) + planeSize, stdout);
+	fflush(stdout);
+}
+
+
+/*
+ * Report an estimate of the progress of the search on stdout as a
+ * REPORT_PROGRESS frame, if progressFreq seconds went by since the
+ * search started or the last one was reported.  See report.h for the
+ * layout of the frame.
+ */
+void
+reportProgress(Engine * eng)
+{
+	unsigned char	buf[REPORT_HEADER + REPORT_PROGRESS_SIZE];
+	unsigned char *	cp;
+	struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	if (now.tv_sec - eng->reportTime.tv_sec < eng->progressFreq)
+		return;
+
+	eng->reportTime = now;
+
+	cp = buf;
+	*cp++ = REPORT_MAGIC0;
+	*cp++ = REPORT_MAGIC1;
+	*cp++ = REPORT_PROGRESS;
+	*cp++ = REPORT_VERSION;
+	cp = putNum(cp, REPORT_PROGRESS_SIZE, 4);
+	cp = putNum(cp, (unsigned long) (searchProgress(eng) *
+		REPORT_PROGRESS_ONE), 4);
+	cp = putNum(cp, eng->stats.decisions, 8);
+	cp = putNum(cp, (now.tv_sec - eng->startTime.tv_sec) * 1000000000L
+		+ (now.tv_nsec - eng->startTime.tv_nsec), 8);
+
+	fwrite(buf, 1, cp - buf, stdout);
+	fflush(stdout);
+}
+#endif
+
+
 /*
  * Dump the current state of the search in the specified file.
  * If no file is specified, it is asked for.
  */
 void
-dumpState(const char * file)
+dumpState(Engine * eng, const char * file)
 {
 	FILE *		fp;
 	Cell **		set;
@@ -1446,13 +1955,27 @@ dumpState(const char * file)
 	int		row;
 	int		col;
 	int		gen;
-	int **		param;
+	const size_t *	param;
 
 	file = getStr(file, "Dump state to file: ");
 
 	if (*file == '\0')
 		return;
 
+	if (eng->sparse)
+	{
+		ttyStatus("Cannot dump a sparse search\n");
+
+		return;
+	}
+
+	if (dumpBinary)
+	{
+		dumpCheckpoint(eng, file);
+
+		return;
+	}
+
 	fp = fopen(file, "w");
 
 	if (fp == NULL)
@@ -1478,17 +2001,17 @@ dumpState(const char * file)
 	 */
 	fprintf(fp, "P");
 
-	for (param = paramTable; *param; param++)
-		fprintf(fp, " %d", **param);
+	for (param = paramTable; param < paramEnd; param++)
+		fprintf(fp, " %d", paramValue(eng, param));
 
 	fprintf(fp, "\n");
 
 	/*
 	 * Dump out those cells which have a setting.
 	 */
-	set = setTable;
+	set = eng->setTable;
 
-	while (set != nextSet)
+	while (set != eng->nextSet)
 	{
 		cell = *set++;
 
@@ -1499,11 +2022,11 @@ dumpState(const char * file)
 	/*
 	 * Dump out those cells which are being excluded from the search.
 	 */
-	for (row = 1; row <= rowMax; row++)
-		for (col = 1; col < colMax; col++)
-			for (gen = 0; gen < genMax; gen++)
+	for (row = 1; row <= eng->rowMax; row++)
+		for (col = 1; col < eng->colMax; col++)
+			for (gen = 0; gen < eng->genMax; gen++)
 	{
-		cell = findCell(row, col, gen);
+		cell = findCell(eng, row, col, gen);
 
 		if (cell->choose)
 			continue;
@@ -1516,10 +2039,10 @@ dumpState(const char * file)
 	 * It isn't necessary to remember frozen cells in other
 	 * generations since they will be copied from generation 0.
 	 */
-	for (row = 1; row <= rowMax; row++)
-		for (col = 1; col < colMax; col++)
+	for (row = 1; row <= eng->rowMax; row++)
+		for (col = 1; col < eng->colMax; col++)
 	{
-		cell = findCell(row, col, 0);
+		cell = findCell(eng, row, col, 0);
 
 		if (cell->frozen)
 			fprintf(fp, "F %d %d\n", row, col);
@@ -1528,8 +2051,8 @@ dumpState(const char * file)
 	/*
 	 * Finish up with the setting offsets and the final line.
 	 */
-	fprintf(fp, "T %ld %ld\n", (long)(baseSet - setTable),
-                               (long)(nextSet - setTable));
+	fprintf(fp, "T %ld %ld\n", (long)(eng->baseSet - eng->setTable),
+                               (long)(eng->nextSet - eng->setTable));
 	fprintf(fp, "E\n");
 
 	if (fclose(fp))
@@ -1540,7 +2063,7 @@ dumpState(const char * file)
 	}
 
 	ttyStatus("State dumped to \"%s\"\n", file);
-	quitOk = TRUE;
+	eng->quitOk = TRUE;
 }
 
 
@@ -1550,7 +2073,7 @@ dumpState(const char * file)
  * Returns OK on success, ERROR on failure.
  */
 static Status
-loadState(const char * file)
+loadState(Engine * eng, const char * file)
 {
 	FILE *		fp;
 	const char *	cp;
@@ -1561,7 +2084,7 @@ loadState(const char * file)
 	State		state;
 	Bool		free;
 	Cell *		cell;
-	int **		param;
+	const size_t *	param;
 	char		buf[LINE_SIZE];
 
 	file = getStr(file, "Load state from file: ");
@@ -1578,6 +2101,18 @@ loadState(const char * file)
 		return ERROR;
 	}
 
+	/*
+	 * Binary dumps are loaded on their own.
+	 */
+	if ((fread(buf, 1, 4, fp) == 4) &&
+		(memcmp(buf, CHECKPOINT_MAGIC, 4) == 0))
+	{
+		fclose(fp);
+
+		return loadCheckpoint(eng, file);
+	}
+
+	rewind(fp);
 	buf[0] = '\0';
 	fgets(buf, LINE_SIZE, fp);
 
@@ -1642,18 +2177,19 @@ loadState(const char * file)
 
 	cp = &buf[1];
 
-	for (param = paramTable; *param; param++)
-		**param = getNum(&cp, 0);
+	for (param = paramTable; param < paramEnd; param++)
+		paramValue(eng, param) = getNum(&cp, 0);
 
 	/*
 	 * Initialize the cells.
 	 */
-	initCells();
+	if (initCells(eng) != OK)
+		fatal(eng->error);
 
 	/*
 	 * Handle cells which have been set.
 	 */
-	newSet = setTable;
+	eng->newSet = eng->setTable;
 
 	for (;;)
 	{
@@ -1670,9 +2206,9 @@ loadState(const char * file)
 		state = getNum(&cp, 0);
 		free = getNum(&cp, 0);
 
-		cell = findCell(row, col, gen);
+		cell = findCell(eng, row, col, gen);
 
-		if (setCell(cell, state, free) != OK)
+		if (setCell(eng, cell, state, free) != OK)
 		{
 			ttyStatus(
 				"Inconsistently setting cell at r%d c%d g%d \n",
@@ -1694,7 +2230,7 @@ loadState(const char * file)
 		col = getNum(&cp, 0);
 		gen = getNum(&cp, 0);
 
-		findCell(row, col, gen)->choose = FALSE;
+		findCell(eng, row, col, gen)->choose = FALSE;
 
 		buf[0] = '\0';
 		fgets(buf, LINE_SIZE, fp);
@@ -1709,7 +2245,7 @@ loadState(const char * file)
 		row = getNum(&cp, 0);
 		col = getNum(&cp, 0);
 
-		freezeCell(row, col);
+		freezeCell(eng, row, col);
 
 		buf[0] = '\0';
 		fgets(buf, LINE_SIZE, fp);
@@ -1724,8 +2260,8 @@ loadState(const char * file)
 	}
 
 	cp = &buf[1];
-	baseSet = &setTable[getNum(&cp, 0)];
-	nextSet = &setTable[getNum(&cp, 0)];
+	eng->baseSet = &eng->setTable[getNum(&cp, 0)];
+	eng->nextSet = &eng->setTable[getNum(&cp, 0)];
 
 	fgets(buf, LINE_SIZE, fp);
 
@@ -1744,28 +2280,349 @@ loadState(const char * file)
 		return ERROR;
 	}
 
+#if !HEADLESS_FLAG
 	ttyStatus("State loaded from \"%s\"\n", file);
-	quitOk = TRUE;
+#endif
+	eng->quitOk = TRUE;
 
 	return OK;
 }
 
 
 /*
- * Read a file containing initial settings for either gen 0 or the last gen.
+ * Show a status message about a file.  Headless builds keep standard
+ * output for their result frame, so they show it on standard error.
+ */
+static void
+fileStatus(const char * fmt, const char * file)
+{
+#if HEADLESS_FLAG
+	fprintf(stderr, fmt, file);
+#else
+	ttyStatus(fmt, file);
+#endif
+}
+
+
+/*
+ * Dump the current state of the search as a binary checkpoint, which is
+ * written next to the file first and then renamed over it, so that the
+ * file always holds a whole checkpoint even if we are killed meanwhile.
+ */
+static void
+dumpCheckpoint(Engine * eng, const char * file)
+{
+	Checkpoint	header;
+	FILE *		fp;
+	char *		tmpFile;
+	unsigned char *	bits;
+	const Cell *	cell;
+	Cell **		set;
+	const size_t *	param;
+	int		cellCount;
+	int		bitCount;
+	int		index;
+	int		value;
+	int		row;
+	int		col;
+	int		gen;
+	Bool		failed;
+
+	cellCount = eng->rowMax * eng->colMax;
+	bitCount = cellCount * eng->genMax;
+	tmpFile = malloc(strlen(file) + 5);
+	bits = calloc((bitCount + 7) / 8, 1);
+
+	if ((tmpFile == NULL) || (bits == NULL))
+	{
+		fileStatus("Cannot dump state to \"%s\"\n", file);
+		free(tmpFile);
+		free(bits);
+
+		return;
+	}
+
+	sprintf(tmpFile, "%s.tmp", file);
+	fp = fopen(tmpFile, "wb");
+
+	if (fp == NULL)
+	{
+		fileStatus("Cannot create \"%s\"\n", tmpFile);
+		free(tmpFile);
+		free(bits);
+
+		return;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+	header.version = CHECKPOINT_VERSION;
+	header.byteOrder = CHECKPOINT_ORDER;
+
+	for (param = paramTable; param < paramEnd; param++)
+		header.paramCount++;
+
+	header.setCount = eng->nextSet - eng->setTable;
+	header.baseCount = eng->baseSet - eng->setTable;
+	header.cellCount = cellCount;
+
+	if (!isLife)
+		strcpy(header.rule, ruleString);
+
+	fwrite(&header, sizeof(header), 1, fp);
+
+	for (param = paramTable; param < paramEnd; param++)
+		fwrite(&paramValue(eng, param), sizeof(int), 1, fp);
+
+	for (set = eng->setTable; set != eng->nextSet; set++)
+	{
+		cell = *set;
+		value = checkpointIndex(eng, cell->row, cell->col,
+			cell->gen) << 2;
+
+		if (cell->state == ON)
+			value |= 2;
+
+		if (cell->free)
+			value |= 1;
+
+		fwrite(&value, sizeof(value), 1, fp);
+	}
+
+	/*
+	 * The cells excluded from the search, then the frozen ones.
+	 */
+	for (gen = 0; gen < eng->genMax; gen++)
+		for (row = 1; row <= eng->rowMax; row++)
+			for (col = 1; col <= eng->colMax; col++)
+	{
+		if (findCell(eng, row, col, gen)->choose)
+			continue;
+
+		index = checkpointIndex(eng, row, col, gen);
+		bits[index / 8] |= 1 << (index % 8);
+	}
+
+	fwrite(bits, 1, (bitCount + 7) / 8, fp);
+	memset(bits, 0, (cellCount + 7) / 8);
+
+	for (row = 1; row <= eng->rowMax; row++)
+		for (col = 1; col <= eng->colMax; col++)
+	{
+		if (!findCell(eng, row, col, 0)->frozen)
+			continue;
+
+		index = checkpointIndex(eng, row, col, 0);
+		bits[index / 8] |= 1 << (index % 8);
+	}
+
+	fwrite(bits, 1, (cellCount + 7) / 8, fp);
+	free(bits);
+
+	failed = (fflush(fp) != 0) || ferror(fp) || (fsync(fileno(fp)) != 0);
+
+	if ((fclose(fp) != 0) || failed || (rename(tmpFile, file) != 0))
+	{
+		fileStatus("Error writing \"%s\"\n", tmpFile);
+		remove(tmpFile);
+		free(tmpFile);
+
+		return;
+	}
+
+	free(tmpFile);
+#if !HEADLESS_FLAG
+	ttyStatus("State dumped to \"%s\"\n", file);
+#endif
+	eng->quitOk = TRUE;
+}
+
+
+/*
+ * Load a binary checkpoint, which is mapped into memory and restored by
+ * making its settings again, without examining any cell.
+ * Returns OK on success, ERROR on failure.
+ */
+static Status
+loadCheckpoint(Engine * eng, const char * file)
+{
+	const Checkpoint *	header;
+	const unsigned char *	bits;
+	const int *		values;
+	void *			data;
+	struct stat		info;
+	size_t			size;
+	const size_t *		param;
+	int			fd;
+	int			i;
+	int			index;
+	int			cellCount;
+	int			bitCount;
+	Status			status;
+	char			rule[sizeof(header->rule) + 1];
+
+	fd = open(file, O_RDONLY);
+
+	if (fd < 0)
+	{
+		fileStatus("Cannot open state file \"%s\"\n", file);
+
+		return ERROR;
+	}
+
+	if ((fstat(fd, &info) != 0) || (info.st_size < (off_t) sizeof(*header)))
+	{
+		fileStatus("Truncated state file \"%s\"\n", file);
+		close(fd);
+
+		return ERROR;
+	}
+
+	size = info.st_size;
+	data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		fileStatus("Cannot map state file \"%s\"\n", file);
+
+		return ERROR;
+	}
+
+	status = ERROR;
+	header = data;
+	values = (const int *) (header + 1);
+
+	if ((header->version != CHECKPOINT_VERSION) ||
+		(header->byteOrder != CHECKPOINT_ORDER))
+	{
+		fileStatus("Unknown version in state file \"%s\"\n", file);
+
+		goto done;
+	}
+
+	if ((header->paramCount < 0) || (header->setCount < 0) ||
+		(header->baseCount < 0) ||
+		(header->baseCount > header->setCount) ||
+		(header->setCount > MAX_CELLS) || (header->paramCount > 1000) ||
+		(size < sizeof(*header) +
+			(header->paramCount + header->setCount) * sizeof(int)))
+	{
+		fileStatus("Truncated state file \"%s\"\n", file);
+
+		goto done;
+	}
+
+	if (header->rule[0])
+	{
+		memcpy(rule, header->rule, sizeof(header->rule));
+		rule[sizeof(header->rule)] = '\0';
+
+		if (!setRules(rule))
+		{
+			fileStatus("Bad Life rules in state file \"%s\"\n", file);
+
+			goto done;
+		}
+	}
+
+	/*
+	 * Parameters missing at the end are defaulted to zero.
+	 */
+	for (param = paramTable, i = 0; param < paramEnd; param++, i++)
+		paramValue(eng, param) =
+			(i < header->paramCount) ? values[i] : 0;
+
+	values += header->paramCount;
+	cellCount = eng->rowMax * eng->colMax;
+	bitCount = cellCount * eng->genMax;
+
+	if ((eng->rowMax < 1) || (eng->rowMax > ROW_MAX) ||
+		(eng->colMax < 1) || (eng->colMax > COL_MAX) ||
+		(eng->genMax < 1) || (eng->genMax > GEN_MAX) ||
+		(header->cellCount != cellCount) ||
+		(size < sizeof(*header) + (header->paramCount +
+			header->setCount) * sizeof(int) + (bitCount + 7) / 8 +
+			(cellCount + 7) / 8))
+	{
+		fileStatus("Bad sizes in state file \"%s\"\n", file);
+
+		goto done;
+	}
+
+	if (initCells(eng) != OK)
+		fatal(eng->error);
+
+	eng->newSet = eng->setTable;
+
+	for (i = 0; i < header->setCount; i++)
+	{
+		index = values[i] >> 2;
+
+		if ((index < 0) || (index >= bitCount) ||
+			(setCell(eng, findCell(eng,
+				(index / eng->colMax) % eng->rowMax + 1,
+				index % eng->colMax + 1, index / cellCount),
+				(values[i] & 2) ? ON : OFF, values[i] & 1) != OK))
+		{
+			fileStatus("Inconsistent settings in state file \"%s\"\n",
+				file);
+
+			goto done;
+		}
+	}
+
+	bits = (const unsigned char *) (values + header->setCount);
+
+	for (index = 0; index < bitCount; index++)
+	{
+		if (bits[index / 8] & (1 << (index % 8)))
+			findCell(eng, (index / eng->colMax) % eng->rowMax + 1,
+				index % eng->colMax + 1,
+				index / cellCount)->choose = FALSE;
+	}
+
+	bits += (bitCount + 7) / 8;
+
+	for (index = 0; index < cellCount; index++)
+	{
+		if (bits[index / 8] & (1 << (index % 8)))
+			freezeCell(eng, index / eng->colMax + 1,
+				index % eng->colMax + 1);
+	}
+
+	eng->baseSet = &eng->setTable[header->baseCount];
+	eng->nextSet = &eng->setTable[header->setCount];
+	status = OK;
+
+#if !HEADLESS_FLAG
+	ttyStatus("State loaded from \"%s\"\n", file);
+#endif
+	eng->quitOk = TRUE;
+
+done:
+	munmap(data, size);
+
+	return status;
+}
+
+
+/*
+ * Read a file containing initial settings for the specified generation,
+ * which is usually gen 0 or the last gen.
  * If setAll is TRUE, both the ON and the OFF cells will be set.
  * If setDeep is TRUE, then OFF cells will be set deeply (in all generations).
- * Returns OK on success, ERROR on error.
+ * Returns OK on success, NOT_EXIST if the settings are inconsistent,
+ * which is left to the caller to report, and ERROR on error.
  */
 static Status
-readFile(const char * file)
+readFile(Engine * eng, const char * file, int activeGen)
 {
 	FILE *		fp;
 	const char *	cp;
 	char		ch;
 	int		row;
 	int		col;
-	int		activeGen;
 	int		minGen;
 	int		maxGen;
 	int		gen;
@@ -1786,7 +2643,6 @@ readFile(const char * file)
 		return ERROR;
 	}
 
-	activeGen = (parent ? (genMax - 1) : 0);
 	row = 0;
 
 	while (fgets(buf, LINE_SIZE, fp))
@@ -1807,7 +2663,7 @@ readFile(const char * file)
 			 * Check for out of range coordinates.
 			 * OFF and UNK cells are allowed for convenience.
 			 */
-			if ((row > rowMax) || (col > colMax))
+			if ((row > eng->rowMax) || (col > eng->colMax))
 			{
 				if ((ch == '.') || (ch == ' ') ||
 					(ch == ':') || (ch == '?'))
@@ -1829,11 +2685,11 @@ readFile(const char * file)
 
 				case 'x':
 				case 'X':
-					excludeCone(row, col, activeGen);
+					excludeCone(eng, row, col, activeGen);
 					continue;
 
 				case '+':
-					freezeCell(row, col);
+					freezeCell(eng, row, col);
 					continue;
 
 				case '.':
@@ -1841,10 +2697,10 @@ readFile(const char * file)
 					if (!setAll)
 						continue;
 
-					if (setDeep)
+					if (eng->setDeep)
 					{
 						minGen = 0;
-						maxGen = genMax;
+						maxGen = eng->genMax;
 					}
 
 					state = OFF;
@@ -1852,7 +2708,7 @@ readFile(const char * file)
 
 				case ':':
 					minGen = 0;
-					maxGen = genMax;
+					maxGen = eng->genMax;
 					state = OFF;
 					break;
 
@@ -1872,16 +2728,12 @@ readFile(const char * file)
 
 			for (gen = minGen; gen <= maxGen; gen++)
 			{
-				if (proceed(findCell(row, col, gen),
+				if (proceed(eng, findCell(eng, row, col, gen),
 					state, FALSE) != OK)
 				{
-					ttyStatus(
-					"Inconsistent state for cell %d %d\n",
-						row, col);
-
 					fclose(fp);
 
-					return ERROR;
+					return NOT_EXIST;
 				}
 			}
 		}
@@ -1898,6 +2750,195 @@ readFile(const char * file)
 }
 
 
+/*
+ * Find the cells of the last generation which an initial file leaves
+ * able to be ON, reading it the way readFile does, so that a sparse
+ * search only searches generation 0 near them.  Cells the file does not
+ * reach are unknown, and errors in the file are left to readFile.
+ */
+static void
+readSupport(Engine * eng, const char * file)
+{
+	FILE *		fp;
+	const char *	cp;
+	int		row;
+	int		col;
+	char		buf[LINE_SIZE];
+
+	for (row = 1; row <= eng->rowMax; row++)
+		for (col = 1; col <= eng->colMax; col++)
+			eng->support[row][col] = TRUE;
+
+	fp = fopen(file, "r");
+
+	if (fp == NULL)
+		return;
+
+	row = 0;
+
+	while (fgets(buf, LINE_SIZE, fp) && (++row <= eng->rowMax))
+	{
+		col = 0;
+
+		for (cp = buf; *cp && (*cp != '\n') && (++col <= eng->colMax);
+			cp++)
+		{
+			if ((*cp == ':') ||
+				(setAll && ((*cp == '.') || (*cp == ' '))))
+			{
+				eng->support[row][col] = FALSE;
+			}
+		}
+	}
+
+	fclose(fp);
+}
+
+
+/*
+ * Set the cells of a cube, which is the specified line of a file of cubes
+ * written by splitting a search.  Each cell is given by its row, column,
+ * generation and state.  Returns OK on success, NOT_EXIST if the cube is
+ * inconsistent with the cells which are already set, and ERROR on error.
+ */
+static Status
+readCube(Engine * eng, const char * file, long index)
+{
+	FILE *		fp;
+	const char *	cp;
+	long		line;
+	int		row;
+	int		col;
+	int		gen;
+	int		state;
+	char		buf[CUBE_LINE_SIZE];
+
+	fp = fopen(file, "r");
+
+	if (fp == NULL)
+	{
+		ttyStatus("Cannot open \"%s\"\n", file);
+
+		return ERROR;
+	}
+
+	for (line = 0; line < index; line++)
+	{
+		if (fgets(buf, CUBE_LINE_SIZE, fp) == NULL)
+		{
+			ttyStatus("No cube %ld in \"%s\"\n", index, file);
+			fclose(fp);
+
+			return ERROR;
+		}
+	}
+
+	fclose(fp);
+	cp = buf;
+
+	while ((row = getNum(&cp, -1)) >= 0)
+	{
+		col = getNum(&cp, -1);
+		gen = getNum(&cp, -1);
+		state = getNum(&cp, -1);
+
+		if ((row < 1) || (row > eng->rowMax) || (col < 1) ||
+			(col > eng->colMax) || (gen < 0) ||
+			(gen >= eng->genMax) ||
+			((state != OFF) && (state != ON)))
+		{
+			ttyStatus("Bad cube %ld in \"%s\"\n", index, file);
+
+			return ERROR;
+		}
+
+		if (proceed(eng, findCell(eng, row, col, gen), (State) state,
+			FALSE) != OK)
+		{
+			return NOT_EXIST;
+		}
+	}
+
+	return OK;
+}
+
+
+/*
+ * Read the nogoods of a search from a file, each line of which is one
+ * in the format of a cube.  Returns OK on success, and ERROR on error.
+ */
+static Status
+readNogoods(Engine * eng, const char * file)
+{
+	FILE *		fp;
+	const char *	cp;
+	long		line;
+	int		count;
+	int		row;
+	int		col;
+	int		gen;
+	int		state;
+	Cell *		cells[NOGOOD_SIZE];
+	State		states[NOGOOD_SIZE];
+	char		buf[NOGOOD_LINE_SIZE];
+
+	fp = fopen(file, "r");
+
+	if (fp == NULL)
+	{
+		ttyStatus("Cannot open \"%s\"\n", file);
+
+		return ERROR;
+	}
+
+	for (line = 1; fgets(buf, NOGOOD_LINE_SIZE, fp); line++)
+	{
+		cp = buf;
+		count = 0;
+
+		while ((row = getNum(&cp, -1)) >= 0)
+		{
+			col = getNum(&cp, -1);
+			gen = getNum(&cp, -1);
+			state = getNum(&cp, -1);
+
+			if ((count >= NOGOOD_SIZE) || (row < 1) ||
+				(row > eng->rowMax) || (col < 1) ||
+				(col > eng->colMax) || (gen < 0) ||
+				(gen >= eng->genMax) ||
+				((state != OFF) && (state != ON)))
+			{
+				break;
+			}
+
+			cells[count] = findCell(eng, row, col, gen);
+			states[count++] = (State) state;
+		}
+
+		if (((*cp != '\n') && ((*cp != '\0') || !feof(fp))) ||
+			(count == 0))
+		{
+			ttyStatus("Bad nogood %ld in \"%s\"\n", line, file);
+			fclose(fp);
+
+			return ERROR;
+		}
+
+		if (addNogood(eng, cells, states, count) != OK)
+		{
+			ttyStatus("%s\n", eng->error);
+			fclose(fp);
+
+			return ERROR;
+		}
+	}
+
+	fclose(fp);
+
+	return OK;
+}
+
+
 /*
  * Check a string for being NULL, and if so, ask the user to specify a
  * value for it.  Returned string may be static and thus is overwritten
@@ -1993,6 +3034,37 @@ getNum(const char ** cpp, int defnum)
 }
 
 
+#if HEADLESS_FLAG
+/*
+ * Store a number in big endian order using the specified number of bytes.
+ * Returns the position just after the stored number.
+ */
+static unsigned char *
+putNum(unsigned char * cp, unsigned long num, int size)
+{
+	int	i;
+
+	for (i = size - 1; i >= 0; i--)
+	{
+		cp[i] = num & 0xff;
+		num >>= 8;
+	}
+
+	return cp + size;
+}
+
+
+/*
+ * Signal handler asking the search to stop at the next chance.
+ */
+static void
+stopSearch(int sig)
+{
+	signalEngine->interrupted = TRUE;
+}
+#endif
+
+
 /*
  * Parse a string and set the Life rules from it.
  * Returns TRUE on success, or FALSE on an error.
@@ -2008,8 +3080,8 @@ setRules(const char * cp)
 
 	for (i = 0; i < 9; i++)
 	{
-		bornRules[i] = OFF;
-		liveRules[i] = OFF;
+		rules.bornRules[i] = OFF;
+		rules.liveRules[i] = OFF;
 	}
 
 	if (*cp == '\0')
@@ -2043,10 +3115,10 @@ setRules(const char * cp)
 		for (i = 0; i < 9; i++)
 		{
 			if (bits & 0x01)
-				bornRules[i] = ON;
+				rules.bornRules[i] = ON;
 
 			if (bits & 0x02)
-				liveRules[i] = ON;
+				rules.liveRules[i] = ON;
 
 			bits >>= 2;
 		}
@@ -2060,7 +3132,7 @@ setRules(const char * cp)
 			cp++;
 
 		while ((*cp >= '0') && (*cp <= '8'))
-			bornRules[*cp++ - '0'] = ON;
+			rules.bornRules[*cp++ - '0'] = ON;
 
 		if ((*cp != ',') && (*cp != '/'))
 			return FALSE;
@@ -2071,7 +3143,7 @@ setRules(const char * cp)
 			cp++;
 
 		while ((*cp >= '0') && (*cp <= '8'))
-			liveRules[*cp++ - '0'] = ON;
+			rules.liveRules[*cp++ - '0'] = ON;
 
 		if (*cp)
 			return FALSE;
@@ -2087,7 +3159,7 @@ setRules(const char * cp)
 
 	for (i = 0; i < 9; i++)
 	{
-		if (bornRules[i] == ON)
+		if (rules.bornRules[i] == ON)
 			*cpTemp++ = '0' + i;
 	}
 
@@ -2096,13 +3168,14 @@ setRules(const char * cp)
 
 	for (i = 0; i < 9; i++)
 	{
-		if (liveRules[i] == ON)
+		if (rules.liveRules[i] == ON)
 			*cpTemp++ = '0' + i;
 	}
 
 	*cpTemp = '\0';
 
 	isLife = (strcmp(ruleString, "B3/S23") == 0);
+	initRules(&rules);
 
 	return TRUE;
 }
@@ -2162,17 +3235,29 @@ usage(void)
 	"   -ow  Set search order to find wide objects first",
 	"   -og  Set search order to examine all gens in a column before next column",
 	"   -om  Set search order to examine from middle column outwards",
+	"   -oa  Set search order dynamically by conflict activity",
 	"   -p   Only look for parents of last generation",
 	"   -a   Find all objects (even those with subPeriods)",
 	"   -v   View object every N thousand searches",
 	"   -d   Dump status to file every N thousand searches",
+	"   -db  Dump status as a binary checkpoint every N thousand searches",
 	"   -l   Load status from file",
 	"   -ln  Load status without entering command mode",
 	"   -i   Read initial object setting both ON and OFF cells",
 	"   -in  Read initial object from file setting only ON cells",
 	"   -id  Read initial object setting OFF cells deeply (all gens)",
+	"   -ip  Read settings of generation 0 from file, as -i does",
 	"   -o   Output objects to file (appending) every N columns",
 	"   -R   Use Life rules specified by born,live values",
+	"   -L   Look ahead at N unknown cells before each choice",
+	"   -S   Break ties in the search order randomly using seed N",
+	"   -C   Stop searching after N conflicts as if interrupted",
+	"   -e   Report an estimate of progress every N seconds (headless)",
+	"   -M   Remember N thousand failed column frontiers (headless, -p)",
+	"   -z   Search generation 0 only within N cells of the last gen (-p)",
+	"   -K   Split search into cubes of N cells written to file",
+	"   -k   Search only within cube number N read from file",
+	"   -kx  Exclude objects having all the cells of a line of file",
 	NULL
 	};
 
@@ -6,6 +6,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+#include <time.h>
 
 
 /*
@@ -24,6 +26,14 @@
 #define	DEBUG_FLAG	0	/* nonzero for debugging features */
 #endif
 
+#ifndef HEADLESS_FLAG
+#define	HEADLESS_FLAG	0	/* nonzero to search without a terminal */
+#endif
+
+#ifndef PARENT_FLAG
+#define	PARENT_FLAG	0	/* nonzero to only look for parents */
+#endif
+
 
 /*
  * Other definitions
@@ -34,7 +44,18 @@
 #define	VIEW_MULT	1000		/* viewing frequency multiplier */
 #define	DUMP_MULT	1000		/* dumping frequency multiplier */
 #define	DUMP_FILE	"lifesrc.dmp"	/* default dump file name */
+#define	CHECKPOINT_MAGIC "LSCK"	/* start of binary dump files */
+#define	CHECKPOINT_VERSION 1		/* version of binary dump files */
+#define	PROGRESS_CHECK	1000		/* searches between looks at the clock */
 #define	LINE_SIZE	132		/* size of input lines */
+#define	CUBE_MAX	20		/* most cells in a cube */
+#define	CUBE_LINE_SIZE	(CUBE_MAX * 20)	/* size of lines of cube files */
+#define	NOGOOD_MAX	32		/* most nogoods of a search */
+#define	NOGOOD_SIZE	256		/* most cells in a nogood */
+#define	NOGOOD_LINE_SIZE	(NOGOOD_SIZE * 20)	/* size of lines of nogood files */
+#define	CUBE_LOOK	8		/* default cells to look ahead at to split */
+#define	MEMO_MULT	1000		/* frontier memo size multiplier */
+#define	MEMO_PROBES	4		/* memo entries a frontier can go in */
 
 #define	MAX_CELLS	((COL_MAX + 2) * (ROW_MAX + 2) * GEN_MAX)
 #define	AUX_CELLS	(TRANS_MAX * (COL_MAX + ROW_MAX + 4) * 2)
@@ -114,6 +135,21 @@ typedef struct
 } ColInfo;
 
 
+/*
+ * Counters describing the work done by the search.
+ */
+typedef struct
+{
+	unsigned long	decisions;	/* number of free choices made */
+	unsigned long	backtracks;	/* number of choices backed up */
+	unsigned long	setCells;	/* number of calls to setCell */
+	unsigned long	consistifies;	/* number of calls to consistify */
+	unsigned long	conflicts;	/* number of inconsistent settings */
+	unsigned long	maxDepth;	/* largest number of set cells */
+	unsigned long	nanoSeconds;	/* time spent searching */
+} Stats;
+
+
 /*
  * Information about one cell of the search.
  */
@@ -125,11 +161,20 @@ struct Cell
 	PackedBool	free;		/* this cell still has free choice */
 	PackedBool	frozen;		/* this cell is frozen in all gens */
 	PackedBool	choose;		/* can choose this cell if unknown */
+	PackedBool	flipped;	/* set to the other state of a choice */
+	State		lookState;	/* state set by a lookahead branch */
 	short		gen;		/* generation number of this cell */
 	short		row;		/* row of this cell */
 	short		col;		/* column of this cell */
 	short		near;		/* count of cells this cell is near */
+	short		sum;		/* sum of the states of its neighbors */
+	unsigned int	setTime;	/* set clock when it was last set */
+	unsigned int	checkTime;	/* set clock when last consistified */
+	unsigned long	zobrist[2];	/* hash keys of its OFF and ON states */
+	int		heapIndex;	/* position in the activity heap */
+	double		activity;	/* conflict activity for dynamic order */
 	Cell *		search;		/* cell next to be searched */
+	Cell *		resume;		/* search list when it was chosen */
 	Cell *		past;		/* cell in past at this location */
 	Cell *		future;		/* cell in future at this location */
 	Cell *		cul;		/* cell to up and left */
@@ -149,104 +194,251 @@ struct Cell
 
 
 /*
- * Declare this macro so that by default the variables are defined external.
- * In the main program, this is defined as a null value so as to actually
- * define the variables.
+ * IMPLIC flag values, see search.c.
  */
-#ifndef	EXTERN
-#define	EXTERN	extern
-#endif
+typedef	unsigned char	Flags;
 
 
 /*
- * Current parameter values for the program to be saved over runs.
- * These values are dumped and loaded by the dump and load commands.
- * If you add another parameter, be sure to also add it to paramTable,
- * preferably at the end so as to minimize dump file incompatibilities.
+ * The Life rules and the tables derived from them.  These are only
+ * read while searching, so that any number of searches can share them.
+ *
+ * Given the state of a cell and its neighbors in one generation, the
+ * table of transitions determines the state of the cell in the next
+ * generation, and the table of implications determines deductions about
+ * the cell and its neighbors in the previous generation.  Both tables
+ * are indexed by the descriptor value of a cell.
  */
-EXTERN	Status	curStatus;	/* current status of search */
-EXTERN	int	rowMax;		/* maximum number of rows */
-EXTERN	int	colMax;		/* maximum number of columns */
-EXTERN	int	genMax;		/* maximum number of generations */
-EXTERN	int	rowTrans;	/* translation of rows */
-EXTERN	int	colTrans;	/* translation of columns */
-EXTERN	Bool	rowSym;		/* enable row symmetry starting at column */
-EXTERN	Bool	colSym;		/* enable column symmetry starting at row */
-EXTERN	Bool	pointSym;	/* enable symmetry with central point */
-EXTERN	Bool	fwdSym;		/* enable forward diagonal symmetry */
-EXTERN	Bool	bwdSym;		/* enable backward diagonal symmetry */
-EXTERN	Bool	flipRows;	/* flip rows at column number from last to first generation */
-EXTERN	Bool	flipCols;	/* flip columns at row number from last to first generation */
-EXTERN	Bool	flipQuads;	/* flip quadrants from last to first gen */
-EXTERN	Bool	parent;		/* only look for parents */
-EXTERN	Bool	allObjects;	/* look for all objects including subPeriods */
-EXTERN	Bool	setDeep;	/* set cleared cells deeply from init file */
-EXTERN	int	nearCols;	/* maximum distance to be near columns */
-EXTERN	int	maxCount;	/* maximum number of cells in generation 0 */
-EXTERN	int	useRow;		/* row that must have at least one ON cell */
-EXTERN	int	useCol;		/* column that must have at least one ON cell */
-EXTERN	int	colCells;	/* maximum cells in a column */
-EXTERN	int	colWidth;	/* maximum width of each column */
-EXTERN	Bool	follow;		/* follow average position of previous column */
-EXTERN	Bool	orderWide;	/* ordering tries to find wide objects */
-EXTERN	Bool	orderGens;	/* ordering tries all gens first */
-EXTERN	Bool	orderMiddle;	/* ordering tries middle columns first */
-EXTERN	Bool	followGens;	/* try to follow setting of other gens */
+typedef	struct
+{
+	State	bornRules[9];	/* rules for whether a cell is to be born */
+	State	liveRules[9];	/* rules for whether a live cell stays alive */
+	State	transit[256];	/* table of transitions */
+	Flags	implic[256];	/* table of implications */
+} Rules;
 
 
 /*
- * These values are not affected when dumping and loading since they
- * do not affect the status of a search in progress.
- * They are either setTable on the command line or are computed.
+ * The frontier memo.  Once the first columns of generation 0 are all set,
+ * what is left of the search depends only on the last two of them, on
+ * the later columns and generations, and on how many more cells may be
+ * ON.  The frontiers which were searched without finding anything are
+ * remembered by a hash of those, so that reaching one of them again
+ * through other settings of the earlier columns backs up at once.
  */
-EXTERN	Bool	quiet;		/* don't output */
-EXTERN	Bool	debug;		/* enable debugging output (if compiled so) */
-EXTERN	Bool	quitOk;		/* ok to quit without confirming */
-EXTERN	Bool	inited;		/* initialization has been done */
-EXTERN	State	bornRules[9];	/* rules for whether a cell is to be born */
-EXTERN	State	liveRules[9];	/* rules for whether a live cell stays alive */
-EXTERN	int	curGen;		/* current generation for display */
-EXTERN	int	outputCols;	/* number of columns to save for output */
-EXTERN	int	outputLastCols;	/* last number of columns output */
-EXTERN	int	cellCount;	/* number of live cells in generation 0 */
-EXTERN	long	dumpFreq;	/* how often to perform dumps */
-EXTERN	long	dumpcount;	/* counter for dumps */
-EXTERN	long	viewFreq;	/* how often to view results */
-EXTERN	long	viewCount;	/* counter for viewing */
-EXTERN	char *	dumpFile;	/* dump file name */
-EXTERN	char *	outputFile;	/* file to output results to */
+typedef	struct
+{
+	unsigned long	key;		/* hash of the frontier, 0 if unused */
+	int		room;		/* cells which could still be ON */
+} MemoEntry;
+
+typedef	struct
+{
+	Cell **		mark;		/* set table position when reached */
+	unsigned long	key;		/* hash of the frontier */
+	int		col;		/* first column which is not full */
+	int		room;		/* cells which could still be ON */
+	Bool		found;		/* an object was found beyond it */
+} Frontier;
+
+
+#define	CHUNK_MAX	((MAX_CELLS + AUX_CELLS) / ALLOC_SIZE + 2)
 
 
 /*
- * Data about all of the cells.
+ * Everything about one search.  Each search has its own engine which is
+ * passed to the routines working on it, so that searches in separate
+ * engines do not affect each other.  Only the rules are shared.
  */
-EXTERN	Cell *	setTable[MAX_CELLS];	/* table of cells whose value is set */
-EXTERN	Cell **	newSet;		/* where to add new cells into setting table */
-EXTERN	Cell **	nextSet;	/* next cell in setting table to examine */
-EXTERN	Cell **	baseSet;	/* base of changeable part of setting table */
-EXTERN	Cell *	fullSearchList;	/* complete list of cells to search */
-EXTERN	RowInfo	rowInfo[ROW_MAX];	/* information about rows of gen 0 */
-EXTERN	ColInfo	colInfo[COL_MAX];	/* information about columns of gen 0 */
-EXTERN	int	fullColumns;	/* columns in gen 0 which are fully set */
+typedef	struct Engine Engine;
+
+struct Engine
+{
+	/*
+	 * Current parameter values for the program to be saved over runs.
+	 * These values are dumped and loaded by the dump and load commands.
+	 * If you add another parameter, be sure to also add it to
+	 * paramTable, preferably at the end so as to minimize dump file
+	 * incompatibilities.
+	 */
+	Status	curStatus;	/* current status of search */
+	int	rowMax;		/* maximum number of rows */
+	int	colMax;		/* maximum number of columns */
+	int	genMax;		/* maximum number of generations */
+	int	rowTrans;	/* translation of rows */
+	int	colTrans;	/* translation of columns */
+	Bool	rowSym;		/* enable row symmetry starting at column */
+	Bool	colSym;		/* enable column symmetry starting at row */
+	Bool	pointSym;	/* enable symmetry with central point */
+	Bool	fwdSym;		/* enable forward diagonal symmetry */
+	Bool	bwdSym;		/* enable backward diagonal symmetry */
+	Bool	flipRows;	/* flip rows at column number from last to first generation */
+	Bool	flipCols;	/* flip columns at row number from last to first generation */
+	Bool	flipQuads;	/* flip quadrants from last to first gen */
+	Bool	parent;		/* only look for parents */
+	Bool	allObjects;	/* look for all objects including subPeriods */
+	Bool	setDeep;	/* set cleared cells deeply from init file */
+	int	nearCols;	/* maximum distance to be near columns */
+	int	maxCount;	/* maximum number of cells in generation 0 */
+	int	useRow;		/* row that must have at least one ON cell */
+	int	useCol;		/* column that must have at least one ON cell */
+	int	colCells;	/* maximum cells in a column */
+	int	colWidth;	/* maximum width of each column */
+	Bool	follow;		/* follow average position of previous column */
+	Bool	orderWide;	/* ordering tries to find wide objects */
+	Bool	orderGens;	/* ordering tries all gens first */
+	Bool	orderMiddle;	/* ordering tries middle columns first */
+	Bool	followGens;	/* try to follow setting of other gens */
+	int	lookCells;	/* cells to look ahead at for each choice */
+	Bool	orderDynamic;	/* ordering follows conflicts while searching */
+	int	orderSeed;	/* seed for breaking ties in the order */
+	int	conflictLimit;	/* conflicts after which search stops */
+
+	/*
+	 * These values are not affected when dumping and loading since they
+	 * do not affect the status of a search in progress.
+	 * They are either set on the command line or are computed.
+	 */
+	const Rules *	rules;	/* rules of the search */
+	Bool	quitOk;		/* ok to quit without confirming */
+	Bool	inited;		/* initialization has been done */
+	int	curGen;		/* current generation for display */
+	int	outputCols;	/* number of columns to save for output */
+	int	outputLastCols;	/* last number of columns output */
+	int	cellCount;	/* number of live cells in generation 0 */
+	long	dumpFreq;	/* how often to perform dumps */
+	long	dumpcount;	/* counter for dumps */
+	long	viewFreq;	/* how often to view results */
+	long	viewCount;	/* counter for viewing */
+	char *	dumpFile;	/* dump file name */
+	long	progressFreq;	/* seconds between progress reports */
+	long	progressCount;	/* counter for progress reports */
+	long	memoSize;	/* entries of the frontier memo, 0 for none */
+	int	sparseDist;	/* reach of a sparse gen 0, 0 if not */
+	char *	outputFile;	/* file to output results to */
+	Stats	stats;		/* counters for the work done so far */
+	volatile sig_atomic_t	interrupted;	/* search was asked to stop */
+	const char *	error;		/* why the engine failed, or NULL */
+	struct timespec	startTime;	/* when the search was started */
+	struct timespec	reportTime;	/* when progress was last reported */
+
+	/*
+	 * Data about all of the cells.
+	 */
+	Cell *	setTable[MAX_CELLS];	/* table of cells whose value is set */
+	Cell **	newSet;		/* where to add new cells into setting table */
+	Cell **	nextSet;	/* next cell in setting table to examine */
+	Cell **	baseSet;	/* base of changeable part of setting table */
+	Cell *	fullSearchList;	/* complete list of cells to search */
+	Cell *	searchList;	/* current list of cells to search */
+	Cell *	(*getUnknown)(Engine *);	/* finds the next cell to choose */
+	RowInfo	rowInfo[ROW_MAX];	/* information about rows of gen 0 */
+	ColInfo	colInfo[COL_MAX];	/* information about columns of gen 0 */
+	int	fullColumns;	/* columns in gen 0 which are fully set */
+	unsigned int	setClock;	/* count of cells set, used as a clock */
+	Cell *	conflictCell;	/* cell being examined at last error */
+	Cell *	flipCell;	/* choice backed up to its other state */
+
+	/*
+	 * Allocation of the cells.
+	 */
+	int	newCellCount;		/* cells ready for allocation */
+	int	auxCellCount;		/* cells in auxillary table */
+	int	chunkCount;		/* number of chunks of cells */
+	Cell *	newCells;		/* cells ready for allocation */
+	Cell *	deadCell;		/* boundary cell value */
+	Cell *	cellTable[MAX_CELLS];	/* table of usual cells */
+	int	tableCount;		/* cells of the table in use */
+	Cell *	auxTable[AUX_CELLS];	/* table of auxillary cells */
+	Cell *	chunks[CHUNK_MAX];	/* chunks the cells were allocated in */
+	RowInfo	dummyRowInfo;		/* dummy info for ignored cells */
+	ColInfo	dummyColInfo;		/* dummy info for ignored cells */
+
+	/*
+	 * Looking ahead and splitting into cubes.
+	 */
+	Cell *	branchCells[MAX_CELLS];	/* cells set by a lookahead branch */
+	Cell *	commonCells[MAX_CELLS];	/* cells set alike by both branches */
+	State	commonStates[MAX_CELLS];	/* states of those cells */
+	Cell *	cubeCells[CUBE_MAX];	/* cells set by the cube being split */
+	State	cubeStates[CUBE_MAX];	/* states of those cells */
+
+	/*
+	 * The dynamic search order.
+	 */
+	Cell *	heap[MAX_CELLS];	/* cells by decreasing activity */
+	int	heapCount;		/* number of cells in the heap */
+	Bool	heapReady;		/* heap has been filled */
+	double	activityInc;		/* activity added by a conflict */
+
+	/*
+	 * The frontier memo.
+	 */
+	MemoEntry *	memoTable;	/* failed frontiers, NULL if none */
+	unsigned long	memoHash[GEN_MAX][COL_MAX + 2];	/* hash by column */
+	Frontier	frontiers[COL_MAX + 1];	/* frontiers being searched */
+	int		frontierCount;	/* number of those frontiers */
+
+	/*
+	 * The nogoods, which are settings of cells that no object may have
+	 * all of.
+	 */
+	Cell *	nogoodCells[NOGOOD_MAX][NOGOOD_SIZE];	/* cells of each nogood */
+	State	nogoodStates[NOGOOD_MAX][NOGOOD_SIZE];	/* their states */
+	int	nogoodSizes[NOGOOD_MAX];	/* number of cells of each nogood */
+	int	nogoodCount;		/* number of nogoods */
+
+	/*
+	 * The sparse search.
+	 */
+	PackedBool	support[ROW_MAX + 2][COL_MAX + 2];	/* not OFF */
+	Bool		sparse;	/* gen 0 is only searched near them */
+};
+
+
+/*
+ * Declare this macro so that by default the variables are defined external.
+ * In the main program, this is defined as a null value so as to actually
+ * define the variables.
+ */
+#ifndef	EXTERN
+#define	EXTERN	extern
+#endif
+
+
+/*
+ * Settings of the whole program.
+ */
+EXTERN	Bool	quiet;		/* don't output */
+EXTERN	Bool	debug;		/* enable debugging output (if compiled so) */
 
 
 /*
  * Global procedures
  */
-extern	void	getCommands(void);
-extern	void	initCells(void);
-extern	void	printGen(int);
-extern	void	writeGen(const char *, Bool);
-extern	void	dumpState(const char *);
-extern	void	adjustNear(Cell *, int);
-extern	Status	search(void);
-extern	Status	proceed(Cell *, State, Bool);
-extern	Status	go(Cell *, State, Bool);
-extern	Status	setCell(Cell *, State, Bool);
-extern	Cell *	findCell(int, int, int);
-extern	Cell *	backup(void);
-extern	Bool	subPeriods(void);
-extern	void	loopCells(Cell *, Cell *);
+extern	Engine *	newEngine(const Rules *);
+extern	void	freeEngine(Engine *);
+extern	void	initRules(Rules *);
+extern	void	getCommands(Engine *);
+extern	Status	initCells(Engine *);
+extern	void	printGen(Engine *, int);
+extern	void	writeGen(Engine *, const char *, Bool);
+extern	void	dumpState(Engine *, const char *);
+extern	void	reportResult(Engine *);
+extern	void	reportProgress(Engine *);
+extern	double	searchProgress(Engine *);
+extern	void	adjustNear(Engine *, Cell *, int);
+extern	Status	search(Engine *);
+extern	Status	splitSearch(Engine *, int, FILE *, long *);
+extern	Status	addNogood(Engine *, Cell **, const State *, int);
+extern	Status	proceed(Engine *, Cell *, State, Bool);
+extern	Status	go(Engine *, Cell *, State, Bool);
+extern	Status	setCell(Engine *, Cell *, State, Bool);
+extern	Cell *	findCell(Engine *, int, int, int);
+extern	Cell *	backup(Engine *);
+extern	void	undoTo(Engine *, Cell **);
+extern	Bool	subPeriods(Engine *);
+extern	void	loopCells(Engine *, Cell *, Cell *);
 extern	void	fatal(const char *);
 extern	Bool	ttyOpen(void);
 extern	Bool	ttyCheck(void);
@@ -0,0 +1,563 @@
+/*
+ * Life search program - micro benchmarks.
+ * Times the propagation primitives of the search module on synthetic
+ * boards, apart from any search, so that changes to the cell layout or
+ * to the primitives themselves can be measured without the luck of the
+ * search tree getting in the way.
+ *
+ * The search module is included directly so that its static routines
+ * can be called.  Every board is measured with an engine of its own.
+ */
+
+#include "search.c"
+
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+
+/*
+ * Time and cache misses spent in the measured parts of one benchmark.
+ */
+typedef struct
+{
+	double		nanoSeconds;	/* time spent */
+	long long	misses;		/* cache misses, or -1 if unknown */
+	long		ops;		/* number of operations done */
+	long		errors;		/* operations which found a conflict */
+} Meter;
+
+
+static	unsigned long	seed;		/* state of the random generator */
+static	int		missFd = -1;	/* perf event for cache misses */
+static	struct timespec	startTime;	/* start of the measured part */
+static	volatile int	sink;		/* keeps results from being unused */
+static	int		density;	/* percentage of ON cells */
+static	int		rounds;		/* rounds done for each benchmark */
+static	Rules		lifeRules;	/* rules of the boards */
+
+
+static	void	usage(void);
+static	void	runBoard(int, int);
+static	void	initBoard(Engine *, int, int);
+static	void	setTarget(Engine *);
+static	Cell *	randomCell(Engine *, int);
+static	State	randomState(void);
+static	void	resetMeter(Meter *);
+static	void	startMeter(Meter *);
+static	void	stopMeter(Meter *);
+static	void	printMeter(Engine *, const char *, const Meter *);
+static	void	benchGetDesc(Engine *);
+static	void	benchSetCell(Engine *);
+static	void	benchConsistify(Engine *);
+static	void	benchProceed(Engine *);
+static	void	openMissCounter(void);
+
+
+/*
+ * The default boards, from small ones up to the largest allowed.
+ */
+static	const int	boardSizes[][2] =
+{
+	{16, 16}, {32, 32}, {ROW_MAX, 64}, {ROW_MAX, COL_MAX}
+};
+
+static	const int	boardDensities[] = {10, 30, 50};
+
+
+int
+main(int argc, char ** argv)
+{
+	int	rows;
+	int	cols;
+	int	wantDensity;
+	int	opt;
+	int	i;
+	int	j;
+
+	rows = 0;
+	cols = 0;
+	wantDensity = -1;
+	rounds = 200;
+
+	while ((opt = getopt(argc, argv, "r:c:d:n:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'r':
+				rows = atoi(optarg);
+				break;
+
+			case 'c':
+				cols = atoi(optarg);
+				break;
+
+			case 'd':
+				wantDensity = atoi(optarg);
+				break;
+
+			case 'n':
+				rounds = atoi(optarg);
+				break;
+
+			default:
+				usage();
+				exit(1);
+		}
+	}
+
+	if ((rows < 0) || (rows > ROW_MAX) || (cols < 0) || (cols > COL_MAX)
+		|| (wantDensity > 100) || (rounds <= 0) || (!rows != !cols))
+	{
+		usage();
+		exit(1);
+	}
+
+	lifeRules.bornRules[3] = ON;
+	lifeRules.liveRules[2] = ON;
+	lifeRules.liveRules[3] = ON;
+	initRules(&lifeRules);
+	openMissCounter();
+
+	printf("%-12s %5s %5s %4s %10s %9s %10s %8s\n", "primitive",
+		"rows", "cols", "on%", "ops", "ns/op", "misses/op", "errors");
+
+	/*
+	 * Without a board size or density given, sweep over the defaults.
+	 */
+	for (i = 0; i < (int) (sizeof(boardSizes) / sizeof(boardSizes[0])); i++)
+	{
+		for (j = 0; j < (int) (sizeof(boardDensities) / sizeof(int)); j++)
+		{
+			density = (wantDensity >= 0) ?
+				wantDensity : boardDensities[j];
+
+			if (rows)
+				runBoard(rows, cols);
+			else
+				runBoard(boardSizes[i][0], boardSizes[i][1]);
+
+			if (wantDensity >= 0)
+				break;
+		}
+
+		if (rows)
+			break;
+	}
+
+	return 0;
+}
+
+
+static void
+usage(void)
+{
+	fprintf(stderr,
+		"usage: microbench [-r rows -c cols] [-d density] [-n rounds]\n");
+}
+
+
+/*
+ * Run every benchmark on one board.
+ */
+static void
+runBoard(int rows, int cols)
+{
+	Engine *	eng;
+
+	eng = newEngine(&lifeRules);
+
+	if (eng == NULL)
+		fatal("Cannot allocate search engine");
+	initBoard(eng, rows, cols);
+	benchGetDesc(eng);
+	benchSetCell(eng);
+	benchConsistify(eng);
+	benchProceed(eng);
+	freeEngine(eng);
+}
+
+
+/*
+ * Set up the cells for searching parents of a board, like gol-sat does.
+ */
+static void
+initBoard(Engine * eng, int rows, int cols)
+{
+	eng->rowMax = rows;
+	eng->colMax = cols;
+	eng->genMax = 2;
+	eng->parent = TRUE;
+	seed = 12345;
+
+	if (initCells(eng) != OK)
+		fatal(eng->error);
+
+	eng->inited = TRUE;
+}
+
+
+/*
+ * Give every cell of generation 1 a random state, as the target of
+ * a parent search.
+ */
+static void
+setTarget(Engine * eng)
+{
+	int	row;
+	int	col;
+
+	for (row = 1; row <= eng->rowMax; row++)
+	{
+		for (col = 1; col <= eng->colMax; col++)
+		{
+			if (setCell(eng, findCell(eng, row, col, 1),
+				randomState(), FALSE) != OK)
+			{
+				fatal("Cannot set target cell");
+			}
+		}
+	}
+
+	eng->baseSet = eng->newSet;
+	eng->nextSet = eng->newSet;
+}
+
+
+/*
+ * Return a random cell of the specified generation.
+ */
+static Cell *
+randomCell(Engine * eng, int gen)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return findCell(eng, 1 + (int) ((seed >> 16) % eng->rowMax),
+		1 + (int) ((seed >> 8) % eng->colMax), gen);
+}
+
+
+/*
+ * Return ON with the probability given by the density.
+ */
+static State
+randomState(void)
+{
+	seed = seed * 1103515245 + 12345;
+
+	return (((seed >> 16) % 100) < (unsigned long) density) ? ON : OFF;
+}
+
+
+/*
+ * Time getDesc over all cells of both generations.
+ */
+static void
+benchGetDesc(Engine * eng)
+{
+	Meter	meter;
+	int	round;
+	int	row;
+	int	col;
+	int	gen;
+	int	sum;
+
+	setTarget(eng);
+	resetMeter(&meter);
+
+	for (round = 0; round < rounds * 10; round++)
+	{
+		sum = 0;
+		startMeter(&meter);
+
+		for (gen = 0; gen < eng->genMax; gen++)
+			for (col = 1; col <= eng->colMax; col++)
+				for (row = 1; row <= eng->rowMax; row++)
+					sum += getDesc(findCell(eng, row, col,
+						gen));
+
+		stopMeter(&meter);
+		sink = sum;
+		meter.ops += eng->genMax * eng->rowMax * eng->colMax;
+	}
+
+	undoTo(eng, eng->setTable);
+	eng->baseSet = eng->setTable;
+	printMeter(eng, "getDesc", &meter);
+}
+
+
+/*
+ * Time setting random cells of generation 0, without any checking
+ * of their consequences.
+ */
+static void
+benchSetCell(Engine * eng)
+{
+	static	Cell *	cells[(ROW_MAX + 2) * (COL_MAX + 2)];
+	static	State	states[(ROW_MAX + 2) * (COL_MAX + 2)];
+	Meter		meter;
+	Cell **		mark;
+	int		count;
+	int		round;
+	int		i;
+
+	setTarget(eng);
+	resetMeter(&meter);
+	count = eng->rowMax * eng->colMax;
+	mark = eng->newSet;
+
+	for (round = 0; round < rounds; round++)
+	{
+		for (i = 0; i < count; i++)
+		{
+			cells[i] = randomCell(eng, 0);
+			states[i] = randomState();
+		}
+
+		startMeter(&meter);
+
+		for (i = 0; i < count; i++)
+		{
+			if (setCell(eng, cells[i], states[i], FALSE) != OK)
+				meter.errors++;
+		}
+
+		stopMeter(&meter);
+		meter.ops += count;
+		undoTo(eng, mark);
+	}
+
+	undoTo(eng, eng->setTable);
+	eng->baseSet = eng->setTable;
+	printMeter(eng, "setCell", &meter);
+}
+
+
+/*
+ * Time consistify over every cell of generation 1, with half of the
+ * cells of generation 0 known.  The cells it sets are undone after
+ * each round.
+ */
+static void
+benchConsistify(Engine * eng)
+{
+	Meter	meter;
+	Cell **	mark;
+	Cell **	mark2;
+	int	round;
+	int	row;
+	int	col;
+	int	i;
+
+	setTarget(eng);
+	resetMeter(&meter);
+	mark = eng->newSet;
+
+	for (round = 0; round < rounds; round++)
+	{
+		for (i = eng->rowMax * eng->colMax / 2; i > 0; i--)
+			(void) setCell(eng, randomCell(eng, 0), randomState(),
+				FALSE);
+
+		mark2 = eng->newSet;
+		startMeter(&meter);
+
+		for (col = 1; col <= eng->colMax; col++)
+		{
+			for (row = 1; row <= eng->rowMax; row++)
+			{
+				if (consistify(eng, findCell(eng, row, col, 1))
+					!= OK)
+				{
+					meter.errors++;
+				}
+			}
+		}
+
+		stopMeter(&meter);
+		meter.ops += eng->rowMax * eng->colMax;
+		undoTo(eng, mark2);
+		undoTo(eng, mark);
+	}
+
+	undoTo(eng, eng->setTable);
+	eng->baseSet = eng->setTable;
+	printMeter(eng, "consistify", &meter);
+}
+
+
+/*
+ * Time proceed, which is setCell followed by examineNext and
+ * consistify10 until nothing more follows, for random cells of
+ * generation 0 on a board where a quarter of generation 0 is known.
+ */
+static void
+benchProceed(Engine * eng)
+{
+	Meter	meter;
+	Cell **	mark;
+	Cell **	mark2;
+	Cell *	cell;
+	int	round;
+	int	i;
+
+	setTarget(eng);
+	resetMeter(&meter);
+	mark = eng->newSet;
+
+	for (round = 0; round < rounds; round++)
+	{
+		for (i = eng->rowMax * eng->colMax / 4; i > 0; i--)
+			(void) setCell(eng, randomCell(eng, 0), randomState(),
+				FALSE);
+
+		eng->nextSet = eng->newSet;
+		mark2 = eng->newSet;
+
+		for (i = eng->rowMax * eng->colMax / 4; i > 0; i--)
+		{
+			cell = randomCell(eng, 0);
+
+			if (cell->state != UNK)
+				continue;
+
+			startMeter(&meter);
+
+			if (proceed(eng, cell, randomState(), FALSE) != OK)
+				meter.errors++;
+
+			stopMeter(&meter);
+			meter.ops++;
+			undoTo(eng, mark2);
+		}
+
+		undoTo(eng, mark);
+	}
+
+	undoTo(eng, eng->setTable);
+	eng->baseSet = eng->setTable;
+	printMeter(eng, "proceed", &meter);
+}
+
+
+static void
+resetMeter(Meter * meter)
+{
+	memset(meter, 0, sizeof(*meter));
+	meter->misses = -1;
+
+#ifdef __linux__
+	if (missFd >= 0)
+		ioctl(missFd, PERF_EVENT_IOC_RESET, 0);
+#endif
+}
+
+
+static void
+startMeter(Meter * meter)
+{
+#ifdef __linux__
+	if (missFd >= 0)
+		ioctl(missFd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+}
+
+
+static void
+stopMeter(Meter * meter)
+{
+	struct timespec	endTime;
+	long long	count;
+
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+
+	meter->nanoSeconds += (endTime.tv_sec - startTime.tv_sec) * 1e9
+		+ (endTime.tv_nsec - startTime.tv_nsec);
+
+#ifdef __linux__
+	if (missFd < 0)
+		return;
+
+	ioctl(missFd, PERF_EVENT_IOC_DISABLE, 0);
+
+	if (read(missFd, &count, sizeof(count)) == sizeof(count))
+		meter->misses = count;
+#endif
+}
+
+
+static void
+printMeter(Engine * eng, const char * name, const Meter * meter)
+{
+	printf("%-12s %5d %5d %4d %10ld %9.1f ", name, eng->rowMax,
+		eng->colMax, density, meter->ops,
+		meter->nanoSeconds / meter->ops);
+
+	if (meter->misses >= 0)
+		printf("%10.3f", (double) meter->misses / meter->ops);
+	else
+		printf("%10s", "-");
+
+	printf(" %8ld\n", meter->errors);
+}
+
+
+/*
+ * Open a counter of the cache misses of this process if the system
+ * allows it.  The counter keeps running totals, and is only enabled
+ * while measuring.
+ */
+static void
+openMissCounter(void)
+{
+#ifdef __linux__
+	struct perf_event_attr	attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+
+	missFd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+
+/*
+ * Report a fatal error and exit.
+ */
+void
+fatal(const char * msg)
+{
+	fprintf(stderr, "microbench: %s\n", msg);
+	exit(1);
+}
+
+
+/*
+ * The search loop can dump its state and report its progress, which
+ * none of the benchmarks asks it to do.
+ */
+void
+dumpState(Engine * eng, const char * file)
+{
+}
+
+
+void
+reportProgress(Engine * eng)
+{
+}
+
+/* END CODE */
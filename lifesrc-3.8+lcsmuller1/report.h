@@ -0,0 +1,65 @@
+/*
+ * Life search program - result report format.
+ * Headless builds report the outcome of a search on stdout as binary
+ * frames instead of printing the board, so that other programs can read
+ * results of any size without parsing text.  This file only contains
+ * definitions, so that such programs can include it too.
+ *
+ * Every frame starts with a header of REPORT_HEADER bytes:
+ *	2 bytes	REPORT_MAGIC0 and REPORT_MAGIC1
+ *	1 byte	frame type
+ *	1 byte	REPORT_VERSION
+ *	4 bytes	length of the payload which follows the header
+ * Readers must skip frames whose type they do not know.
+ * All numbers are unsigned and stored in big endian order.
+ *
+ * The payload of a REPORT_RESULT frame is:
+ *	1 byte	status, REPORT_FOUND, REPORT_NOT_EXIST, REPORT_STOPPED or
+ *		REPORT_SPLIT
+ *	1 byte	flags, REPORT_HAS_UNK if an unknown plane is present
+ *	4 bytes	number of ON cells in generation 0
+ *	8 bytes	number of free choices made
+ *	8 bytes	number of choices backed up
+ *	8 bytes	number of calls to setCell
+ *	8 bytes	number of calls to consistify
+ *	8 bytes	number of inconsistent settings
+ *	4 bytes	largest number of cells set at once
+ *	8 bytes	nanoseconds spent searching
+ *	2 bytes	number of rows
+ *	2 bytes	number of columns
+ * When the status is REPORT_FOUND, this is followed by the plane of ON
+ * cells of generation 0, and then by the plane of unknown cells if the
+ * flags say so.  A plane holds one bit per cell, row by row, with eight
+ * cells to a byte starting from the most significant bit.
+ *
+ * When asked to, headless builds also write REPORT_PROGRESS frames while
+ * searching, whose payload is:
+ *	4 bytes	estimated part of the search tree searched so far, in
+ *		units of 1/REPORT_PROGRESS_ONE
+ *	8 bytes	number of free choices made
+ *	8 bytes	nanoseconds spent searching
+ * The estimate takes every choice to split the rest of the tree in half.
+ */
+
+#define	REPORT_MAGIC0	'L'
+#define	REPORT_MAGIC1	'S'
+#define	REPORT_VERSION	2
+#define	REPORT_HEADER	8		/* size of the frame header */
+
+#define	REPORT_RESULT	1		/* frame type with the final result */
+#define	REPORT_PROGRESS	2		/* frame type with a progress estimate */
+
+#define	REPORT_FOUND	1		/* an object was found */
+#define	REPORT_NOT_EXIST 2		/* no such object exists */
+#define	REPORT_STOPPED	3		/* search was stopped by a signal */
+#define	REPORT_SPLIT	4		/* search was split into cubes */
+
+#define	REPORT_HAS_UNK	0x01		/* unknown plane follows ON plane */
+
+#define	REPORT_RESULT_SIZE	62	/* result payload without planes */
+#define	REPORT_PROGRESS_SIZE	20	/* progress payload */
+#define	REPORT_PROGRESS_ONE	1000000000L	/* all of the tree searched */
+
+#define	REPORT_PLANE_SIZE(rows, cols)	(((rows) * (cols) + 7) / 8)
+
+/* END CODE */
@@ -18,8 +18,6 @@
 /*
  * IMPLIC flag values.
  */
-typedef	unsigned char	Flags;
-
 #define	N0IC0	((Flags) 0x01)	/* new cell 0 ==> current cell 0 */
 #define	N0IC1	((Flags) 0x02)	/* new cell 0 ==> current cell 1 */
 #define	N1IC0	((Flags) 0x04)	/* new cell 1 ==> current cell 0 */
@@ -31,77 +29,134 @@ typedef	unsigned char	Flags;
 
 
 /*
- * Table of transitions.
- * Given the state of a cell and its neighbors in one generation,
- * this table determines the state of the cell in the next generation.
- * The table is indexed by the descriptor value of a cell.
- */
-static	State	transit[256];
-
-
-/*
- * Table of implications.
- * Given the state of a cell and its neighbors in one generation,
- * this table determines deductions about the cell and its neighbors
- * in the previous generation.
- * The table is indexed by the descriptor value of a cell.
+ * Values for the dynamic search order.
+ * Each conflict bumps the activity of the cells around it by an amount
+ * which grows by the decay factor, so that older conflicts count for less.
+ * The activities are scaled down before they can overflow.
  */
-static	Flags	implic[256];
+#define	HEAP_NEVER	(-2)		/* cell is never searched */
+#define	HEAP_OUT	(-1)		/* cell is not in the heap right now */
+#define	ACTIVITY_DECAY	0.95		/* decay of older conflicts */
+#define	ACTIVITY_LIMIT	1e100		/* bump size which forces scaling */
 
 
 /*
  * Table of state values.
  */
-static	State	states[nStates] = {OFF, ON, UNK};
+static	const State	states[nStates] = {OFF, ON, UNK};
 
 
 /*
- * Other local data.
+ * A cell of the search order together with where it goes in it.
  */
-static	int	newCellCount;		/* cells ready for allocation */
-static	int	auxCellCount;		/* cells in auxillary table */
-static	Cell *	newCells;		/* cells ready for allocation */
-static	Cell *	deadCell;		/* boundary cell value */
-static	Cell *	searchList;		/* current list of cells to search */
-static	Cell *	cellTable[MAX_CELLS];	/* table of usual cells */
-static	Cell *	auxTable[AUX_CELLS];	/* table of auxillary cells */
-static	RowInfo	dummyRowInfo;		/* dummy info for ignored cells */
-static	ColInfo	dummyColInfo;		/* dummy info for ignored cells */
+typedef	struct
+{
+	Cell *		cell;		/* the cell */
+	unsigned long	position;	/* position in the order */
+	unsigned long	key;		/* seeded key to break ties */
+} OrderEntry;
 
 
 /*
  * Local procedures
  */
-static	void	initTransit(void);
-static	void	initImplic(void);
-static	void	initSearchOrder(void);
-static	void	linkCell(Cell *);
-static	State	transition(State, int, int);
-static	State	choose(const Cell *);
-static	Flags	implication(State, int, int);
-static	Cell *	symCell(const Cell *);
-static	Cell *	mapCell(const Cell *, Bool);
-static	Cell *	allocateCell(void);
-static	Cell *	getNormalUnknown(void);
-static	Cell *	getAverageUnknown(void);
-static	Status	consistify(Cell *);
-static	Status	consistify10(Cell *);
-static	Status	examineNext(void);
-static	Bool	checkWidth(const Cell *);
+static	void	initTransit(Rules *);
+static	void	initImplic(Rules *);
+static	void	failEngine(Engine *, const char *);
+static	void	initSearchOrder(Engine *);
+static	Bool	nearSupport(const Engine *, int, int, int);
+static	void	linkCell(Engine *, Cell *);
+static	State	transition(const Rules *, State, int, int);
+static	State	choose(Engine *, const Cell *);
+static	Flags	implication(const Rules *, State, int, int);
+static	Cell *	symCell(Engine *, const Cell *);
+static	Cell *	mapCell(Engine *, const Cell *, Bool);
+static	Cell *	allocateCell(Engine *);
+static	void	freeCells(Engine *);
+static	Cell *	getNormalUnknown(Engine *);
+static	Cell *	getAverageUnknown(Engine *);
+static	Cell *	getActiveUnknown(Engine *);
+static	void	initActivity(Engine *);
+static	int	getTightness(Engine *, const Cell *);
+static	void	bumpConflict(Engine *, const Cell *);
+static	void	bumpBlock(Engine *, Cell *);
+static	void	heapInsert(Engine *, Cell *);
+static	void	heapUp(Engine *, int);
+static	void	heapDown(Engine *, int);
+static	Status	consistify(Engine *, Cell *);
+static	Status	consistifyAfter(Engine *, Cell *, unsigned int);
+static	Status	consistify10(Engine *, Cell *);
+static	void	resetClock(Engine *);
+static	Status	examineNext(Engine *);
+static	Status	lookahead(Engine *, Cell **);
+static	Status	splitCube(Engine *, int, int, FILE *, long *);
+static	void	releaseCell(Engine *, Cell *);
+#if !PARENT_FLAG
+static	Bool	checkWidth(Engine *, const Cell *);
+#endif
 static	int	getDesc(const Cell *);
 static	int	sumToDesc(State, int);
+static	void	adjustSums(Cell *, int);
 static	int	orderSortFunc(const void * addr1, const void * addr2);
-static	Cell *	(*getUnknown)(void);
-static	State	nextState(State, int);
+static	unsigned long	orderPosition(Engine *, const Cell *);
+static	unsigned long	orderKey(Engine *, const Cell *);
+static	State	nextState(const Rules *, State, int);
+static	unsigned long	memoKey(const Cell *, int);
+static	void	initMemo(Engine *);
+static	MemoEntry *	memoFind(Engine *, unsigned long);
+static	Status	memoCheck(Engine *);
+static	void	memoRelease(Engine *, Bool);
+static	void	memoFound(Engine *);
+static	Status	nogoodCheck(Engine *);
+
+
+/*
+ * Allocate an engine for a new search using the specified rules, which
+ * must stay unchanged while it exists.  Its parameters all start out
+ * as zero, and its cells are allocated when they are initialized.
+ * Returns NULL if the engine cannot be allocated.
+ */
+Engine *
+newEngine(const Rules * rules)
+{
+	Engine *	eng;
+
+	eng = (Engine *) calloc(1, sizeof(Engine));
+
+	if (eng == NULL)
+		return NULL;
+
+	eng->rules = rules;
+
+	return eng;
+}
+
+
+/*
+ * Free an engine along with its cells.
+ */
+void
+freeEngine(Engine * eng)
+{
+	freeCells(eng);
+	free(eng->memoTable);
+	free(eng);
+}
 
 
 /*
  * Initialize the table of cells.
  * Each cell in the active area is set to unknown state.
  * Boundary cells are set to zero state.
+ * A sparse search treats the cells of generation 0 which are farther
+ * than sparseDist from the support of the last generation as boundary
+ * cells too, and shares deadCell for those of them which are not even
+ * next to a cell being searched.
+ * Returns ERROR with the reason left in the engine's error if the
+ * parameters are bad or memory runs out.
  */
-void
-initCells(void)
+Status
+initCells(Engine * eng)
 {
 	int	row;
 	int	col;
@@ -114,49 +169,94 @@ initCells(void)
 	/*
 	 * Check whether valid parameters have been set.
 	 */
-	if ((rowMax <= 0) || (rowMax > ROW_MAX))
-		fatal("Row number out of range");
+	eng->error = NULL;
+
+	if ((eng->rowMax <= 0) || (eng->rowMax > ROW_MAX))
+		failEngine(eng, "Row number out of range");
 
-	if ((colMax <= 0) || (colMax > COL_MAX))
-		fatal("Column number out of range");
+	if ((eng->colMax <= 0) || (eng->colMax > COL_MAX))
+		failEngine(eng, "Column number out of range");
 
-	if ((genMax <= 0) || (genMax > GEN_MAX))
-		fatal("Generation number out of range");
+	if ((eng->genMax <= 0) || (eng->genMax > GEN_MAX))
+		failEngine(eng, "Generation number out of range");
 
-	if ((rowTrans < -TRANS_MAX) || (rowTrans > TRANS_MAX))
-		fatal("Row translation number out of range");
+	if ((eng->rowTrans < -TRANS_MAX) || (eng->rowTrans > TRANS_MAX))
+		failEngine(eng, "Row translation number out of range");
 
-	if ((colTrans < -TRANS_MAX) || (colTrans > TRANS_MAX))
-		fatal("Column translation number out of range");
+	if ((eng->colTrans < -TRANS_MAX) || (eng->colTrans > TRANS_MAX))
+		failEngine(eng, "Column translation number out of range");
+
+	if (eng->error)
+		return ERROR;
 
 	/*
 	 * The first allocation of a cell MUST be deadCell.
-	 * Then allocate the cells in the cell table.
+	 * Then allocate the cells in the cell table, after freeing
+	 * those of an earlier search.
+	 */
+	freeCells(eng);
+	eng->nogoodCount = 0;
+
+	eng->deadCell = allocateCell(eng);
+
+	if (eng->deadCell == NULL)
+		return ERROR;
+
+	eng->tableCount = (eng->colMax + 2) * (eng->rowMax + 2) * eng->genMax;
+
+	/*
+	 * Only searches for parents are sparse, since generation 0 is
+	 * then never consistified, and not with symmetries, -nc or -wc,
+	 * which walk through the cells of generation 0 by their links.
 	 */
-	deadCell = allocateCell();
+	eng->sparse = (eng->sparseDist && eng->parent && (eng->genMax > 1) &&
+		!eng->rowSym && !eng->colSym && !eng->pointSym &&
+		!eng->fwdSym && !eng->bwdSym && !eng->nearCols &&
+		!eng->colWidth);
+
+	i = 0;
 
-	for (i = 0; i < MAX_CELLS; i++)
-		cellTable[i] = allocateCell();
+	for (col = 0; col <= eng->colMax+1; col++)
+		for (row = 0; row <= eng->rowMax+1; row++)
+			for (gen = 0; gen < eng->genMax; gen++)
+	{
+		eng->cellTable[i++] = (eng->sparse && (gen == 0) &&
+			!nearSupport(eng, row, col, eng->sparseDist + 1)) ?
+			eng->deadCell : allocateCell(eng);
+	}
+
+	if (eng->error)
+		return ERROR;
 
 	/*
 	 * Link the cells together.
 	 */
-	for (col = 0; col <= colMax+1; col++)
+	for (col = 0; col <= eng->colMax+1; col++)
 	{
-		for (row = 0; row <= rowMax+1; row++)
+		for (row = 0; row <= eng->rowMax+1; row++)
 		{
-			for (gen = 0; gen < genMax; gen++)
+			for (gen = 0; gen < eng->genMax; gen++)
 			{
 				edge = ((row == 0) || (col == 0) ||
-					(row > rowMax) || (col > colMax));
+					(row > eng->rowMax) ||
+					(col > eng->colMax) ||
+					(eng->sparse && (gen == 0) &&
+					!nearSupport(eng, row, col,
+						eng->sparseDist)));
+
+				cell = findCell(eng, row, col, gen);
+
+				if (cell == eng->deadCell)
+					continue;
 
-				cell = findCell(row, col, gen);
 				cell->gen = gen;
 				cell->row = row;
 				cell->col = col;
+				cell->zobrist[OFF] = memoKey(cell, OFF);
+				cell->zobrist[ON] = memoKey(cell, ON);
 				cell->choose = TRUE;
-				cell->rowInfo = &dummyRowInfo;
-				cell->colInfo = &dummyColInfo;
+				cell->rowInfo = &eng->dummyRowInfo;
+				cell->colInfo = &eng->dummyColInfo;
 
 				/*
 				 * If this is not an edge cell, then its state
@@ -165,7 +265,7 @@ initCells(void)
 				 */
 				if (!edge)
 				{
-					linkCell(cell);
+					linkCell(eng, cell);
 					cell->state = UNK;
 					cell->free = TRUE;
 				}
@@ -174,11 +274,11 @@ initCells(void)
 				 * Map time forwards and backwards,
 				 * wrapping around at the ends.
 				 */
-				cell->past = findCell(row, col,
-					(gen+genMax-1) % genMax);
+				cell->past = findCell(eng, row, col,
+					(gen+eng->genMax-1) % eng->genMax);
 
-				cell->future = findCell(row, col,
-					(gen+1) % genMax);
+				cell->future = findCell(eng, row, col,
+					(gen+1) % eng->genMax);
 
 				/*
 				 * If this is not an edge cell, and
@@ -186,10 +286,12 @@ initCells(void)
 				 * this cell in the same loop as the
 				 * next symmetrical cell.
 				 */
-				if ((rowSym || colSym || pointSym ||
-					fwdSym || bwdSym) && !edge)
+				if ((eng->rowSym || eng->colSym ||
+					eng->pointSym || eng->fwdSym ||
+					eng->bwdSym) && !edge)
 				{
-					loopCells(cell, symCell(cell));
+					loopCells(eng, cell,
+						symCell(eng, cell));
 				}
 			}
 		}
@@ -200,53 +302,134 @@ initCells(void)
 	 * and the first generation, then change the future and past pointers
 	 * to implement it.  This is for translations and flips.
 	 */
-	if (rowTrans || colTrans || flipRows || flipCols || flipQuads)
+	if (eng->rowTrans || eng->colTrans || eng->flipRows ||
+		eng->flipCols || eng->flipQuads)
 	{
-		for (row = 0; row <= rowMax+1; row++)
+		for (row = 0; row <= eng->rowMax+1; row++)
 		{
-			for (col = 0; col <= colMax+1; col++)
+			for (col = 0; col <= eng->colMax+1; col++)
 			{
-				cell = findCell(row, col, genMax - 1);
-				cell2 = mapCell(cell, TRUE);
+				cell = findCell(eng, row, col,
+					eng->genMax - 1);
+				cell2 = mapCell(eng, cell, TRUE);
 				cell->future = cell2;
 				cell2->past = cell;
 
-				cell = findCell(row, col, 0);
-				cell2 = mapCell(cell, FALSE);
+				cell = findCell(eng, row, col, 0);
+				cell2 = mapCell(eng, cell, FALSE);
 				cell->past = cell2;
 				cell2->future = cell;
 			}
 		}
 	}
 
+	if (eng->error)
+		return ERROR;
+
 	/*
 	 * Initialize the row and column info addresses for generation 0.
 	 */
-	for (row = 1; row <= rowMax; row++)
+	for (row = 1; row <= eng->rowMax; row++)
 	{
-		for (col = 1; col <= colMax; col++)
+		for (col = 1; col <= eng->colMax; col++)
 		{
-			cell = findCell(row, col, 0);
-			cell->rowInfo = &rowInfo[row];
-			cell->colInfo = &colInfo[col];
+			cell = findCell(eng, row, col, 0);
+
+			/*
+			 * The cells left out of a sparse search count as
+			 * set, so that full columns are still seen as such.
+			 */
+			if (cell->state != UNK)
+			{
+				eng->colInfo[col].setCount++;
+
+				if (eng->colInfo[col].setCount == eng->rowMax)
+					eng->fullColumns++;
+
+				continue;
+			}
+
+			cell->rowInfo = &eng->rowInfo[row];
+			cell->colInfo = &eng->colInfo[col];
 		}
 	}
 
-	initSearchOrder();
+	initSearchOrder(eng);
 
-	if (follow)
-		getUnknown = getAverageUnknown;
+	if (eng->orderDynamic)
+		eng->getUnknown = getActiveUnknown;
+	else if (eng->follow)
+		eng->getUnknown = getAverageUnknown;
 	else
-		getUnknown = getNormalUnknown;
+		eng->getUnknown = getNormalUnknown;
+
+	eng->heapCount = 0;
+	eng->heapReady = FALSE;
+
+	eng->newSet = eng->setTable;
+	eng->nextSet = eng->setTable;
+	eng->baseSet = eng->setTable;
+
+	eng->curGen = 0;
+	eng->curStatus = OK;
+	/*
+	 * Now that every cell has its state, total up the states of
+	 * the neighbors of each one.  These sums are kept up to date
+	 * as cells are set and backed up.
+	 */
+	for (i = 0; i < eng->tableCount; i++)
+	{
+		cell = eng->cellTable[i];
+		cell->sum = cell->cul->state + cell->cu->state +
+			cell->cur->state + cell->cl->state + cell->cr->state +
+			cell->cdl->state + cell->cd->state + cell->cdr->state;
+	}
+
+	initMemo(eng);
+
+	return (eng->error ? ERROR : OK);
+}
+
 
-	newSet = setTable;
-	nextSet = setTable;
-	baseSet = setTable;
+/*
+ * Record why the engine failed, for its caller to report.  Only the
+ * first reason is kept, since the others usually follow from it.
+ */
+static void
+failEngine(Engine * eng, const char * msg)
+{
+	if (eng->error == NULL)
+		eng->error = msg;
+}
+
+
+/*
+ * Return whether a cell of generation 0 lies within the specified
+ * distance of a cell of the last generation which is not OFF, in rows,
+ * columns or diagonally.  The edges of the board are never support.
+ */
+static Bool
+nearSupport(const Engine * eng, int row, int col, int dist)
+{
+	int	tRow;
+	int	tCol;
+
+	for (tRow = row - dist; tRow <= row + dist; tRow++)
+	{
+		if ((tRow < 1) || (tRow > eng->rowMax))
+			continue;
+
+		for (tCol = col - dist; tCol <= col + dist; tCol++)
+		{
+			if ((tCol >= 1) && (tCol <= eng->colMax) &&
+				eng->support[tRow][tCol])
+			{
+				return TRUE;
+			}
+		}
+	}
 
-	curGen = 0;
-	curStatus = OK;
-	initTransit();
-	initImplic();
+	return FALSE;
 }
 
 
@@ -257,14 +440,23 @@ initCells(void)
  * from the left to the right columns.  The order can be changed though.
  */
 static void
-initSearchOrder(void)
+initSearchOrder(Engine * eng)
 {
-	int	row;
-	int	col;
-	int	gen;
-	int	count;
-	Cell *	cell;
-	Cell *	table[MAX_CELLS];
+	int		row;
+	int		col;
+	int		gen;
+	int		count;
+	Cell *		cell;
+	OrderEntry *	table;
+
+	table = (OrderEntry *) malloc(sizeof(OrderEntry) * MAX_CELLS);
+
+	if (table == NULL)
+	{
+		failEngine(eng, "Cannot allocate search order table");
+
+		return;
+	}
 
 	/*
 	 * Make a table of cells that will be searched.
@@ -272,74 +464,101 @@ initSearchOrder(void)
 	 */
 	count = 0;
 
-	for (gen = 0; gen < genMax; gen++)
-		for (col = 1; col <= colMax; col++)
-			for (row = 1; row <= rowMax; row++)
+	for (gen = 0; gen < eng->genMax; gen++)
+		for (col = 1; col <= eng->colMax; col++)
+			for (row = 1; row <= eng->rowMax; row++)
 	{
-		if (rowSym && (col >= rowSym) && (row * 2 > rowMax + 1))
+		if (eng->rowSym && (col >= eng->rowSym) &&
+			(row * 2 > eng->rowMax + 1))
+		{
+			continue;
+		}
+
+		if (eng->colSym && (row >= eng->colSym) &&
+			(col * 2 > eng->colMax + 1))
+		{
 			continue;
+		}
+
+		cell = findCell(eng, row, col, gen);
 
-		if (colSym && (row >= colSym) && (col * 2 > colMax + 1))
+		/*
+		 * Cells left out of a sparse search are never chosen.
+		 */
+		if (cell->state != UNK)
 			continue;
 
-		table[count++] = findCell(row, col, gen);
+		table[count].cell = cell;
+		table[count].position = orderPosition(eng, cell);
+		table[count].key = eng->orderSeed ? orderKey(eng, cell) : 0;
+		count++;
 	}
 
 	/*
 	 * Now sort the table based on our desired search order.
 	 */
-	qsort((char *) table, count, sizeof(Cell *), orderSortFunc);
+	qsort((char *) table, count, sizeof(OrderEntry), orderSortFunc);
 
 	/*
 	 * Finally build the search list from the table elements in the
 	 * final order.
 	 */
-	searchList = NULL;
+	eng->searchList = NULL;
 
 	while (--count >= 0)
 	{
-		cell = table[count];
-		cell->search = searchList;
-		searchList = cell;
+		cell = table[count].cell;
+		cell->search = eng->searchList;
+		eng->searchList = cell;
 	}
 	
-	fullSearchList = searchList;
+	eng->fullSearchList = eng->searchList;
+	free(table);
 }
 
 
 /*
  * The sort routine for searching.
+ * Cells are left in any order above and below the middle row, unless
+ * a seed makes this order random but repeatable.
  */
 static int
 orderSortFunc(const void * addr1, const void * addr2)
 {
-	const Cell **	cp1;
-	const Cell **	cp2;
-	const Cell *	c1;
-	const Cell *	c2;
-	int		midCol;
-	int		midRow;
-	int		dif1;
-	int		dif2;
+	const OrderEntry *	e1;
+	const OrderEntry *	e2;
+
+	e1 = (const OrderEntry *) addr1;
+	e2 = (const OrderEntry *) addr2;
+
+	if (e1->position != e2->position)
+		return ((e1->position < e2->position) ? -1 : 1);
 
-	cp1 = ((const Cell **) addr1);
-	cp2 = ((const Cell **) addr2);
+	if (e1->key != e2->key)
+		return ((e1->key < e2->key) ? -1 : 1);
 
-	c1 = *cp1;
-	c2 = *cp2;
+	return 0;
+}
+
+
+/*
+ * Return the position of a cell in the search order, apart from the
+ * ties broken by the order seed.  This is computed before sorting
+ * since the sort routine only gets the cells to compare.
+ */
+static unsigned long
+orderPosition(Engine * eng, const Cell * cell)
+{
+	unsigned long	position;
+	int		midCol;
+	int		midRow;
+	int		dif;
 
 	/*
 	 * If we do not order by all generations, then put all of
 	 * generation zero ahead of the other generations.
 	 */
-	if (!orderGens)
-	{
-		if (c1->gen < c2->gen)
-			return -1;
-
-		if (c1->gen > c2->gen)
-			return 1;
-	}
+	position = eng->orderGens ? 0 : cell->gen;
 
 	/*
 	 * Sort on the column number.
@@ -347,43 +566,24 @@ orderSortFunc(const void * addr1, const void * addr2)
 	 * But if middle ordering is set, the ordering is from the center
 	 * column outwards.
 	 */
-	if (orderMiddle)
+	if (eng->orderMiddle)
 	{
-		midCol = (colMax + 1) / 2;
-
-		dif1 = c1->col - midCol;
-
-		if (dif1 < 0)
-			dif1 = -dif1;
-
-		dif2 = c2->col - midCol;
-
-		if (dif2 < 0)
-			dif2 = -dif2;
+		midCol = (eng->colMax + 1) / 2;
 
-		if (dif1 < dif2)
-			return -1;
+		dif = cell->col - midCol;
 
-		if (dif1 > dif2)
-			return 1;
+		if (dif < 0)
+			dif = -dif;
 	}
 	else
-	{
-		if (c1->col < c2->col)
-			return -1;
+		dif = cell->col;
 
-		if (c1->col > c2->col)
-			return 1;
-	}
+	position = position * (COL_MAX + 2) + dif;
 
 	/*
 	 * Sort "even" positions ahead of "odd" positions.
 	 */
-	dif1 = (c1->row + c1->col + c1->gen) & 0x01;
-	dif2 = (c2->row + c2->col + c2->gen) & 0x01;
-
-	if (dif1 != dif2)
-		return dif1 - dif2;
+	position = position * 2 + ((cell->row + cell->col + cell->gen) & 0x01);
 
 	/*
 	 * Sort on the row number.
@@ -393,34 +593,69 @@ orderSortFunc(const void * addr1, const void * addr2)
 	 * opposite of the desired order because the initial setting
 	 * for new cells is OFF.
 	 */
-	midRow = (rowMax + 1) / 2;
-
-	dif1 = c1->row - midRow;
+	midRow = (eng->rowMax + 1) / 2;
 
-	if (dif1 < 0)
-		dif1 = -dif1;
+	dif = cell->row - midRow;
 
-	dif2 = c2->row - midRow;
+	if (dif < 0)
+		dif = -dif;
 
-	if (dif2 < 0)
-		dif2 = -dif2;
+	if (!eng->orderWide)
+		dif = ROW_MAX - dif;
 
-	if (dif1 < dif2)
-		return (orderWide ? -1 : 1);
-
-	if (dif1 > dif2)
-		return (orderWide ? 1 : -1);
+	position = position * (ROW_MAX + 1) + dif;
 
 	/*
 	 * Sort by the generation again if we didn't do it yet.
 	 */
-	if (c1->gen < c2->gen)
-		return -1;
+	return position * GEN_MAX + cell->gen;
+}
 
-	if (c1->gen > c2->gen)
-		return 1;
 
-	return 0;
+/*
+ * Return a pseudo-random key for a cell which depends only on its
+ * position and the order seed.
+ */
+static unsigned long
+orderKey(Engine * eng, const Cell * cell)
+{
+	unsigned long	key;
+
+	key = (unsigned long) eng->orderSeed;
+	key = key * 31 + cell->row;
+	key = key * 31 + cell->col;
+	key = key * 31 + cell->gen;
+	key = (key ^ (key >> 16)) * 0x45d9f3bUL;
+	key = (key ^ (key >> 16)) * 0x45d9f3bUL;
+
+	return (key ^ (key >> 16)) & 0xffffffffUL;
+}
+
+
+/*
+ * Return a pseudo-random hash key for a cell being in the specified
+ * state, which is mixed like the order keys from two halves so as to
+ * use all of the bits of a long.
+ */
+static unsigned long
+memoKey(const Cell * cell, int state)
+{
+	unsigned long	key;
+	unsigned long	high;
+
+	key = (unsigned long) state + 1;
+	key = key * 31 + cell->row;
+	key = key * 31 + cell->col;
+	key = key * 31 + cell->gen;
+	key = (key ^ (key >> 16)) * 0x45d9f3bUL;
+	key = (key ^ (key >> 16)) * 0x45d9f3bUL;
+	key = (key ^ (key >> 16)) & 0xffffffffUL;
+
+	high = (key ^ 0x9e3779b9UL) * 0x45d9f3bUL;
+	high = (high ^ (high >> 16)) * 0x45d9f3bUL;
+	high = (high ^ (high >> 16)) & 0xffffffffUL;
+
+	return key ^ ((high << 16) << 16);
 }
 
 
@@ -431,8 +666,10 @@ orderSortFunc(const void * addr1, const void * addr2)
  * If the cell is newly set, then it is added to the set table.
  */
 Status
-setCell(Cell * cell, State state, Bool free)
+setCell(Engine * eng, Cell * cell, State state, Bool free)
 {
+	eng->stats.setCells++;
+
 	if (cell->state == state)
 	{
 		DPRINTF4("setCell %d %d %d to state %s already set\n",
@@ -453,15 +690,18 @@ setCell(Cell * cell, State state, Bool free)
 
 	if (cell->gen == 0)
 	{
-		if (useCol && (colInfo[useCol].onCount == 0)
-			&& (colInfo[useCol].setCount == rowMax) && inited)
+#if !PARENT_FLAG
+		if (eng->useCol && (eng->colInfo[eng->useCol].onCount == 0)
+			&& (eng->colInfo[eng->useCol].setCount == eng->rowMax)
+			&& eng->inited)
 		{
 			return ERROR;
 		}
+#endif
 
 		if (state == ON)
 		{
-			if (maxCount && (cellCount >= maxCount))
+			if (eng->maxCount && (eng->cellCount >= eng->maxCount))
 			{
 				DPRINTF2("setCell %d %d 0 on exceeds maxCount\n",
 					cell->row, cell->col);
@@ -469,28 +709,36 @@ setCell(Cell * cell, State state, Bool free)
 				return ERROR;
 			}
 
-			if (nearCols && (cell->near <= 0) && (cell->col > 1)
-				&& inited)
+#if !PARENT_FLAG
+			if (eng->nearCols && (cell->near <= 0)
+				&& (cell->col > 1) && eng->inited)
 			{
 				return ERROR;
 			}
+#endif
 
-			if (colCells && (cell->colInfo->onCount >= colCells)
-				&& inited)
+			if (eng->colCells
+				&& (cell->colInfo->onCount >= eng->colCells)
+				&& eng->inited)
 			{
 				return ERROR;
 			}
 
-			if (colWidth && inited && checkWidth(cell))
+#if !PARENT_FLAG
+			if (eng->colWidth && eng->inited &&
+				checkWidth(eng, cell))
+			{
 				return ERROR;
+			}
 
-			if (nearCols)
-				adjustNear(cell, 1);
+			if (eng->nearCols)
+				adjustNear(eng, cell, 1);
+#endif
 
 			cell->rowInfo->onCount++;
 			cell->colInfo->onCount++;
 			cell->colInfo->sumPos += cell->row;
-			cellCount++;
+			eng->cellCount++;
 		}
 	}
 
@@ -498,14 +746,42 @@ setCell(Cell * cell, State state, Bool free)
 		cell->row, cell->col, cell->gen,
 		(free ? "free" : "forced"), ((state == ON) ? "on" : "off"));
 
-	*newSet++ = cell;
+	*eng->newSet++ = cell;
+
+	if ((unsigned long) (eng->newSet - eng->setTable) >
+		eng->stats.maxDepth)
+	{
+		eng->stats.maxDepth = eng->newSet - eng->setTable;
+	}
 
 	cell->state = state;
 	cell->free = free;
+	adjustSums(cell, state - UNK);
+
+#if PARENT_FLAG
+	if (free)
+		cell->resume = eng->searchList;
+#endif
+
+	if (++eng->setClock == 0)
+		resetClock(eng);
+
+	cell->setTime = eng->setClock;
+
+	if (eng->memoTable)
+		eng->memoHash[cell->gen][cell->col] ^= cell->zobrist[state];
+
+	/*
+	 * The cell returned by backup is the next one set when its
+	 * other state is tried, which is remembered for the estimate
+	 * of the progress of the search.
+	 */
+	cell->flipped = (cell == eng->flipCell);
+	eng->flipCell = NULL_CELL;
 	cell->colInfo->setCount++;
 
-	if ((cell->gen == 0) && (cell->colInfo->setCount == rowMax))
-		fullColumns++;
+	if ((cell->gen == 0) && (cell->colInfo->setCount == eng->rowMax))
+		eng->fullColumns++;
 
 	return OK;
 }
@@ -513,15 +789,16 @@ setCell(Cell * cell, State state, Bool free)
 
 /*
  * Calculate the current descriptor for a cell.
+ * The sum of the states of its neighbors counts the ON ones in its low
+ * nibble and the unknown ones in its high nibble, and is kept by the
+ * cell itself so that nothing needs to be loaded from its neighbors.
  */
 static int
 getDesc(const Cell * cell)
 {
 	int	sum;
 
-	sum = cell->cul->state + cell->cu->state + cell->cur->state;
-	sum += cell->cdl->state + cell->cd->state + cell->cdr->state;
-	sum += cell->cl->state + cell->cr->state;
+	sum = cell->sum;
 
 	return ((sum & 0x88) ? (sum + cell->state * 2 + 0x11) :
 		(sum * 2 + cell->state));
@@ -538,6 +815,25 @@ sumToDesc(State state, int sum)
 }
 
 
+/*
+ * Change the neighbor sums of the cells around a cell whose state is
+ * changing by the specified amount.  The cells which are set are never
+ * on the boundary, so none of their neighbors is the shared deadCell.
+ */
+static void
+adjustSums(Cell * cell, int delta)
+{
+	cell->cul->sum += delta;
+	cell->cu->sum += delta;
+	cell->cur->sum += delta;
+	cell->cl->sum += delta;
+	cell->cr->sum += delta;
+	cell->cdl->sum += delta;
+	cell->cd->sum += delta;
+	cell->cdr->sum += delta;
+}
+
+
 /*
  * Consistify a cell.
  * This means examine this cell in the previous generation, and
@@ -545,19 +841,26 @@ sumToDesc(State state, int sum)
  * current cell.  Returns ERROR if the cell is inconsistent.
  */
 static Status
-consistify(Cell * cell)
+consistify(Engine * eng, Cell * cell)
 {
 	Cell *	prevCell;
 	int	desc;
 	State	state;
 	Flags	flags;
 
+	eng->stats.consistifies++;
+
 	/*
 	 * If we are searching for parents and this is generation 0, then
 	 * the cell is consistent with respect to the previous generation.
 	 */
-	if (parent && (cell->gen == 0))
+#if PARENT_FLAG
+	if (cell->gen == 0)
 		return OK;
+#else
+	if (eng->parent && (cell->gen == 0))
+		return OK;
+#endif
 
 	/*
 	 * First check the transit table entry for the previous
@@ -568,11 +871,11 @@ consistify(Cell * cell)
 	 */
 	prevCell = cell->past;
 	desc = getDesc(prevCell);
-	state = transit[desc];
+	state = eng->rules->transit[desc];
 
 	if ((state != UNK) && (state != cell->state))
 	{
-		if (setCell(cell, state, FALSE) == ERROR)
+		if (setCell(eng, cell, state, FALSE) == ERROR)
 			return ERROR;
 	}
 
@@ -581,7 +884,7 @@ consistify(Cell * cell)
 	 * If this cell implies anything about the cell or its neighbors
 	 * in the previous generation, then handle that.
 	 */
-	flags = implic[desc];
+	flags = eng->rules->implic[desc];
 
 	if ((flags == 0) || (cell->state == UNK))
 		return OK;
@@ -589,25 +892,25 @@ consistify(Cell * cell)
 	DPRINTF1("Implication flags %x\n", flags);
 
 	if ((flags & N0IC0) && (cell->state == OFF) &&
-		(setCell(prevCell, OFF, FALSE) != OK))
+		(setCell(eng, prevCell, OFF, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((flags & N1IC0) && (cell->state == ON) &&
-		(setCell(prevCell, OFF, FALSE) != OK))
+		(setCell(eng, prevCell, OFF, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((flags & N0IC1) && (cell->state == OFF) &&
-		(setCell(prevCell, ON, FALSE) != OK))
+		(setCell(eng, prevCell, ON, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((flags & N1IC1) && (cell->state == ON) &&
-		(setCell(prevCell, ON, FALSE) != OK))
+		(setCell(eng, prevCell, ON, FALSE) != OK))
 	{
 		return ERROR;
 	}
@@ -642,49 +945,49 @@ consistify(Cell * cell)
 		((state == ON) ? "on" : "off"));
 
 	if ((prevCell->cul->state == UNK) &&
-		(setCell(prevCell->cul, state, FALSE) != OK))
+		(setCell(eng, prevCell->cul, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cu->state == UNK) &&
-		(setCell(prevCell->cu, state, FALSE) != OK))
+		(setCell(eng, prevCell->cu, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cur->state == UNK) &&
-		(setCell(prevCell->cur, state, FALSE) != OK))
+		(setCell(eng, prevCell->cur, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cl->state == UNK) &&
-		(setCell(prevCell->cl, state, FALSE) != OK))
+		(setCell(eng, prevCell->cl, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cr->state == UNK) &&
-		(setCell(prevCell->cr, state, FALSE) != OK))
+		(setCell(eng, prevCell->cr, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cdl->state == UNK) &&
-		(setCell(prevCell->cdl, state, FALSE) != OK))
+		(setCell(eng, prevCell->cdl, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cd->state == UNK) &&
-		(setCell(prevCell->cd, state, FALSE) != OK))
+		(setCell(eng, prevCell->cd, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
 
 	if ((prevCell->cdr->state == UNK) &&
-		(setCell(prevCell->cdr, state, FALSE) != OK))
+		(setCell(eng, prevCell->cdr, state, FALSE) != OK))
 	{
 		return ERROR;
 	}
@@ -695,52 +998,121 @@ consistify(Cell * cell)
 }
 
 
+/*
+ * Consistify a cell which depends on a cell set at the specified time
+ * of the set clock, unless that was already done since then.  Several
+ * cells set in the same wave of settings then have the cells which depend
+ * on all of them consistified once they are all set, instead of once for
+ * each of them.  A consistify which has been undone by backing up needs
+ * no redoing, since the cells it depended on were set before the choice
+ * which was backed up and were all examined before that choice was made.
+ * Cells of generation 0 have no past when looking for parents, so they
+ * are left alone as well.  The parent engine never asks for them.
+ */
+static Status
+consistifyAfter(Engine * eng, Cell * cell, unsigned int time)
+{
+#if PARENT_FLAG
+	if (cell->checkTime >= time)
+		return OK;
+#else
+	if ((cell->checkTime >= time) || (eng->parent && (cell->gen == 0)))
+		return OK;
+#endif
+
+	cell->checkTime = eng->setClock;
+
+	return consistify(eng, cell);
+}
+
+
 /*
  * See if a cell and its neighbors are consistent with the cell and its
  * neighbors in the next generation.
  */
 static Status
-consistify10(Cell * cell)
+consistify10(Engine * eng, Cell * cell)
 {
-	if (consistify(cell) != OK)
+	unsigned int	time;
+
+	time = cell->setTime;
+
+#if PARENT_FLAG
+	/*
+	 * When only looking for parents, cells of generation 0 have no
+	 * past and the cells of the last generation have no future.
+	 */
+	if ((cell->gen != 0) && (consistifyAfter(eng, cell, time) != OK))
 		return ERROR;
 
-	if (consistify(cell->future) != OK)
+	if (cell->gen == eng->genMax - 1)
+		return OK;
+#else
+	if (consistifyAfter(eng, cell, time) != OK)
+		return ERROR;
+#endif
+
+	if (consistifyAfter(eng, cell->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cul->future) != OK)
+	if (consistifyAfter(eng, cell->cul->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cu->future) != OK)
+	if (consistifyAfter(eng, cell->cu->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cur->future) != OK)
+	if (consistifyAfter(eng, cell->cur->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cl->future) != OK)
+	if (consistifyAfter(eng, cell->cl->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cr->future) != OK)
+	if (consistifyAfter(eng, cell->cr->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cdl->future) != OK)
+	if (consistifyAfter(eng, cell->cdl->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cd->future) != OK)
+	if (consistifyAfter(eng, cell->cd->future, time) != OK)
 		return ERROR;
 
-	if (consistify(cell->cdr->future) != OK)
+	if (consistifyAfter(eng, cell->cdr->future, time) != OK)
 		return ERROR;
 
 	return OK;
 }
 
 
+/*
+ * Restart the set clock when it wraps around, so that every cell which
+ * is set looks newer than the last consistify of any cell.
+ */
+static void
+resetClock(Engine * eng)
+{
+	int	i;
+
+	for (i = 0; i < eng->tableCount; i++)
+	{
+		eng->cellTable[i]->setTime = 1;
+		eng->cellTable[i]->checkTime = 0;
+	}
+
+	for (i = 0; i < eng->auxCellCount; i++)
+	{
+		eng->auxTable[i]->setTime = 1;
+		eng->auxTable[i]->checkTime = 0;
+	}
+
+	eng->setClock = 1;
+}
+
+
 /*
  * Examine the next choice of cell settings.
  */
 static Status
-examineNext(void)
+examineNext(Engine * eng)
 {
 	Cell *	cell;
 
@@ -748,25 +1120,27 @@ examineNext(void)
 	 * If there are no more cells to examine, then what we have
 	 * is consistent.
 	 */
-	if (nextSet == newSet)
+	if (eng->nextSet == eng->newSet)
 		return CONSISTENT;
 
 	/*
 	 * Get the next cell to examine, and check it out for symmetry
 	 * and for consistency with its previous and next generations.
 	 */
-	cell = *nextSet++;
+	cell = *eng->nextSet++;
 
 	DPRINTF4("Examining saved cell %d %d %d (%s) for consistency\n",
 		cell->row, cell->col, cell->gen,
 		(cell->free ? "free" : "forced"));
 
-	if (cell->loop && (setCell(cell->loop, cell->state, FALSE) != OK))
+#if !PARENT_FLAG
+	if (cell->loop && (setCell(eng, cell->loop, cell->state, FALSE) != OK))
 	{
 		return ERROR;
 	}
+#endif
 
-	return consistify10(cell);
+	return consistify10(eng, cell);
 }
 
 
@@ -775,19 +1149,27 @@ examineNext(void)
  * can from the choice.  Consequences are a contradiction or a consistency.
  */
 Status
-proceed(Cell * cell, State state, Bool free)
+proceed(Engine * eng, Cell * cell, State state, Bool free)
 {
 	int	status;
 
-	if (setCell(cell, state, free) != OK)
+	if (setCell(eng, cell, state, free) != OK)
+	{
+		eng->conflictCell = cell;
+
 		return ERROR;
+	}
 
 	for (;;)
 	{
-		status = examineNext();
+		status = examineNext(eng);
 
 		if (status == ERROR)
+		{
+			eng->conflictCell = eng->nextSet[-1];
+
 			return ERROR;
+		}
 
 		if (status == CONSISTENT)
 			return OK;
@@ -801,34 +1183,22 @@ proceed(Cell * cell, State state, Bool free)
  * Returns NULL_CELL on an "object cannot exist" error.
  */
 Cell *
-backup(void)
+backup(Engine * eng)
 {
 	Cell *	cell;
 
-	searchList = fullSearchList;
+	eng->searchList = eng->fullSearchList;
 
-	while (newSet != baseSet)
+	while (eng->newSet != eng->baseSet)
 	{
-		cell = *--newSet;
+		cell = *--eng->newSet;
 
 		DPRINTF5("backing up cell %d %d %d, was %s, %s\n",
 			cell->row, cell->col, cell->gen,
 			((cell->state == ON) ? "on" : "off"),
 			(cell->free ? "free": "forced"));
 
-		if ((cell->state == ON) && (cell->gen == 0))
-		{
-			cell->rowInfo->onCount--;
-			cell->colInfo->onCount--;
-			cell->colInfo->sumPos -= cell->row;
-			cellCount--;
-			adjustNear(cell, -1);
-		}
-
-		if ((cell->gen == 0) && (cell->colInfo->setCount == rowMax))
-			fullColumns--;
-
-		cell->colInfo->setCount--;
+		releaseCell(eng, cell);
 
 		if (!cell->free)
 		{
@@ -838,35 +1208,131 @@ backup(void)
 			continue;
 		}
 
-		nextSet = newSet;
+		eng->stats.backtracks++;
+		eng->nextSet = eng->newSet;
+		eng->flipCell = cell;
+		memoRelease(eng, TRUE);
+
+#if PARENT_FLAG
+		/*
+		 * The cells ahead of the search list when this cell was
+		 * chosen are all still set, so there is no need to look
+		 * through them again for the next unknown cell.
+		 */
+		eng->searchList = cell->resume;
+#endif
 
 		return cell;
 	}
 
-	nextSet = baseSet;
+	eng->nextSet = eng->baseSet;
+	eng->flipCell = NULL_CELL;
+	memoRelease(eng, TRUE);
+
 	return NULL_CELL;
 }
 
 
+/*
+ * Undo the counts kept about a cell which is being removed from the
+ * set table.  The state of the cell itself is left alone.
+ */
+static void
+releaseCell(Engine * eng, Cell * cell)
+{
+	if ((cell->state == ON) && (cell->gen == 0))
+	{
+		cell->rowInfo->onCount--;
+		cell->colInfo->onCount--;
+		cell->colInfo->sumPos -= cell->row;
+		eng->cellCount--;
+#if !PARENT_FLAG
+		adjustNear(eng, cell, -1);
+#endif
+	}
+
+	if ((cell->gen == 0) && (cell->colInfo->setCount == eng->rowMax))
+		eng->fullColumns--;
+
+	cell->colInfo->setCount--;
+	adjustSums(cell, UNK - cell->state);
+
+	if (eng->memoTable)
+		eng->memoHash[cell->gen][cell->col] ^=
+			cell->zobrist[cell->state];
+
+	/*
+	 * A cell which becomes unknown again may need to be chosen,
+	 * so put it back into the heap if it was taken out.
+	 */
+	if (cell->heapIndex == HEAP_OUT)
+		heapInsert(eng, cell);
+}
+
+
+/*
+ * Undo the settings of all cells which were set after the specified
+ * position of the set table, whether they were free or forced.
+ */
+void
+undoTo(Engine * eng, Cell ** mark)
+{
+	Cell *	cell;
+
+	while (eng->newSet != mark)
+	{
+		cell = *--eng->newSet;
+		releaseCell(eng, cell);
+		cell->state = UNK;
+		cell->free = TRUE;
+	}
+
+	eng->nextSet = eng->newSet;
+	memoRelease(eng, FALSE);
+}
+
+
 /*
  * Do checking based on setting the specified cell.
  * Returns ERROR if an inconsistency was found.
  */
 Status
-go(Cell * cell, State state, Bool free)
+go(Engine * eng, Cell * cell, State state, Bool free)
 {
 	Status	status;
 
-	quitOk = FALSE;
+	eng->quitOk = FALSE;
 
 	for (;;)
 	{
-		status = proceed(cell, state, free);
+		status = proceed(eng, cell, state, free);
 
 		if (status == OK)
 			return OK;
 
-		cell = backup();
+		eng->stats.conflicts++;
+
+		if (eng->orderDynamic)
+			bumpConflict(eng, eng->conflictCell);
+
+		/*
+		 * A limited search stops just like an interrupted one,
+		 * so that it can be restarted with another order.
+		 */
+		if (eng->conflictLimit &&
+			(eng->stats.conflicts >= eng->conflictLimit))
+		{
+			eng->interrupted = TRUE;
+		}
+
+		/*
+		 * Give up if we were asked to stop, the caller can
+		 * tell this apart from an impossible object.
+		 */
+		if (eng->interrupted)
+			return ERROR;
+
+		cell = backup(eng);
 
 		if (cell == NULL_CELL)
 			return ERROR;
@@ -883,18 +1349,18 @@ go(Cell * cell, State state, Bool free)
  * Returns NULL_CELL if there are no more unknown cells.
  */
 static Cell *
-getNormalUnknown(void)
+getNormalUnknown(Engine * eng)
 {
 	Cell *	cell;
 
-	for (cell = searchList; cell; cell = cell->search)
+	for (cell = eng->searchList; cell; cell = cell->search)
 	{
 		if (!cell->choose)
 			continue;
 
 		if (cell->state == UNK)
 		{
-			searchList = cell;
+			eng->searchList = cell;
 
 			return cell;
 		}
@@ -909,7 +1375,7 @@ getNormalUnknown(void)
  * Returns NULL_CELL if there are no more unknown cells.
  */
 static Cell *
-getAverageUnknown(void)
+getAverageUnknown(Engine * eng)
 {
 	Cell *	cell;
 	Cell *	bestCell;
@@ -922,25 +1388,25 @@ getAverageUnknown(void)
 	bestCell = NULL_CELL;
 	bestDist = -1;
 
-	cell = searchList;
+	cell = eng->searchList;
 
 	while (cell)
 	{
-		searchList = cell;
+		eng->searchList = cell;
 		curCol = cell->col;
 
 		testCol = curCol - 1;
 
-		while ((testCol > 0) && (colInfo[testCol].onCount <= 0))
+		while ((testCol > 0) && (eng->colInfo[testCol].onCount <= 0))
 			testCol--;
 
 		if (testCol > 0)
 		{
-			wantRow = colInfo[testCol].sumPos /
-				colInfo[testCol].onCount;
+			wantRow = eng->colInfo[testCol].sumPos /
+				eng->colInfo[testCol].onCount;
 		}
 		else
-			wantRow = (rowMax + 1) / 2;
+			wantRow = (eng->rowMax + 1) / 2;
 
 		for (; cell && (cell->col == curCol); cell = cell->search)
 		{
@@ -971,19 +1437,278 @@ getAverageUnknown(void)
 
 
 /*
- * Choose a state for an unknown cell, either OFF or ON.
+ * Find another unknown cell when the order is dynamic.
+ * This is the most active unknown cell in the heap.  Cells which have
+ * been set are only taken out of the heap when they reach its top,
+ * and are put back when they are released.
+ * Returns NULL_CELL if there are no more unknown cells.
+ */
+static Cell *
+getActiveUnknown(Engine * eng)
+{
+	Cell *	cell;
+
+	if (!eng->heapReady)
+		initActivity(eng);
+
+	while (eng->heapCount > 0)
+	{
+		cell = eng->heap[0];
+
+		if (cell->choose && (cell->state == UNK))
+			return cell;
+
+		cell->heapIndex = HEAP_OUT;
+
+		if (--eng->heapCount > 0)
+		{
+			eng->heap[0] = eng->heap[eng->heapCount];
+			heapDown(eng, 0);
+		}
+	}
+
+	return NULL_CELL;
+}
+
+
+/*
+ * Fill the heap with the cells of the search list.
+ * This is done when the first cell is wanted, so that the cells set
+ * from the initial file are known.  The starting activity of a cell is
+ * how tightly it is constrained by the next generation, with the usual
+ * search order breaking ties.
+ */
+static void
+initActivity(Engine * eng)
+{
+	Cell *	cell;
+	int	count;
+	int	rank;
+
+	count = 0;
+
+	for (cell = eng->fullSearchList; cell; cell = cell->search)
+		count++;
+
+	rank = 0;
+	eng->heapCount = 0;
+	eng->activityInc = 1.0;
+
+	for (cell = eng->fullSearchList; cell; cell = cell->search)
+	{
+		cell->activity = getTightness(eng, cell) +
+			((double) (count - rank++)) / (count + 1);
+		cell->heapIndex = HEAP_OUT;
+
+		if (cell->choose)
+			heapInsert(eng, cell);
+	}
+
+	eng->heapReady = TRUE;
+}
+
+
+/*
+ * Return how tightly a cell is constrained by the next generation.
+ * Every known cell which the cell is a neighbor of counts, and ON cells
+ * count twice since they allow only a few neighborhoods.
+ */
+static int
+getTightness(Engine * eng, const Cell * cell)
+{
+	Cell *	future;
+	Cell *	block[9];
+	int	tightness;
+	int	i;
+
+	future = cell->future;
+
+	if (future == eng->deadCell)
+		return 0;
+
+	block[0] = future;
+	block[1] = future->cul;
+	block[2] = future->cu;
+	block[3] = future->cur;
+	block[4] = future->cl;
+	block[5] = future->cr;
+	block[6] = future->cdl;
+	block[7] = future->cd;
+	block[8] = future->cdr;
+
+	tightness = 0;
+
+	for (i = 0; i < 9; i++)
+	{
+		if (block[i]->state == ON)
+			tightness += 2;
+		else if (block[i]->state == OFF)
+			tightness++;
+	}
+
+	return tightness;
+}
+
+
+/*
+ * Bump the activity of the cells involved in a conflict found while
+ * examining the specified cell.  These are the cells around it, and the
+ * cells around it in the previous generation which determine it.
+ */
+static void
+bumpConflict(Engine * eng, const Cell * cell)
+{
+	Cell *	curCell;
+
+	if (!eng->heapReady || (cell == NULL_CELL))
+		return;
+
+	bumpBlock(eng, (Cell *) cell);
+
+	if (cell->past != eng->deadCell)
+		bumpBlock(eng, cell->past);
+
+	eng->activityInc /= ACTIVITY_DECAY;
+
+	if (eng->activityInc < ACTIVITY_LIMIT)
+		return;
+
+	for (curCell = eng->fullSearchList; curCell; curCell = curCell->search)
+		curCell->activity /= ACTIVITY_LIMIT;
+
+	eng->activityInc /= ACTIVITY_LIMIT;
+}
+
+
+/*
+ * Bump the activity of a cell and its neighbors, keeping the heap in
+ * order.  Cells which are never searched are left alone.
+ */
+static void
+bumpBlock(Engine * eng, Cell * cell)
+{
+	Cell *	block[9];
+	int	i;
+
+	block[0] = cell;
+	block[1] = cell->cul;
+	block[2] = cell->cu;
+	block[3] = cell->cur;
+	block[4] = cell->cl;
+	block[5] = cell->cr;
+	block[6] = cell->cdl;
+	block[7] = cell->cd;
+	block[8] = cell->cdr;
+
+	for (i = 0; i < 9; i++)
+	{
+		cell = block[i];
+
+		if (cell->heapIndex == HEAP_NEVER)
+			continue;
+
+		cell->activity += eng->activityInc;
+
+		if (cell->heapIndex != HEAP_OUT)
+			heapUp(eng, cell->heapIndex);
+	}
+}
+
+
+/*
+ * Insert a cell into the heap.
+ */
+static void
+heapInsert(Engine * eng, Cell * cell)
+{
+	cell->heapIndex = eng->heapCount;
+	eng->heap[eng->heapCount++] = cell;
+	heapUp(eng, cell->heapIndex);
+}
+
+
+/*
+ * Move the cell at the specified heap position up towards the top
+ * until its parent is at least as active.
+ */
+static void
+heapUp(Engine * eng, int index)
+{
+	Cell *	cell;
+	int	parentIndex;
+
+	cell = eng->heap[index];
+
+	while (index > 0)
+	{
+		parentIndex = (index - 1) / 2;
+
+		if (eng->heap[parentIndex]->activity >= cell->activity)
+			break;
+
+		eng->heap[index] = eng->heap[parentIndex];
+		eng->heap[index]->heapIndex = index;
+		index = parentIndex;
+	}
+
+	eng->heap[index] = cell;
+	cell->heapIndex = index;
+}
+
+
+/*
+ * Move the cell at the specified heap position down towards the bottom
+ * until its children are no more active.
+ */
+static void
+heapDown(Engine * eng, int index)
+{
+	Cell *	cell;
+	int	childIndex;
+
+	cell = eng->heap[index];
+
+	for (;;)
+	{
+		childIndex = index * 2 + 1;
+
+		if (childIndex >= eng->heapCount)
+			break;
+
+		if ((childIndex + 1 < eng->heapCount) &&
+			(eng->heap[childIndex + 1]->activity >
+				eng->heap[childIndex]->activity))
+		{
+			childIndex++;
+		}
+
+		if (cell->activity >= eng->heap[childIndex]->activity)
+			break;
+
+		eng->heap[index] = eng->heap[childIndex];
+		eng->heap[index]->heapIndex = index;
+		index = childIndex;
+	}
+
+	eng->heap[index] = cell;
+	cell->heapIndex = index;
+}
+
+
+/*
+ * Choose a state for an unknown cell, either OFF or ON.
  * Normally, we try to choose OFF cells first to terminate an object.
  * But for follow generations mode, we try to choose the same setting
  * as a nearby generation.
  */
 static State
-choose(const Cell * cell)
+choose(Engine * eng, const Cell * cell)
 {
 	/*
 	 * If we are following cells in other generations,
 	 * then try to do that.
 	 */
-	if (followGens)
+	if (eng->followGens)
 	{
 		if ((cell->past->state == ON) ||
 			(cell->future->state == ON))
@@ -1002,23 +1727,159 @@ choose(const Cell * cell)
 }
 
 
+/*
+ * Look ahead from the specified unknown cell before choosing its state.
+ * Up to lookCells unknown cells in search order, starting with this one,
+ * are tentatively set both OFF and ON.  If one of the states fails, then
+ * the cell is set to the other state.  If both succeed, then the cells
+ * which both states set alike are set that way.  All of these settings
+ * are forced, so they are undone by backing up the current choice.
+ * The cell whose states set the most cells is left as the next choice,
+ * which is NULL_CELL if no unknown cells are left.  Returns ERROR if both
+ * states of some cell fail, so that the current choice must be backed up.
+ */
+static Status
+lookahead(Engine * eng, Cell ** cellPtr)
+{
+	Cell *	cell;
+	Cell *	bestCell;
+	Cell **	mark;
+	Cell **	set;
+	Status	offStatus;
+	Status	onStatus;
+	long	bestScore;
+	long	score;
+	int	offCount;
+	int	branchCount;
+	int	commonCount;
+	int	count;
+	int	i;
+
+	bestCell = NULL_CELL;
+	bestScore = -1;
+	count = 0;
+
+	for (cell = *cellPtr; cell && (count < eng->lookCells);
+		cell = cell->search)
+	{
+		if (!cell->choose || (cell->state != UNK))
+			continue;
+
+		if (eng->interrupted)
+			break;
+
+		count++;
+		mark = eng->newSet;
+
+		/*
+		 * Try the cell OFF, and remember what that set.
+		 */
+		offStatus = proceed(eng, cell, OFF, FALSE);
+		offCount = eng->newSet - mark;
+		branchCount = 0;
+
+		if (offStatus == OK)
+		{
+			for (set = mark; set < eng->newSet; set++)
+			{
+				(*set)->lookState = (*set)->state;
+				eng->branchCells[branchCount++] = *set;
+			}
+		}
+
+		undoTo(eng, mark);
+
+		/*
+		 * Try the cell ON, and collect the cells which were
+		 * also set the same way when it was OFF.
+		 */
+		onStatus = proceed(eng, cell, ON, FALSE);
+		score = (long) (offCount + 1) * (eng->newSet - mark + 1);
+		commonCount = 0;
+
+		if ((offStatus == OK) && (onStatus == OK))
+		{
+			for (set = mark; set < eng->newSet; set++)
+			{
+				if ((*set)->lookState != (*set)->state)
+					continue;
+
+				eng->commonCells[commonCount] = *set;
+				eng->commonStates[commonCount++] =
+					(*set)->state;
+			}
+		}
+
+		undoTo(eng, mark);
+
+		for (i = 0; i < branchCount; i++)
+			eng->branchCells[i]->lookState = UNK;
+
+		if ((offStatus != OK) && (onStatus != OK))
+			return ERROR;
+
+		/*
+		 * If only one state works, then the cell must have it.
+		 */
+		if ((offStatus != OK) || (onStatus != OK))
+		{
+			if (proceed(eng, cell, (offStatus == OK) ? OFF : ON,
+				FALSE) != OK)
+			{
+				return ERROR;
+			}
+
+			continue;
+		}
+
+		for (i = 0; i < commonCount; i++)
+		{
+			if (proceed(eng, eng->commonCells[i],
+				eng->commonStates[i], FALSE) != OK)
+			{
+				return ERROR;
+			}
+		}
+
+		if (score > bestScore)
+		{
+			bestCell = cell;
+			bestScore = score;
+		}
+	}
+
+	/*
+	 * The best cell may have been set by later cells, in which
+	 * case just use the next unknown cell.
+	 */
+	if ((bestCell == NULL_CELL) || (bestCell->state != UNK))
+		bestCell = (*eng->getUnknown)(eng);
+
+	*cellPtr = bestCell;
+
+	return OK;
+}
+
+
 /*
  * The top level search routine.
  * Returns if an object is found, or is impossible.
  */
 Status
-search(void)
+search(Engine * eng)
 {
 	Cell *	cell;
 	Bool	free;
+#if !HEADLESS_FLAG
 	Bool	needWrite;
+#endif
 	State	state;
 
-	cell = (*getUnknown)();
+	cell = (*eng->getUnknown)(eng);
 
 	if (cell == NULL_CELL)
 	{
-		cell = backup();
+		cell = backup(eng);
 
 		if (cell == NULL_CELL)
 			return ERROR;
@@ -1029,8 +1890,9 @@ search(void)
 	}
 	else
 	{
-		state = choose(cell);
+		state = choose(eng, cell);
 		free = TRUE;
+		eng->stats.decisions++;
 	}
 
 	for (;;)
@@ -1038,18 +1900,38 @@ search(void)
 		/*
 		 * Set the state of the new cell.
 		 */
-		if (go(cell, state, free) != OK)
-			return NOT_EXIST;
+		if (go(eng, cell, state, free) != OK)
+			return (eng->interrupted ? ERROR : NOT_EXIST);
+
+		if (eng->interrupted)
+			return ERROR;
 
 		/*
 		 * If it is time to dump our state, then do that.
 		 */
-		if (dumpFreq && (++dumpcount >= dumpFreq))
+		if (eng->dumpFreq && (++eng->dumpcount >= eng->dumpFreq))
 		{
-			dumpcount = 0;
-			dumpState(dumpFile);
+			eng->dumpcount = 0;
+			dumpState(eng, eng->dumpFile);
 		}
 
+#if HEADLESS_FLAG
+		/*
+		 * Every so often see whether to report our progress.
+		 */
+		if (eng->progressFreq &&
+			(++eng->progressCount >= PROGRESS_CHECK))
+		{
+			eng->progressCount = 0;
+			reportProgress(eng);
+		}
+#else
+		/*
+		 * Headless builds have nobody to show progress to or take
+		 * commands from, so all of the following is left out of
+		 * the loop for them.
+		 */
+
 		/*
 		 * If we have enough columns found, then remember to
 		 * write it to the output file.  Also keep the last
@@ -1057,23 +1939,25 @@ search(void)
 		 */
 		needWrite = FALSE;
 
-		if (outputCols &&
-			(fullColumns >= outputLastCols + outputCols))
+		if (eng->outputCols &&
+			(eng->fullColumns >=
+				eng->outputLastCols + eng->outputCols))
 		{
-			outputLastCols = fullColumns;
+			eng->outputLastCols = eng->fullColumns;
 			needWrite = TRUE;
 		}
 
-		if (outputLastCols > fullColumns)
-			outputLastCols = fullColumns;
+		if (eng->outputLastCols > eng->fullColumns)
+			eng->outputLastCols = eng->fullColumns;
 
 		/*
 		 * If it is time to view the progress,then show it.
 		 */
-		if (needWrite || (viewFreq && (++viewCount >= viewFreq)))
+		if (needWrite || (eng->viewFreq &&
+			(++eng->viewCount >= eng->viewFreq)))
 		{
-			viewCount = 0;
-			printGen(curGen);
+			eng->viewCount = 0;
+			printGen(eng, eng->curGen);
 		}
 
 		/*
@@ -1082,25 +1966,472 @@ search(void)
 		 * message will stay visible for a while.
 		 */
 		if (needWrite)
-			writeGen(outputFile, TRUE);
+			writeGen(eng, eng->outputFile, TRUE);
 
 		/*
 		 * Check for commands.
 		 */
 		if (ttyCheck())
-			getCommands();
+			getCommands(eng);
+#endif
+
+		/*
+		 * If the columns set so far lead to a frontier which
+		 * was already searched in vain, then back up as if the
+		 * last choice had failed.
+		 */
+		if (eng->memoTable && (memoCheck(eng) != OK))
+		{
+			eng->stats.conflicts++;
+			cell = backup(eng);
+
+			if (cell == NULL_CELL)
+				return (eng->interrupted ? ERROR : NOT_EXIST);
+
+			free = FALSE;
+			state = 1 - cell->state;
+			cell->state = UNK;
+
+			continue;
+		}
+
+		/*
+		 * If the cells set so far are those of a nogood, then
+		 * back up in the same way.
+		 */
+		if (eng->nogoodCount && (nogoodCheck(eng) != OK))
+		{
+			eng->stats.conflicts++;
+			cell = backup(eng);
+
+			if (cell == NULL_CELL)
+				return (eng->interrupted ? ERROR : NOT_EXIST);
+
+			free = FALSE;
+			state = 1 - cell->state;
+			cell->state = UNK;
+
+			continue;
+		}
 
 		/*
 		 * Get the next unknown cell and choose its state.
 		 */
-		cell = (*getUnknown)();
+		cell = (*eng->getUnknown)(eng);
 
 		if (cell == NULL_CELL)
+		{
+			memoFound(eng);
+
 			return FOUND;
+		}
+
+		/*
+		 * If looking ahead shows that the cells set so far
+		 * cannot work, then back up as if the last choice
+		 * had failed.
+		 */
+		if (eng->lookCells && (lookahead(eng, &cell) != OK))
+		{
+			eng->stats.conflicts++;
+			cell = backup(eng);
+
+			if (cell == NULL_CELL)
+				return (eng->interrupted ? ERROR : NOT_EXIST);
+
+			free = FALSE;
+			state = 1 - cell->state;
+			cell->state = UNK;
 
-		state = choose(cell);
+			continue;
+		}
+
+		if (cell == NULL_CELL)
+		{
+			memoFound(eng);
+
+			return FOUND;
+		}
+
+		state = choose(eng, cell);
 		free = TRUE;
+		eng->stats.decisions++;
+	}
+}
+
+
+/*
+ * Estimate the part of the search tree which has been searched, taking
+ * each choice to split the rest of the tree into halves.  A choice set
+ * to its other state has the half of its first state searched.
+ * Returns a value between 0 and 1.
+ */
+double
+searchProgress(Engine * eng)
+{
+	Cell **	set;
+	double	size;
+	double	done;
+
+	size = 1.0;
+	done = 0.0;
+
+	for (set = eng->baseSet; set != eng->newSet; set++)
+	{
+		if ((*set)->free)
+			size /= 2;
+		else if ((*set)->flipped)
+		{
+			size /= 2;
+			done += size;
+		}
+	}
+
+	return done;
+}
+
+
+/*
+ * Set up the frontier memo if it was asked for, and forget everything
+ * it knew.  The memo is only used to look for parents without any
+ * symmetry or other condition which ties columns together, since it
+ * relies on the cells of the other generations being known from the
+ * full columns of generation 0 and on nothing else depending on them.
+ */
+static void
+initMemo(Engine * eng)
+{
+	free(eng->memoTable);
+	eng->memoTable = NULL;
+	memset(eng->memoHash, 0, sizeof(eng->memoHash));
+	eng->frontierCount = 0;
+
+	if ((eng->memoSize <= 0) || !eng->parent || eng->rowSym ||
+		eng->colSym || eng->pointSym || eng->fwdSym ||
+		eng->bwdSym || eng->useCol || eng->nearCols ||
+		eng->colWidth)
+	{
+		return;
+	}
+
+	eng->memoTable = (MemoEntry *) calloc(eng->memoSize,
+		sizeof(MemoEntry));
+
+	if (eng->memoTable == NULL)
+		failEngine(eng, "Cannot allocate frontier memo");
+}
+
+
+/*
+ * Find the memo entry holding a frontier, or else the entry to replace
+ * with it, which is an unused one if there is any.
+ */
+static MemoEntry *
+memoFind(Engine * eng, unsigned long key)
+{
+	MemoEntry *	entry;
+	MemoEntry *	best;
+	int		i;
+
+	best = NULL;
+
+	for (i = 0; i < MEMO_PROBES; i++)
+	{
+		entry = &eng->memoTable[(key + i) % eng->memoSize];
+
+		if ((entry->key == key) || (entry->key == 0))
+			return entry;
+
+		if ((best == NULL) || (entry->room < best->room))
+			best = entry;
+	}
+
+	return best;
+}
+
+
+/*
+ * Check whether more columns of generation 0 became full, and if so
+ * look up the frontier they lead to.  Returns ERROR if it is known to
+ * have no object with as many cells left to use, and otherwise starts
+ * remembering it as being searched.
+ */
+static Status
+memoCheck(Engine * eng)
+{
+	Frontier *	frontier;
+	MemoEntry *	entry;
+	unsigned long	key;
+	int		col;
+	int		gen;
+	int		room;
+	int		i;
+
+	col = eng->frontierCount ?
+		eng->frontiers[eng->frontierCount - 1].col : 1;
+
+	while ((col <= eng->colMax) &&
+		(eng->colInfo[col].setCount == eng->rowMax))
+		col++;
+
+	if ((col == 1) || (col > eng->colMax) ||
+		(eng->frontierCount &&
+			(col == eng->frontiers[eng->frontierCount - 1].col)))
+	{
+		return OK;
+	}
+
+	key = (unsigned long) col;
+
+	for (i = (col > 2) ? col - 2 : 1; i <= eng->colMax; i++)
+		key ^= eng->memoHash[0][i];
+
+	for (gen = 1; gen < eng->genMax; gen++)
+	{
+		for (i = 1; i <= eng->colMax; i++)
+			key ^= eng->memoHash[gen][i];
+	}
+
+	if (key == 0)
+		key = 1;
+
+	room = eng->maxCount ? (eng->maxCount - eng->cellCount) :
+		(ROW_MAX * COL_MAX);
+	entry = memoFind(eng, key);
+
+	if ((entry->key == key) && (entry->room >= room))
+		return ERROR;
+
+	frontier = &eng->frontiers[eng->frontierCount++];
+	frontier->mark = eng->newSet;
+	frontier->key = key;
+	frontier->col = col;
+	frontier->room = room;
+	frontier->found = FALSE;
+
+	return OK;
+}
+
+
+/*
+ * Stop remembering the frontiers which were reached after the current
+ * position of the set table.  If they were backed up over because they
+ * failed, then they are added to the memo.
+ */
+static void
+memoRelease(Engine * eng, Bool failed)
+{
+	Frontier *	frontier;
+	MemoEntry *	entry;
+
+	while (eng->frontierCount &&
+		(eng->frontiers[eng->frontierCount - 1].mark > eng->newSet))
+	{
+		frontier = &eng->frontiers[--eng->frontierCount];
+
+		if (!failed || frontier->found)
+			continue;
+
+		entry = memoFind(eng, frontier->key);
+
+		if ((entry->key == frontier->key) &&
+			(entry->room >= frontier->room))
+		{
+			continue;
+		}
+
+		entry->key = frontier->key;
+		entry->room = frontier->room;
+	}
+}
+
+
+/*
+ * Note that an object was found, so that the frontiers leading to it
+ * are not taken as failed if the search goes on for another one.
+ */
+static void
+memoFound(Engine * eng)
+{
+	int	i;
+
+	for (i = 0; i < eng->frontierCount; i++)
+		eng->frontiers[i].found = TRUE;
+}
+
+
+/*
+ * Add a nogood, which is a setting of cells that no object may have all
+ * of.  This turns the frontier memo off, since a frontier could then
+ * fail because of cells to the left of it which its key leaves out.
+ * Returns ERROR with the reason left in the engine's error if there are
+ * too many nogoods or cells.
+ */
+Status
+addNogood(Engine * eng, Cell ** cells, const State * states, int count)
+{
+	int	nogood;
+
+	if (eng->nogoodCount >= NOGOOD_MAX)
+	{
+		failEngine(eng, "Too many nogoods");
+
+		return ERROR;
+	}
+
+	if ((count <= 0) || (count > NOGOOD_SIZE))
+	{
+		failEngine(eng, "Bad number of nogood cells");
+
+		return ERROR;
 	}
+
+	nogood = eng->nogoodCount++;
+	memcpy(eng->nogoodCells[nogood], cells, count * sizeof(Cell *));
+	memcpy(eng->nogoodStates[nogood], states, count * sizeof(State));
+	eng->nogoodSizes[nogood] = count;
+
+	free(eng->memoTable);
+	eng->memoTable = NULL;
+	eng->frontierCount = 0;
+
+	return OK;
+}
+
+
+/*
+ * Check whether the cells of any nogood are all set to its states.
+ * Returns ERROR if so, and OK otherwise.
+ */
+static Status
+nogoodCheck(Engine * eng)
+{
+	int	nogood;
+	int	i;
+
+	for (nogood = 0; nogood < eng->nogoodCount; nogood++)
+	{
+		for (i = 0; i < eng->nogoodSizes[nogood]; i++)
+		{
+			if (eng->nogoodCells[nogood][i]->state !=
+				eng->nogoodStates[nogood][i])
+			{
+				break;
+			}
+		}
+
+		if (i == eng->nogoodSizes[nogood])
+			return ERROR;
+	}
+
+	return OK;
+}
+
+
+/*
+ * Split the search into cubes, which are settings of a few cells that
+ * between them cover every object.  The cells are chosen by looking
+ * ahead, and each cube is written as a line of "row col gen state"
+ * numbers.  Cubes which looking ahead shows to be inconsistent are left
+ * out.  Returns FOUND if an object was found while splitting, leaving it
+ * set, NOT_EXIST if no cube is left, ERROR if the split was interrupted,
+ * and OK otherwise.  The number of cubes written is stored in countPtr.
+ */
+Status
+splitSearch(Engine * eng, int cells, FILE * fp, long * countPtr)
+{
+	Status	status;
+
+	*countPtr = 0;
+
+	status = splitCube(eng, 0, cells, fp, countPtr);
+
+	if ((status == OK) && (*countPtr == 0))
+		return NOT_EXIST;
+
+	return status;
+}
+
+
+/*
+ * Split the search below the cells set so far, which are the first
+ * depth cells of the cube.
+ */
+static Status
+splitCube(Engine * eng, int depth, int cells, FILE * fp, long * countPtr)
+{
+	Cell *	cell;
+	Cell **	mark;
+	Cell **	branchMark;
+	Status	status;
+	State	state;
+	int	i;
+
+	if (eng->interrupted)
+		return ERROR;
+
+	mark = eng->newSet;
+	cell = (*eng->getUnknown)(eng);
+
+	if (cell && (lookahead(eng, &cell) != OK))
+	{
+		undoTo(eng, mark);
+		eng->searchList = eng->fullSearchList;
+
+		return OK;
+	}
+
+	if (cell == NULL_CELL)
+		return FOUND;
+
+	if (depth >= cells)
+	{
+		for (i = 0; i < depth; i++)
+		{
+			fprintf(fp, "%s%d %d %d %d", (i ? " " : ""),
+				eng->cubeCells[i]->row, eng->cubeCells[i]->col,
+				eng->cubeCells[i]->gen, eng->cubeStates[i]);
+		}
+
+		fputc('\n', fp);
+		(*countPtr)++;
+		undoTo(eng, mark);
+		eng->searchList = eng->fullSearchList;
+
+		return OK;
+	}
+
+	/*
+	 * Both states of the chosen cell are tried on top of what
+	 * looking ahead has set.
+	 */
+	branchMark = eng->newSet;
+
+	for (state = OFF; state <= ON; state++)
+	{
+		eng->cubeCells[depth] = cell;
+		eng->cubeStates[depth] = state;
+
+		if (proceed(eng, cell, state, FALSE) == OK)
+		{
+			status = splitCube(eng, depth + 1, cells, fp,
+				countPtr);
+
+			if (status != OK)
+				return status;
+		}
+
+		/*
+		 * Unlike backing up, this can leave unknown cells ahead
+		 * of the search list.
+		 */
+		undoTo(eng, branchMark);
+		eng->searchList = eng->fullSearchList;
+	}
+
+	undoTo(eng, mark);
+
+	return OK;
 }
 
 
@@ -1111,28 +2442,32 @@ search(void)
  * quick test can be made to see if a cell is within range of another one.
  */
 void
-adjustNear(Cell * cell, int inc)
+adjustNear(Engine * eng, Cell * cell, int inc)
 {
 	Cell *	curCell;
 	int	count;
 	int	colCount;
 
-	for (colCount = nearCols; colCount > 0; colCount--)
+	for (colCount = eng->nearCols; colCount > 0; colCount--)
 	{
 		cell = cell->cr;
 		curCell = cell;
 
-		for (count = nearCols; count-- >= 0; curCell = curCell->cu)
+		for (count = eng->nearCols; count-- >= 0;
+			curCell = curCell->cu)
+		{
 			curCell->near += inc;
+		}
 
 		curCell = cell->cd;
 
-		for (count = nearCols; count-- > 0; curCell = curCell->cd)
+		for (count = eng->nearCols; count-- > 0; curCell = curCell->cd)
 			curCell->near += inc;
 	}
 }
 
 
+#if !PARENT_FLAG
 /*
  * Check to see if setting the specified cell ON would make the width of
  * the column exceed the allowed value.  For symmetric objects, the width
@@ -1140,7 +2475,7 @@ adjustNear(Cell * cell, int inc)
  * would exceed the value.
  */
 static Bool
-checkWidth(const Cell * cell)
+checkWidth(Engine * eng, const Cell * cell)
 {
 	int		left;
 	int		width;
@@ -1152,7 +2487,7 @@ checkWidth(const Cell * cell)
 	const Cell *	dcp;
 	Bool		full;
 
-	if (!colWidth || !inited || cell->gen)
+	if (!eng->colWidth || !eng->inited || cell->gen)
 		return FALSE;
 
 	left = cell->colInfo->onCount;
@@ -1162,23 +2497,23 @@ checkWidth(const Cell * cell)
 
 	ucp = cell;
 	dcp = cell;
-	width = colWidth;
+	width = eng->colWidth;
 	minRow = cell->row;
 	maxRow = cell->row;
 	srcMinRow = 1;
-	srcMaxRow = rowMax;
+	srcMaxRow = eng->rowMax;
 	full = TRUE;
 
-	if ((rowSym && (cell->col >= rowSym)) ||
-		(flipRows && (cell->col >= flipRows)))
+	if ((eng->rowSym && (cell->col >= eng->rowSym)) ||
+		(eng->flipRows && (cell->col >= eng->flipRows)))
 	{
 		full = FALSE;
-		srcMaxRow = (rowMax + 1) / 2;
+		srcMaxRow = (eng->rowMax + 1) / 2;
 
 		if (cell->row > srcMaxRow)
 		{
-			srcMinRow = (rowMax / 2) + 1;
-			srcMaxRow = rowMax;
+			srcMinRow = (eng->rowMax / 2) + 1;
+			srcMaxRow = eng->rowMax;
 		}
 	}
 
@@ -1207,11 +2542,12 @@ checkWidth(const Cell * cell)
 		}
 	}
 
-	if (maxRow - minRow >= colWidth)
+	if (maxRow - minRow >= eng->colWidth)
 		return TRUE;
 
 	return FALSE;
 }
+#endif
 
 
 /*
@@ -1221,7 +2557,7 @@ checkWidth(const Cell * cell)
  * Returns TRUE if there is an identical generation.
  */
 Bool
-subPeriods(void)
+subPeriods(Engine * eng)
 {
 	int		row;
 	int		col;
@@ -1229,17 +2565,17 @@ subPeriods(void)
 	const Cell *	cellG0;
 	const Cell *	cellGn;
 
-	for (gen = 1; gen < genMax; gen++)
+	for (gen = 1; gen < eng->genMax; gen++)
 	{
-		if (genMax % gen)
+		if (eng->genMax % gen)
 			continue;
 
-		for (row = 1; row <= rowMax; row++)
+		for (row = 1; row <= eng->rowMax; row++)
 		{
-			for (col = 1; col <= colMax; col++)
+			for (col = 1; col <= eng->colMax; col++)
 			{
-				cellG0 = findCell(row, col, 0);
-				cellGn = findCell(row, col, gen);
+				cellG0 = findCell(eng, row, col, 0);
+				cellGn = findCell(eng, row, col, gen);
 
 				if (cellG0->state != cellGn->state)
 					goto nextGen;
@@ -1261,7 +2597,7 @@ nextGen:;
  * called for cells belonging to those two generations.
  */
 static Cell *
-mapCell(const Cell * cell, Bool forward)
+mapCell(Engine * eng, const Cell * cell, Bool forward)
 {
 	int	row;
 	int	col;
@@ -1270,34 +2606,34 @@ mapCell(const Cell * cell, Bool forward)
 	row = cell->row;
 	col = cell->col;
 
-	if (flipRows && (col >= flipRows))
-		row = rowMax + 1 - row;
+	if (eng->flipRows && (col >= eng->flipRows))
+		row = eng->rowMax + 1 - row;
 
-	if (flipCols && (row >= flipCols))
-		col = colMax + 1 - col;
+	if (eng->flipCols && (row >= eng->flipCols))
+		col = eng->colMax + 1 - col;
 
-	if (flipQuads)
+	if (eng->flipQuads)
 	{				/* NEED TO GO BACKWARDS */
 		tmp = col;
 		col = row;
-		row = colMax + 1 - tmp;
+		row = eng->colMax + 1 - tmp;
 	}
 
 	if (forward)
 	{
-		row += rowTrans;
-		col += colTrans;
+		row += eng->rowTrans;
+		col += eng->colTrans;
 	}
 	else
 	{
-		row -= rowTrans;
-		col -= colTrans;
+		row -= eng->rowTrans;
+		col -= eng->colTrans;
 	}
 
 	if (forward)
-		return findCell(row, col, 0);
+		return findCell(eng, row, col, 0);
 	else
-		return findCell(row, col, genMax - 1);
+		return findCell(eng, row, col, eng->genMax - 1);
 }
 
 
@@ -1309,7 +2645,7 @@ mapCell(const Cell * cell, Bool forward)
  * If any cells in the loop are frozen, then they all are.
  */
 void
-loopCells(Cell * cell1, Cell * cell2)
+loopCells(Engine * eng, Cell * cell1, Cell * cell2)
 {
 	Cell *	cell;
 	Bool	frozen;
@@ -1318,8 +2654,12 @@ loopCells(Cell * cell1, Cell * cell2)
 	 * Check simple cases of equality, or of either cell
 	 * being the deadCell.
 	 */
-	if ((cell1 == deadCell) || (cell2 == deadCell))
-		fatal("Attemping to use deadCell in a loop");
+	if ((cell1 == eng->deadCell) || (cell2 == eng->deadCell))
+	{
+		failEngine(eng, "Attemping to use deadCell in a loop");
+
+		return;
+	}
 
 	if (cell1 == cell2)
 		return;
@@ -1385,44 +2725,47 @@ loopCells(Cell * cell1, Cell * cell2)
  * Returns NULL_CELL if there is no symmetry.
  */
 static Cell *
-symCell(const Cell * cell)
+symCell(Engine * eng, const Cell * cell)
 {
 	int	row;
 	int	col;
 	int	nRow;
 	int	nCol;
 
-	if (!rowSym && !colSym && !pointSym && !fwdSym && !bwdSym)
+	if (!eng->rowSym && !eng->colSym && !eng->pointSym &&
+		!eng->fwdSym && !eng->bwdSym)
+	{
 		return NULL_CELL;
+	}
 
 	row = cell->row;
 	col = cell->col;
-	nRow = rowMax + 1 - row;
-	nCol = colMax + 1 - col;
+	nRow = eng->rowMax + 1 - row;
+	nCol = eng->colMax + 1 - col;
 
 	/*
 	 * If this is point symmetry, then this is easy.
 	 */
-	if (pointSym)
-		return findCell(nRow, nCol, cell->gen);
+	if (eng->pointSym)
+		return findCell(eng, nRow, nCol, cell->gen);
 
 	/*
 	 * If there is symmetry on only one axis, then this is easy.
 	 */
-	if (!colSym)
+	if (!eng->colSym)
 	{
-		if (col < rowSym)
+		if (col < eng->rowSym)
 			return NULL_CELL;
 
-		return findCell(nRow, col, cell->gen);
+		return findCell(eng, nRow, col, cell->gen);
 	}
 
-	if (!rowSym)
+	if (!eng->rowSym)
 	{
-		if (row < colSym)
+		if (row < eng->colSym)
 			return NULL_CELL;
 
-		return findCell(row, nCol, cell->gen);
+		return findCell(eng, row, nCol, cell->gen);
 	}
 
 	/*
@@ -1431,7 +2774,7 @@ symCell(const Cell * cell)
 	 * and if so, then this is easy.
 	 */
 	if ((nRow == row) || (nCol == col))
-		return findCell(nRow, nCol, cell->gen);
+		return findCell(eng, nRow, nCol, cell->gen);
 
 	/*
 	 * The cell is really in one of the four quadrants, and therefore
@@ -1439,9 +2782,9 @@ symCell(const Cell * cell)
 	 * symmetrical cell in the next quadrant clockwise.
 	 */
 	if ((row < nRow) == (col < nCol))
-		return findCell(row, nCol, cell->gen);
+		return findCell(eng, row, nCol, cell->gen);
 	else
-		return findCell(nRow, col, cell->gen);
+		return findCell(eng, nRow, col, cell->gen);
 }
 
 
@@ -1450,7 +2793,7 @@ symCell(const Cell * cell)
  * link those neighbors back to this cell.
  */
 static void
-linkCell(Cell * cell)
+linkCell(Engine * eng, Cell * cell)
 {
 	int	row;
 	int	col;
@@ -1461,35 +2804,35 @@ linkCell(Cell * cell)
 	col = cell->col;
 	gen = cell->gen;
 
-	pairCell = findCell(row - 1, col - 1, gen);
+	pairCell = findCell(eng, row - 1, col - 1, gen);
 	cell->cul = pairCell;
 	pairCell->cdr = cell;
 
-	pairCell = findCell(row - 1, col, gen);
+	pairCell = findCell(eng, row - 1, col, gen);
 	cell->cu = pairCell;
 	pairCell->cd = cell;
 
-	pairCell = findCell(row - 1, col + 1, gen);
+	pairCell = findCell(eng, row - 1, col + 1, gen);
 	cell->cur = pairCell;
 	pairCell->cdl = cell;
 
-	pairCell = findCell(row, col - 1, gen);
+	pairCell = findCell(eng, row, col - 1, gen);
 	cell->cl = pairCell;
 	pairCell->cr = cell;
 
-	pairCell = findCell(row, col + 1, gen);
+	pairCell = findCell(eng, row, col + 1, gen);
 	cell->cr = pairCell;
 	pairCell->cl = cell;
 
-	pairCell = findCell(row + 1, col - 1, gen);
+	pairCell = findCell(eng, row + 1, col - 1, gen);
 	cell->cdl = pairCell;
 	pairCell->cur = cell;
 
-	pairCell = findCell(row + 1, col, gen);
+	pairCell = findCell(eng, row + 1, col, gen);
 	cell->cd = pairCell;
 	pairCell->cu = cell;
 
-	pairCell = findCell(row + 1, col + 1, gen);
+	pairCell = findCell(eng, row + 1, col + 1, gen);
 	cell->cdr = pairCell;
 	pairCell->cul = cell;
 }
@@ -1503,7 +2846,7 @@ linkCell(Cell * cell)
  * and are dynamically created as necessary.
  */
 Cell *
-findCell(int row, int col, int gen)
+findCell(Engine * eng, int row, int col, int gen)
 {
 	Cell *	cell;
 	int	i;
@@ -1511,19 +2854,20 @@ findCell(int row, int col, int gen)
 	/*
 	 * If the cell is a normal cell, then we know where it is.
 	 */
-	if ((row >= 0) && (row <= rowMax + 1) &&
-		(col >= 0) && (col <= colMax + 1) &&
-		(gen >= 0) && (gen < genMax))
+	if ((row >= 0) && (row <= eng->rowMax + 1) &&
+		(col >= 0) && (col <= eng->colMax + 1) &&
+		(gen >= 0) && (gen < eng->genMax))
 	{
-		return cellTable[(col * (rowMax + 2) + row) * genMax + gen];
+		return eng->cellTable[(col * (eng->rowMax + 2) + row) *
+			eng->genMax + gen];
 	}
 
 	/*
 	 * See if the cell is already allocated in the auxillary table.
 	 */
-	for (i = 0; i < auxCellCount; i++)
+	for (i = 0; i < eng->auxCellCount; i++)
 	{
-		cell = auxTable[i];
+		cell = eng->auxTable[i];
 
 		if ((cell->row == row) && (cell->col == col) &&
 			(cell->gen == gen))
@@ -1535,17 +2879,24 @@ findCell(int row, int col, int gen)
 	/*
 	 * Need to allocate the cell and add it to the auxillary table.
 	 */
-	if (auxCellCount >= AUX_CELLS)
-		fatal("Too many auxillary cells");
+	if (eng->auxCellCount >= AUX_CELLS)
+	{
+		failEngine(eng, "Too many auxillary cells");
+
+		return eng->deadCell;
+	}
+
+	cell = allocateCell(eng);
 
-	cell = allocateCell();
+	if (cell == eng->deadCell)
+		return cell;
 	cell->row = row;
 	cell->col = col;
 	cell->gen = gen;
-	cell->rowInfo = &dummyRowInfo;
-	cell->colInfo = &dummyColInfo;
+	cell->rowInfo = &eng->dummyRowInfo;
+	cell->colInfo = &eng->dummyColInfo;
 
-	auxTable[auxCellCount++] = cell;
+	eng->auxTable[eng->auxCellCount++] = cell;
 
 	return cell;
 }
@@ -1555,65 +2906,112 @@ findCell(int row, int col, int gen)
  * Allocate a new cell.
  * The cell is initialized as if it was a boundary cell.
  * Warning: The first allocation MUST be of the deadCell.
+ * If no cell can be allocated, the engine fails and deadCell is
+ * returned instead, which is NULL for the first allocation.
  */
 static Cell *
-allocateCell(void)
+allocateCell(Engine * eng)
 {
 	Cell *	cell;
 
 	/*
 	 * Allocate a new chunk of cells if there are none left.
 	 */
-	if (newCellCount <= 0)
+	if (eng->newCellCount <= 0)
 	{
-		newCells = (Cell *) malloc(sizeof(Cell) * ALLOC_SIZE);
+		if (eng->chunkCount >= CHUNK_MAX)
+		{
+			failEngine(eng, "Too many cell structures");
+
+			return eng->deadCell;
+		}
 
-		if (newCells == NULL)
-			fatal("Cannot allocate cell structure");
+		eng->newCells = (Cell *) malloc(sizeof(Cell) * ALLOC_SIZE);
 
-		newCellCount = ALLOC_SIZE;
+		if (eng->newCells == NULL)
+		{
+			failEngine(eng, "Cannot allocate cell structure");
+
+			return eng->deadCell;
+		}
+
+		eng->chunks[eng->chunkCount++] = eng->newCells;
+		eng->newCellCount = ALLOC_SIZE;
 	}
 
-	newCellCount--;
-	cell = newCells++;
+	eng->newCellCount--;
+	cell = eng->newCells++;
 
 	/*
 	 * If this is the first allocation, then make deadCell be this cell.
 	 */
-	if (deadCell == NULL)
-		deadCell = cell;
+	if (eng->deadCell == NULL)
+		eng->deadCell = cell;
 
 	/*
 	 * Fill in the cell as if it was a boundary cell.
 	 */
 	cell->state = OFF;
+	cell->lookState = UNK;
+	cell->heapIndex = HEAP_NEVER;
+	cell->activity = 0.0;
+	cell->sum = 0;
+	cell->setTime = 0;
+	cell->checkTime = 0;
 	cell->free = FALSE;
 	cell->frozen = FALSE;
 	cell->choose = TRUE;
 	cell->gen = -1;
 	cell->row = -1;
 	cell->col = -1;
-	cell->past = deadCell;
-	cell->future = deadCell;
-	cell->cul = deadCell;
-	cell->cu = deadCell;
-	cell->cur = deadCell;
-	cell->cl = deadCell;
-	cell->cr = deadCell;
-	cell->cdl = deadCell;
-	cell->cd = deadCell;
-	cell->cdr = deadCell;
+	cell->past = eng->deadCell;
+	cell->future = eng->deadCell;
+	cell->cul = eng->deadCell;
+	cell->cu = eng->deadCell;
+	cell->cur = eng->deadCell;
+	cell->cl = eng->deadCell;
+	cell->cr = eng->deadCell;
+	cell->cdl = eng->deadCell;
+	cell->cd = eng->deadCell;
+	cell->cdr = eng->deadCell;
 	cell->loop = NULL;
 
 	return cell;
 }
 
 
+/*
+ * Free all of the cells which were allocated.
+ */
+static void
+freeCells(Engine * eng)
+{
+	while (eng->chunkCount > 0)
+		free(eng->chunks[--eng->chunkCount]);
+
+	eng->newCellCount = 0;
+	eng->auxCellCount = 0;
+	eng->newCells = NULL;
+	eng->deadCell = NULL;
+}
+
+
+/*
+ * Initialize the tables of the rules whose born and live rules are set.
+ */
+void
+initRules(Rules * rules)
+{
+	initTransit(rules);
+	initImplic(rules);
+}
+
+
 /*
  * Initialize the implication table.
  */
 static void
-initImplic(void)
+initImplic(Rules * rules)
 {
 	State	state;
 	int	offCount;
@@ -1633,8 +3031,8 @@ initImplic(void)
 				sum = onCount + (8 - onCount - offCount) * UNK;
 				desc = sumToDesc(state, sum);
 
-				implic[desc] =
-					implication(state, offCount, onCount);
+				rules->implic[desc] = implication(rules,
+					state, offCount, onCount);
 			}
 		}
 	}
@@ -1645,7 +3043,7 @@ initImplic(void)
  * Initialize the transition table.
  */
 static void
-initTransit(void)
+initTransit(Rules * rules)
 {
 	int	state;
 	int	offCount;
@@ -1665,8 +3063,8 @@ initTransit(void)
 				sum = onCount + (8 - onCount - offCount) * UNK;
 				desc = sumToDesc(state, sum);
 
-				transit[desc] =
-					transition(state, offCount, onCount);
+				rules->transit[desc] = transition(rules,
+					state, offCount, onCount);
 			}
 		}
 	}
@@ -1677,19 +3075,22 @@ initTransit(void)
  * Return the next state if all neighbors are known.
  */
 static State
-nextState(State state, int onCount)
+nextState(const Rules * rules, State state, int onCount)
 {
 	switch (state)
 	{
 		case ON:
-			return liveRules[onCount];
+			return rules->liveRules[onCount];
 
 		case OFF:
-			return bornRules[onCount];
+			return rules->bornRules[onCount];
 
 		case UNK:
-			if (bornRules[onCount] == liveRules[onCount])
-				return bornRules[onCount];
+			if (rules->bornRules[onCount] ==
+				rules->liveRules[onCount])
+			{
+				return rules->bornRules[onCount];
+			}
 
 			/* fall into default case */
 
@@ -1704,7 +3105,7 @@ nextState(State state, int onCount)
  * The unknown neighbor count is implicit since there are eight neighbors.
  */
 static State
-transition(State state, int offCount, int onCount)
+transition(const Rules * rules, State state, int offCount, int onCount)
 {
 	Bool	onAlways;
 	Bool	offAlways;
@@ -1717,7 +3118,7 @@ transition(State state, int offCount, int onCount)
  
 	for (i = 0; i <= unkCount; i++)
 	{
-		switch (nextState(state, onCount + i))
+		switch (nextState(rules, state, onCount + i))
 		{
 			case ON:
 				offAlways = FALSE;
@@ -1747,7 +3148,7 @@ transition(State state, int offCount, int onCount)
  * The unknown neighbor count is implicit since there are eight neighbors.
  */
 static Flags
-implication(State state, int offCount, int onCount)
+implication(const Rules * rules, State state, int offCount, int onCount)
 {
 	Flags	flags;
 	State	next;
@@ -1769,14 +3170,14 @@ implication(State state, int offCount, int onCount)
 			/*
 			 * Look for contradictions.
 			 */
-			next = nextState(OFF, onCount + i);
+			next = nextState(rules, OFF, onCount + i);
 
 			if (next == ON)
 				flags &= ~N1IC1;
 			else if (next == OFF)
 				flags &= ~N0IC1;
 
-			next = nextState(ON, onCount + i);
+			next = nextState(rules, ON, onCount + i);
 
 			if (next == ON)
 				flags &= ~N1IC0;
@@ -1794,7 +3195,7 @@ implication(State state, int offCount, int onCount)
 			/*
 			 * Try unknowns zero.
 			 */
-			next = nextState(OFF, onCount);
+			next = nextState(rules, OFF, onCount);
 
 			if (next == ON)
 				flags &= ~N1ICUN1;
@@ -1804,7 +3205,7 @@ implication(State state, int offCount, int onCount)
 			/*
 			 * Try all ones.
 			 */
-			next = nextState(OFF, onCount + unkCount);
+			next = nextState(rules, OFF, onCount + unkCount);
 
 			if (next == ON)
 				flags &= ~N1ICUN0;
@@ -1817,7 +3218,7 @@ implication(State state, int offCount, int onCount)
 			/*
 			 * Try unknowns zero.
 			 */
-			next = nextState(ON, onCount);
+			next = nextState(rules, ON, onCount);
 
 			if (next == ON)
 				flags &= ~N1ICUN1;
@@ -1827,7 +3228,7 @@ implication(State state, int offCount, int onCount)
 			/*
 			 * Try all ones.
 			 */
-			next = nextState(ON, onCount + unkCount);
+			next = nextState(rules, ON, onCount + unkCount);
 
 			if (next == ON)
 				flags &= ~N1ICUN0;
@@ -1839,7 +3240,7 @@ implication(State state, int offCount, int onCount)
 		{
 			if ((state == OFF) || (state == UNK))
 			{
-				next = nextState(OFF, onCount + i);
+				next = nextState(rules, OFF, onCount + i);
 
 				if (next == ON)
 					flags &= ~(N1ICUN0 | N1ICUN1);
@@ -1849,7 +3250,7 @@ implication(State state, int offCount, int onCount)
 
 			if ((state == ON) || (state == UNK))
 			{
-				next = nextState(ON, onCount + i);
+				next = nextState(rules, ON, onCount + i);
 
 				if (next == ON)
 					flags &= ~(N1ICUN0 | N1ICUN1);
@@ -1,19 +1,77 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <getopt.h>
 
 #include "commandline.h"
+#include "daemon.h"
+#include "session.h"
+#include "tiling.h"
 
 static void
 _golsat_commandline_usage(char *program)
 {
     printf("Usage: %s [OPTIONS]... PATTERN_FILE\n"
+           "       %s -w ADDRESS\n"
+           "       %s -D ADDRESS [-n COUNT] [OPTIONS]...\n"
            "Options:\n"
            "  -h, --help             Display this help message\n"
            "  -M, --minimizeDisable  Disable minimization of true literals "
            "(default is false)\n"
-           "  -d, --debug            Enable debug output\n",
-           program);
+           "  -d, --debug            Enable debug output, including a table "
+           "of\n"
+           "                         per-probe search statistics\n",
+           program, program, program);
+    printf("  -j, --json FILE        Write per-probe search statistics to "
+           "FILE as JSON\n"
+           "  -o, --options OPTS     Extra options passed to every lifesrc "
+           "run\n"
+           "  -t, --timeLimit SECS   Time limit for the whole minimization "
+           "(default is %d)\n"
+           "  -g, --steps STEPS      Minimize the ancestor STEPS generations "
+           "back (default is\n"
+           "                         1, at most %d)\n"
+           "  -r, --rule RULE        Rule in lifesrc's format, e.g. B36/S23 "
+           "(default is B3/S23)\n",
+           GOLSAT_TIME_LIMIT, GOLSAT_STEPS_MAX);
+    printf("  -P, --portfolio JOBS   Run JOBS differently ordered lifesrc "
+           "searches at once\n"
+           "                         per probe, the first to finish wins "
+           "(at most %d)\n"
+           "  -R, --restart UNIT     Restart searches with another order "
+           "after UNIT\n"
+           "                         conflicts times the Luby sequence\n",
+           GOLSAT_PORTFOLIO_MAX);
+    printf("  -c, --cubes CELLS      Split probes with a cell limit into "
+           "cubes on CELLS\n"
+           "                         cells, searched by the JOBS runs (at "
+           "most %d)\n",
+           GOLSAT_CUBE_MAX);
+    printf("  -l, --listen ADDRESS   Hand the searches of probes out to "
+           "workers connecting\n"
+           "                         to ADDRESS, HOST:PORT or a Unix "
+           "socket path\n"
+           "  -w, --worker ADDRESS   Search for the coordinator at ADDRESS "
+           "until it exits\n");
+    printf("  -D, --daemon ADDRESS   Minimize the patterns sent to ADDRESS, "
+           "the path of a\n"
+           "                         Unix socket, with the other options "
+           "as defaults\n"
+           "  -n, --pool COUNT       Processes of the daemon solving "
+           "requests at once\n"
+           "                         (default is 1, at most %d)\n"
+           "  -s, --submit ADDRESS   Have the daemon at ADDRESS minimize "
+           "PATTERN_FILE, with\n"
+           "                         the -t and -o given\n",
+           GOLSAT_POOL_MAX);
+    printf("  -S, --session FILE     Journal the probes to FILE and resume "
+           "from it, along\n"
+           "                         with a checkpoint of the probe that "
+           "was interrupted\n"
+           "  -T, --tiles SIZE       Find an ancestor without minimizing it, "
+           "a SIZE x SIZE\n"
+           "                         tile at a time, for patterns too large "
+           "to search at once\n");
 }
 
 int
@@ -25,8 +83,26 @@ golsat_commandline_parse(int argc, char **argv, struct golsat_options *options)
 
     options->pattern = NULL;
     options->minimize_disable = 0;
+    options->stats_file = NULL;
+    options->engine_options = "";
+    options->time_limit = GOLSAT_TIME_LIMIT;
+    options->steps = 1;
+    options->rule_text = NULL;
+    golsat_rule_life(&options->rule);
+    options->portfolio = 1;
+    options->restart_unit = 0;
+    options->cube_cells = 0;
+    options->listen_address = NULL;
+    options->worker_address = NULL;
+    options->daemon_address = NULL;
+    options->pool = 1;
+    options->submit_address = NULL;
+    options->session_file = NULL;
+    options->tile_size = 0;
 
-    while ((opt = getopt(argc, argv, "dMh")) != -1) {
+    while ((opt = getopt(argc, argv, "c:dg:j:l:n:o:r:s:t:w:D:P:R:S:T:Mh"))
+           != -1)
+    {
         switch (opt) {
         case 'M':
             options->minimize_disable = 1;
@@ -34,6 +110,123 @@ golsat_commandline_parse(int argc, char **argv, struct golsat_options *options)
         case 'd':
             options->debug_enable = 1;
             break;
+        case 'j':
+            options->stats_file = optarg;
+            break;
+        case 'l':
+            options->listen_address = optarg;
+            break;
+        case 'w':
+            options->worker_address = optarg;
+            break;
+        case 'D':
+            /* anyone reaching the daemon runs searches, keep it local */
+            if (!strchr(optarg, '/')) {
+                fprintf(stderr, "Daemon address must be the path of a "
+                                "Unix socket\n");
+                return 0;
+            }
+            options->daemon_address = optarg;
+            break;
+        case 's':
+            options->submit_address = optarg;
+            break;
+        case 'S':
+            /* lifesrc is handed the path of the checkpoint next to it */
+            if (strlen(optarg) >= GOLSAT_SESSION_PATH_MAX) {
+                fprintf(stderr, "Session journal path is too long\n");
+                return 0;
+            }
+            options->session_file = optarg;
+            break;
+        case 'n': {
+            char *end;
+
+            options->pool = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->pool <= 0
+                || options->pool > GOLSAT_POOL_MAX)
+            {
+                fprintf(stderr, "Invalid pool size: %s\n", optarg);
+                return 0;
+            }
+        } break;
+        case 'o':
+            if (strlen(optarg) > GOLSAT_ENGINE_OPTIONS_MAX) {
+                fprintf(stderr, "Too many lifesrc options given\n");
+                return 0;
+            }
+            options->engine_options = optarg;
+            break;
+        case 't': {
+            char *end;
+
+            options->time_limit = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->time_limit <= 0) {
+                fprintf(stderr, "Invalid time limit: %s\n", optarg);
+                return 0;
+            }
+        } break;
+        case 'r':
+            if (strlen(optarg) > GOLSAT_RULE_MAX
+                || !golsat_rule_parse(optarg, &options->rule))
+            {
+                fprintf(stderr, "Invalid rule: %s\n", optarg);
+                return 0;
+            }
+            options->rule_text = optarg;
+            break;
+        case 'g': {
+            char *end;
+
+            options->steps = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->steps <= 0
+                || options->steps > GOLSAT_STEPS_MAX)
+            {
+                fprintf(stderr, "Invalid number of steps: %s\n", optarg);
+                return 0;
+            }
+        } break;
+        case 'P': {
+            char *end;
+
+            options->portfolio = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->portfolio <= 0
+                || options->portfolio > GOLSAT_PORTFOLIO_MAX)
+            {
+                fprintf(stderr, "Invalid portfolio size: %s\n", optarg);
+                return 0;
+            }
+        } break;
+        case 'c': {
+            char *end;
+
+            options->cube_cells = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->cube_cells <= 0
+                || options->cube_cells > GOLSAT_CUBE_MAX)
+            {
+                fprintf(stderr, "Invalid number of cube cells: %s\n",
+                        optarg);
+                return 0;
+            }
+        } break;
+        case 'T': {
+            char *end;
+
+            options->tile_size = (int)strtol(optarg, &end, 10);
+            if (*end != '\0' || options->tile_size <= 0) {
+                fprintf(stderr, "Invalid tile size: %s\n", optarg);
+                return 0;
+            }
+        } break;
+        case 'R': {
+            char *end;
+
+            options->restart_unit = strtoul(optarg, &end, 10);
+            if (*end != '\0' || options->restart_unit == 0) {
+                fprintf(stderr, "Invalid restart unit: %s\n", optarg);
+                return 0;
+            }
+        } break;
         case 'h':
         default:
             _golsat_commandline_usage(argv[0]);
@@ -45,7 +238,32 @@ golsat_commandline_parse(int argc, char **argv, struct golsat_options *options)
         options->pattern = argv[optind];
     }
 
-    if (options->pattern == NULL) {
+    /* a tile gives cells one margin of `steps` past those checked */
+    if (options->tile_size
+        && (options->tile_size
+                < (GOLSAT_TILING_CHECKED + 1) * options->steps
+            || options->tile_size
+                       + 2 * GOLSAT_TILING_MARGINS * options->steps
+                   > GOLSAT_TILE_BOARD_MAX))
+    {
+        fprintf(stderr, "Tiles of %d steps must be %d to %d cells wide\n",
+                options->steps, (GOLSAT_TILING_CHECKED + 1) * options->steps,
+                GOLSAT_TILE_BOARD_MAX
+                    - 2 * GOLSAT_TILING_MARGINS * options->steps);
+        return 0;
+    }
+    if (options->tile_size
+        && (options->session_file || options->listen_address
+            || options->cube_cells))
+    {
+        fprintf(stderr, "Tiles cannot be used with -S, -l or -c\n");
+        return 0;
+    }
+
+    /* workers and daemons get their patterns from elsewhere */
+    if (options->pattern == NULL && options->worker_address == NULL
+        && options->daemon_address == NULL)
+    {
         fprintf(stderr, "No PATTERN_FILE given\n");
         _golsat_commandline_usage(argv[0]);
         return 0;
@@ -1,10 +1,43 @@
 #ifndef GOLSAT_COMMANDLINE_H
 #define GOLSAT_COMMANDLINE_H
 
+#include "step.h"
+
+/* default limit for the whole minimization, in seconds */
+#define GOLSAT_TIME_LIMIT (8 * 60)
+/* longest string accepted by -o */
+#define GOLSAT_ENGINE_OPTIONS_MAX 256
+/* most lifesrc runs a probe can keep going at once */
+#define GOLSAT_PORTFOLIO_MAX 16
+/* most cells lifesrc puts in a cube, see CUBE_MAX */
+#define GOLSAT_CUBE_MAX 20
+/* longest string accepted by -r */
+#define GOLSAT_RULE_MAX 32
+/* most generations to go back, one less than GEN_MAX */
+#define GOLSAT_STEPS_MAX 7
+/* most rows lifesrc searches, see ROW_MAX, the board of a tile included */
+#define GOLSAT_TILE_BOARD_MAX 49
+
 struct golsat_options {
     char *pattern;
     int minimize_disable;
     int debug_enable;
+    char *stats_file;
+    char *engine_options;
+    int time_limit;
+    int steps;                   /* generations back to the ancestor */
+    char *rule_text;             /* passed to lifesrc's -R, NULL for Life */
+    struct golsat_rule rule;
+    int portfolio;               /* lifesrc runs per probe, at once */
+    unsigned long restart_unit;  /* conflicts per Luby unit, 0 if off */
+    int cube_cells;              /* cells to split probes on, 0 if off */
+    char *listen_address;        /* coordinate workers there, or NULL */
+    char *worker_address;        /* serve that coordinator, or NULL */
+    char *daemon_address;        /* answer requests there, or NULL */
+    int pool;                    /* processes answering requests */
+    char *submit_address;        /* have that daemon minimize, or NULL */
+    char *session_file;          /* journal to resume from, or NULL */
+    int tile_size;               /* side of the tiles to solve, 0 if off */
 };
 
 int golsat_commandline_parse(int argc,
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "coordinator.h"
+#include "network.h"
+#include "stats.h"
+
+enum _golsat_job_state {
+    _GOLSAT_JOB_PENDING = 0,
+    _GOLSAT_JOB_RUNNING,
+    _GOLSAT_JOB_DONE
+};
+
+struct golsat_coordinator *
+golsat_coordinator_create(const char *address, const char *pattern)
+{
+    struct golsat_coordinator *coordinator;
+
+    if (!(coordinator = calloc(1, sizeof *coordinator))) return NULL;
+    if ((coordinator->listen_fd = golsat_network_listen(address)) == -1) {
+        free(coordinator);
+        return NULL;
+    }
+    coordinator->next_id = 1;
+    coordinator->pattern = pattern;
+
+    /* a worker going away must not take the coordinator along */
+    signal(SIGPIPE, SIG_IGN);
+
+    return coordinator;
+}
+
+void
+golsat_coordinator_cleanup(struct golsat_coordinator *coordinator)
+{
+    int i;
+
+    for (i = 0; i < coordinator->count; ++i) {
+        close(coordinator->workers[i].fd);
+        golsat_protocol_cleanup(&coordinator->workers[i].reader);
+    }
+    close(coordinator->listen_fd);
+    free(coordinator);
+}
+
+/* forget a worker, its job goes back to the ones waiting for a worker */
+static void
+_golsat_coordinator_drop(struct golsat_coordinator *coordinator,
+                         int index,
+                         unsigned char *states,
+                         size_t *cursor)
+{
+    struct golsat_worker_link *link = &coordinator->workers[index];
+
+    if (link->job_id) {
+        states[link->job] = _GOLSAT_JOB_PENDING;
+        if (link->job < *cursor) *cursor = link->job;
+    }
+    close(link->fd);
+    golsat_protocol_cleanup(&link->reader);
+    *link = coordinator->workers[--coordinator->count];
+}
+
+static void
+_golsat_coordinator_accept(struct golsat_coordinator *coordinator)
+{
+    struct golsat_worker_link *link;
+    int fd;
+
+    if ((fd = golsat_network_accept(coordinator->listen_fd)) == -1) return;
+    if (coordinator->count == GOLSAT_WORKERS_MAX) {
+        fprintf(stderr, "-- Error: too many workers\n");
+        close(fd);
+        return;
+    }
+    link = &coordinator->workers[coordinator->count++];
+    link->fd = fd;
+    golsat_protocol_init(&link->reader);
+    link->job_id = 0;
+    link->last_seen = golsat_stats_clock();
+}
+
+/* job text: id and timeout, lifesrc options, cube and then the pattern */
+static int
+_golsat_coordinator_send_job(struct golsat_coordinator *coordinator,
+                             struct golsat_worker_link *link,
+                             const struct golsat_jobs *jobs,
+                             size_t job,
+                             int timeout)
+{
+    const char *cube = jobs->cubes ? jobs->cubes[job] : "";
+    char *text;
+    int ret;
+
+    text = malloc(64 + strlen(jobs->arguments) + strlen(cube)
+                  + strlen(coordinator->pattern));
+    if (!text) return 0;
+    sprintf(text, "%lu %d\n%s\n%s\n%s", coordinator->next_id, timeout,
+            jobs->arguments, cube, coordinator->pattern);
+
+    ret = golsat_network_send(link->fd, GOLSAT_NETWORK_JOB, text,
+                              strlen(text));
+    free(text);
+    if (!ret) return 0;
+
+    link->job_id = coordinator->next_id++;
+    link->job = job;
+
+    return 1;
+}
+
+/*
+ * Read from a worker and handle its frames. Returns 0 if the worker went
+ * away, and sets `stop` if the callback asks to.
+ */
+static int
+_golsat_coordinator_receive(struct golsat_worker_link *link,
+                            unsigned char *states,
+                            size_t *done,
+                            golsat_coordinator_cb callback,
+                            void *data,
+                            int *stop)
+{
+    struct golsat_protocol_frame frame, result_frame;
+    unsigned char chunk[4096];
+    unsigned long id;
+    ssize_t bytes_read;
+    int ret, i;
+
+    do
+        bytes_read = read(link->fd, chunk, sizeof(chunk));
+    while (bytes_read < 0 && errno == EINTR);
+
+    if (bytes_read <= 0) return 0;
+    if (!golsat_protocol_feed(&link->reader, chunk, (size_t)bytes_read))
+        return 0;
+
+    link->last_seen = golsat_stats_clock();
+    while ((ret = golsat_protocol_next(&link->reader, &frame)) == 1) {
+        if (frame.type != GOLSAT_NETWORK_DONE || frame.length < 4) continue;
+
+        for (id = 0, i = 0; i < 4; ++i)
+            id = (id << 8) | frame.payload[i];
+        /* results of cancelled jobs are of no use */
+        if (id != link->job_id) continue;
+
+        result_frame.type = REPORT_RESULT;
+        result_frame.payload = frame.payload + 4;
+        result_frame.length = frame.length - 4;
+        states[link->job] = _GOLSAT_JOB_DONE;
+        ++*done;
+        link->job_id = 0;
+        if (callback(data, link->job, golsat_result_decode(&result_frame)))
+            *stop = 1;
+    }
+
+    return ret != -1;
+}
+
+unsigned long
+golsat_coordinator_run(struct golsat_coordinator *coordinator,
+                       const struct golsat_jobs *jobs,
+                       unsigned long deadline,
+                       golsat_coordinator_cb callback,
+                       void *data)
+{
+    const unsigned long lost = GOLSAT_NETWORK_LOST_SECS * 1000000000ul;
+    struct pollfd fds[GOLSAT_WORKERS_MAX + 1];
+    unsigned char *states, cancel[4];
+    size_t cursor = 0, done = 0;
+    unsigned long handed_out = 0;
+    int i, stop = 0;
+
+    if (!(states = calloc(jobs->count, 1))) {
+        perror("calloc");
+        return 0;
+    }
+
+    while (!stop && done < jobs->count) {
+        const unsigned long now = golsat_stats_clock();
+
+        if (now >= deadline) break;
+
+        for (i = coordinator->count - 1; i >= 0; --i) {
+            struct golsat_worker_link *link = &coordinator->workers[i];
+
+            if (now - link->last_seen > lost) {
+                fprintf(stderr, "-- Lost a worker\n");
+                _golsat_coordinator_drop(coordinator, i, states, &cursor);
+                continue;
+            }
+            if (link->job_id) continue;
+
+            while (cursor < jobs->count
+                   && states[cursor] != _GOLSAT_JOB_PENDING)
+            {
+                ++cursor;
+            }
+            if (cursor == jobs->count) continue;
+
+            if (!_golsat_coordinator_send_job(
+                    coordinator, link, jobs, cursor,
+                    (int)((deadline - now) / 1000000000ul) + 1))
+            {
+                _golsat_coordinator_drop(coordinator, i, states, &cursor);
+                continue;
+            }
+            states[cursor] = _GOLSAT_JOB_RUNNING;
+            ++handed_out;
+        }
+
+        fds[0].fd = coordinator->listen_fd;
+        fds[0].events = POLLIN;
+        for (i = 0; i < coordinator->count; ++i) {
+            fds[i + 1].fd = coordinator->workers[i].fd;
+            fds[i + 1].events = POLLIN;
+        }
+        /* wake up in time to notice lost workers and the deadline */
+        if (poll(fds, coordinator->count + 1,
+                 GOLSAT_NETWORK_HEARTBEAT_SECS * 1000)
+            < 0)
+        {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        /* backwards, so that dropping a worker moves a handled one */
+        for (i = coordinator->count - 1; i >= 0; --i) {
+            if (!fds[i + 1].revents) continue;
+            if (!_golsat_coordinator_receive(&coordinator->workers[i],
+                                             states, &done, callback, data,
+                                             &stop))
+            {
+                fprintf(stderr, "-- A worker went away\n");
+                _golsat_coordinator_drop(coordinator, i, states, &cursor);
+            }
+        }
+        if (fds[0].revents & POLLIN) _golsat_coordinator_accept(coordinator);
+    }
+
+    /* what is still running is of no use anymore */
+    for (i = 0; i < coordinator->count; ++i) {
+        struct golsat_worker_link *link = &coordinator->workers[i];
+
+        if (!link->job_id) continue;
+        cancel[0] = (unsigned char)(link->job_id >> 24);
+        cancel[1] = (unsigned char)(link->job_id >> 16);
+        cancel[2] = (unsigned char)(link->job_id >> 8);
+        cancel[3] = (unsigned char)link->job_id;
+        golsat_network_send(link->fd, GOLSAT_NETWORK_CANCEL, cancel,
+                            sizeof(cancel));
+        link->job_id = 0;
+    }
+    free(states);
+
+    return handed_out;
+}
@@ -0,0 +1,59 @@
+#ifndef GOLSAT_COORDINATOR_H
+#define GOLSAT_COORDINATOR_H
+
+#include <stddef.h>
+
+#include "protocol.h"
+
+/* most workers connected at once */
+#define GOLSAT_WORKERS_MAX 64
+
+/* a connected worker, and the job it runs if any */
+struct golsat_worker_link {
+    int fd;
+    struct golsat_protocol_reader reader;
+    unsigned long job_id; /* 0 while idle */
+    size_t job;
+    unsigned long last_seen;
+};
+
+struct golsat_coordinator {
+    int listen_fd;
+    struct golsat_worker_link workers[GOLSAT_WORKERS_MAX];
+    int count;
+    unsigned long next_id;
+    const char *pattern; /* the pattern in lifesrc's format */
+};
+
+/* the jobs of a probe, the probe itself or one job per cube */
+struct golsat_jobs {
+    char arguments[1024]; /* lifesrc options, files left out */
+    char **cubes;         /* cube lines, NULL for the whole probe */
+    size_t count;
+};
+
+/*
+ * Called with the result of every job, which may be NULL if lifesrc was
+ * killed. Takes over the result, and returns nonzero to stop the others.
+ */
+typedef int (*golsat_coordinator_cb)(void *data,
+                                     size_t job,
+                                     struct golsat_result *result);
+
+struct golsat_coordinator *golsat_coordinator_create(const char *address,
+                                                     const char *pattern);
+void golsat_coordinator_cleanup(struct golsat_coordinator *coordinator);
+
+/*
+ * Hand out the jobs to the workers connected so far or later, handing a
+ * job out again when its worker gets lost, until every job is done, the
+ * callback asks to stop, or the clock of golsat_stats_clock() passes
+ * `deadline`. Returns the number of jobs handed out.
+ */
+unsigned long golsat_coordinator_run(struct golsat_coordinator *coordinator,
+                                     const struct golsat_jobs *jobs,
+                                     unsigned long deadline,
+                                     golsat_coordinator_cb callback,
+                                     void *data);
+
+#endif /* !GOLSAT_COORDINATOR_H */
@@ -0,0 +1,488 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "daemon.h"
+#include "network.h"
+#include "protocol.h"
+
+/* most clients connected at once */
+#define _GOLSAT_DAEMON_CLIENTS_MAX 64
+/* bytes of an answer before the output */
+#define _GOLSAT_DAEMON_ANSWER_HEADER 5
+
+struct _golsat_client {
+    int fd;
+    unsigned long serial;
+    struct golsat_protocol_reader reader;
+};
+
+/* a process of the pool, and the client of the request it solves if any */
+struct _golsat_member {
+    pid_t pid;
+    int fd;
+    struct golsat_protocol_reader reader;
+    unsigned long serial; /* 0 while idle */
+    unsigned long id;
+};
+
+/* a request waiting for a process */
+struct _golsat_queued {
+    unsigned long serial;
+    unsigned char *payload;
+    size_t length;
+};
+
+struct _golsat_daemon {
+    int listen_fd;
+    struct _golsat_client clients[_GOLSAT_DAEMON_CLIENTS_MAX];
+    int client_count;
+    unsigned long next_serial;
+    struct _golsat_member members[GOLSAT_POOL_MAX];
+    int pool;
+    struct _golsat_queued *queue;
+    size_t queued;
+    size_t capacity;
+    golsat_daemon_solve solve;
+    void *data;
+};
+
+static int
+_golsat_daemon_read(int fd, struct golsat_protocol_reader *reader)
+{
+    unsigned char chunk[4096];
+    ssize_t bytes_read;
+
+    do
+        bytes_read = read(fd, chunk, sizeof(chunk));
+    while (bytes_read < 0 && errno == EINTR);
+
+    return bytes_read > 0
+           && golsat_protocol_feed(reader, chunk, (size_t)bytes_read);
+}
+
+/* the id a request starts with */
+static unsigned long
+_golsat_daemon_id(const unsigned char *payload, size_t length)
+{
+    unsigned long id = 0;
+    size_t i;
+
+    for (i = 0; i < length && payload[i] >= '0' && payload[i] <= '9'; ++i)
+        id = id * 10 + (unsigned long)(payload[i] - '0');
+
+    return id;
+}
+
+static int
+_golsat_daemon_send_answer(int fd,
+                           unsigned long id,
+                           int status,
+                           const char *output,
+                           size_t size)
+{
+    unsigned char *answer;
+    int ret;
+
+    if (!(answer = malloc(_GOLSAT_DAEMON_ANSWER_HEADER + size))) return 0;
+    answer[0] = (unsigned char)(id >> 24);
+    answer[1] = (unsigned char)(id >> 16);
+    answer[2] = (unsigned char)(id >> 8);
+    answer[3] = (unsigned char)id;
+    answer[4] = (unsigned char)status;
+    if (size) memcpy(answer + _GOLSAT_DAEMON_ANSWER_HEADER, output, size);
+
+    ret = golsat_network_send(fd, GOLSAT_NETWORK_ANSWER, answer,
+                              _GOLSAT_DAEMON_ANSWER_HEADER + size);
+    free(answer);
+
+    return ret;
+}
+
+/* solve a request within a process of the pool */
+static void
+_golsat_daemon_answer(int fd,
+                      const struct golsat_protocol_frame *frame,
+                      golsat_daemon_solve solve,
+                      void *data)
+{
+    struct golsat_request request;
+    char *text, *end, *output = NULL;
+    int status = EXIT_FAILURE;
+    size_t size = 0;
+    FILE *f_out;
+
+    request.id = _golsat_daemon_id(frame->payload, frame->length);
+    if (!(text = malloc(frame->length + 1))) goto _send;
+    memcpy(text, frame->payload, frame->length);
+    text[frame->length] = '\0';
+
+    strtoul(text, &end, 10);
+    request.time_limit = (int)strtol(end, &end, 10);
+    request.engine_options = end + 1;
+    if (*end != '\n' || !(end = strchr(request.engine_options, '\n'))) {
+        fprintf(stderr, "-- Error: malformed request\n");
+        goto _cleanup;
+    }
+    *end = '\0';
+    request.pattern = end + 1;
+
+    if (!(f_out = open_memstream(&output, &size))) {
+        perror("open_memstream");
+        goto _cleanup;
+    }
+    status = solve(data, &request, f_out);
+    fclose(f_out);
+
+_cleanup:
+    free(text);
+_send:
+    _golsat_daemon_send_answer(fd, request.id, status, output, size);
+    free(output);
+}
+
+/* the loop of a process of the pool, until the daemon goes away */
+static void
+_golsat_daemon_serve(int fd, golsat_daemon_solve solve, void *data)
+{
+    struct golsat_protocol_reader reader;
+    struct golsat_protocol_frame frame;
+
+    golsat_protocol_init(&reader);
+    while (_golsat_daemon_read(fd, &reader)) {
+        while (golsat_protocol_next(&reader, &frame) == 1)
+            if (frame.type == GOLSAT_NETWORK_REQUEST)
+                _golsat_daemon_answer(fd, &frame, solve, data);
+    }
+    golsat_protocol_cleanup(&reader);
+}
+
+static int
+_golsat_daemon_fork(struct _golsat_daemon *daemon,
+                    struct _golsat_member *member)
+{
+    int fds[2], i;
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == -1) {
+        perror("socketpair");
+        return 0;
+    }
+    fflush(NULL);
+    if ((member->pid = fork()) == -1) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return 0;
+    }
+
+    if (member->pid == 0) {
+        /* only the connection to the daemon is of use here */
+        close(fds[0]);
+        close(daemon->listen_fd);
+        for (i = 0; i < daemon->client_count; ++i)
+            close(daemon->clients[i].fd);
+        for (i = 0; i < daemon->pool; ++i)
+            if (daemon->members[i].fd != -1) close(daemon->members[i].fd);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        signal(SIGPIPE, SIG_DFL);
+
+        _golsat_daemon_serve(fds[1], daemon->solve, daemon->data);
+        exit(EXIT_SUCCESS);
+    }
+
+    close(fds[1]);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    member->fd = fds[0];
+    golsat_protocol_init(&member->reader);
+    member->serial = 0;
+
+    return 1;
+}
+
+static struct _golsat_client *
+_golsat_daemon_client(struct _golsat_daemon *daemon, unsigned long serial)
+{
+    int i;
+
+    for (i = 0; i < daemon->client_count; ++i)
+        if (daemon->clients[i].serial == serial) return &daemon->clients[i];
+
+    return NULL;
+}
+
+/* a process of the pool exited, fail its request and start another one */
+static void
+_golsat_daemon_respawn(struct _golsat_daemon *daemon,
+                       struct _golsat_member *member)
+{
+    struct _golsat_client *client;
+    int exec_status;
+
+    close(member->fd);
+    member->fd = -1;
+    golsat_protocol_cleanup(&member->reader);
+    waitpid(member->pid, &exec_status, 0);
+    fprintf(stderr, "-- A process of the pool exited\n");
+
+    if (member->serial
+        && (client = _golsat_daemon_client(daemon, member->serial)))
+    {
+        _golsat_daemon_send_answer(client->fd, member->id, EXIT_FAILURE,
+                                   NULL, 0);
+    }
+    if (!_golsat_daemon_fork(daemon, member)) member->serial = 0;
+}
+
+/* forward the answers of a process, returns 0 if it exited */
+static int
+_golsat_daemon_member(struct _golsat_daemon *daemon,
+                      struct _golsat_member *member)
+{
+    struct golsat_protocol_frame frame;
+    struct _golsat_client *client;
+
+    if (!_golsat_daemon_read(member->fd, &member->reader)) return 0;
+
+    while (golsat_protocol_next(&member->reader, &frame) == 1) {
+        if (frame.type != GOLSAT_NETWORK_ANSWER) continue;
+        /* the answers of clients that went away are dropped */
+        if ((client = _golsat_daemon_client(daemon, member->serial)))
+            golsat_network_send(client->fd, GOLSAT_NETWORK_ANSWER,
+                                frame.payload, frame.length);
+        member->serial = 0;
+    }
+
+    return 1;
+}
+
+/* queue the requests of a client, returns 0 if it went away */
+static int
+_golsat_daemon_receive(struct _golsat_daemon *daemon,
+                       struct _golsat_client *client)
+{
+    struct golsat_protocol_frame frame;
+    struct _golsat_queued *queued;
+    int ret;
+
+    if (!_golsat_daemon_read(client->fd, &client->reader)) return 0;
+
+    while ((ret = golsat_protocol_next(&client->reader, &frame)) == 1) {
+        if (frame.type != GOLSAT_NETWORK_REQUEST) continue;
+
+        if (daemon->queued == daemon->capacity) {
+            const size_t capacity =
+                daemon->capacity ? daemon->capacity * 2 : 16;
+            void *tmp;
+
+            if (!(tmp = realloc(daemon->queue, capacity * sizeof *queued)))
+                return 0;
+            daemon->queue = tmp;
+            daemon->capacity = capacity;
+        }
+        queued = &daemon->queue[daemon->queued];
+        if (!(queued->payload = malloc(frame.length + 1))) return 0;
+        memcpy(queued->payload, frame.payload, frame.length);
+        queued->length = frame.length;
+        queued->serial = client->serial;
+        ++daemon->queued;
+    }
+
+    return ret != -1;
+}
+
+static void
+_golsat_daemon_drop(struct _golsat_daemon *daemon, int index)
+{
+    struct _golsat_client *client = &daemon->clients[index];
+    size_t i, kept;
+
+    /* nobody is left to answer to */
+    for (i = kept = 0; i < daemon->queued; ++i) {
+        if (daemon->queue[i].serial == client->serial)
+            free(daemon->queue[i].payload);
+        else
+            daemon->queue[kept++] = daemon->queue[i];
+    }
+    daemon->queued = kept;
+
+    close(client->fd);
+    golsat_protocol_cleanup(&client->reader);
+    *client = daemon->clients[--daemon->client_count];
+}
+
+static void
+_golsat_daemon_accept(struct _golsat_daemon *daemon)
+{
+    struct _golsat_client *client;
+    int fd;
+
+    if ((fd = golsat_network_accept(daemon->listen_fd)) == -1) return;
+    if (daemon->client_count == _GOLSAT_DAEMON_CLIENTS_MAX) {
+        fprintf(stderr, "-- Error: too many clients\n");
+        close(fd);
+        return;
+    }
+    client = &daemon->clients[daemon->client_count++];
+    client->fd = fd;
+    client->serial = ++daemon->next_serial;
+    golsat_protocol_init(&client->reader);
+}
+
+/* hand the oldest requests to the idle processes */
+static void
+_golsat_daemon_dispatch(struct _golsat_daemon *daemon)
+{
+    struct _golsat_member *member;
+    size_t taken = 0;
+    int i;
+
+    for (i = 0; i < daemon->pool && taken < daemon->queued; ++i) {
+        struct _golsat_queued *queued = &daemon->queue[taken];
+
+        member = &daemon->members[i];
+        if (member->fd == -1 || member->serial) continue;
+
+        member->serial = queued->serial;
+        member->id = _golsat_daemon_id(queued->payload, queued->length);
+        if (!golsat_network_send(member->fd, GOLSAT_NETWORK_REQUEST,
+                                 queued->payload, queued->length))
+        {
+            /* noticed as an exit once polled */
+            perror("send");
+        }
+        free(queued->payload);
+        ++taken;
+    }
+    if (taken) {
+        daemon->queued -= taken;
+        memmove(daemon->queue, daemon->queue + taken,
+                daemon->queued * sizeof *daemon->queue);
+    }
+}
+
+int
+golsat_daemon_run(const char *path,
+                  int pool,
+                  golsat_daemon_solve solve,
+                  void *data)
+{
+    struct pollfd fds[1 + GOLSAT_POOL_MAX + _GOLSAT_DAEMON_CLIENTS_MAX];
+    struct _golsat_daemon daemon = { 0 };
+    int i, count;
+
+    if ((daemon.listen_fd = golsat_network_listen(path)) == -1) return 0;
+    /* a client going away must not take the daemon along */
+    signal(SIGPIPE, SIG_IGN);
+
+    daemon.pool = pool;
+    daemon.solve = solve;
+    daemon.data = data;
+    for (i = 0; i < pool; ++i)
+        daemon.members[i].fd = -1;
+    for (i = 0; i < pool; ++i) {
+        if (!_golsat_daemon_fork(&daemon, &daemon.members[i])) {
+            close(daemon.listen_fd);
+            return 0;
+        }
+    }
+
+    for (;;) {
+        _golsat_daemon_dispatch(&daemon);
+
+        fds[0].fd = daemon.listen_fd;
+        fds[0].events = POLLIN;
+        for (i = 0; i < pool; ++i) {
+            fds[1 + i].fd = daemon.members[i].fd;
+            fds[1 + i].events = POLLIN;
+        }
+        for (i = 0; i < daemon.client_count; ++i) {
+            fds[1 + pool + i].fd = daemon.clients[i].fd;
+            fds[1 + pool + i].events = POLLIN;
+        }
+        count = 1 + pool + daemon.client_count;
+        if (poll(fds, count, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        for (i = 0; i < pool; ++i) {
+            if (fds[1 + i].revents
+                && !_golsat_daemon_member(&daemon, &daemon.members[i]))
+            {
+                _golsat_daemon_respawn(&daemon, &daemon.members[i]);
+            }
+        }
+        /* backwards, so that dropping a client moves a handled one */
+        for (i = daemon.client_count - 1; i >= 0; --i) {
+            if (fds[1 + pool + i].revents
+                && !_golsat_daemon_receive(&daemon, &daemon.clients[i]))
+            {
+                _golsat_daemon_drop(&daemon, i);
+            }
+        }
+        if (fds[0].revents & POLLIN) _golsat_daemon_accept(&daemon);
+    }
+
+    return 0;
+}
+
+int
+golsat_daemon_submit(const char *path,
+                     const struct golsat_request *request,
+                     FILE *out)
+{
+    struct golsat_protocol_reader reader;
+    struct golsat_protocol_frame frame;
+    int fd, status = -1;
+    char *text;
+
+    if ((fd = golsat_network_connect(path)) == -1) return EXIT_FAILURE;
+
+    text = malloc(64 + strlen(request->engine_options)
+                  + strlen(request->pattern));
+    if (!text) {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+    sprintf(text, "%lu %d\n%s\n%s", request->id, request->time_limit,
+            request->engine_options, request->pattern);
+    if (!golsat_network_send(fd, GOLSAT_NETWORK_REQUEST, text,
+                             strlen(text)))
+    {
+        perror(path);
+        status = EXIT_FAILURE;
+    }
+    free(text);
+
+    golsat_protocol_init(&reader);
+    while (status == -1 && _golsat_daemon_read(fd, &reader)) {
+        while (status == -1 && golsat_protocol_next(&reader, &frame) == 1) {
+            if (frame.type != GOLSAT_NETWORK_ANSWER
+                || frame.length < _GOLSAT_DAEMON_ANSWER_HEADER)
+            {
+                continue;
+            }
+            fwrite(frame.payload + _GOLSAT_DAEMON_ANSWER_HEADER, 1,
+                   frame.length - _GOLSAT_DAEMON_ANSWER_HEADER, out);
+            status = frame.payload[4];
+        }
+    }
+    golsat_protocol_cleanup(&reader);
+    close(fd);
+
+    if (status == -1) {
+        fprintf(stderr, "-- Error: the daemon went away\n");
+        return EXIT_FAILURE;
+    }
+    return status;
+}
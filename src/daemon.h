@@ -0,0 +1,48 @@
+#ifndef GOLSAT_DAEMON_H
+#define GOLSAT_DAEMON_H
+
+#include <stdio.h>
+
+/* most processes kept by a daemon */
+#define GOLSAT_POOL_MAX 64
+
+/* a minimization asked for by a client */
+struct golsat_request {
+    unsigned long id;
+    int time_limit;
+    char *engine_options; /* passed to lifesrc, like -o */
+    char *pattern;        /* the text of a pattern file */
+};
+
+/* solve a request, printing the output to `out`, returns the exit status */
+typedef int (*golsat_daemon_solve)(void *data,
+                                   const struct golsat_request *request,
+                                   FILE *out);
+
+/*
+ * Answer the requests of clients connecting to the Unix socket `path`
+ * until killed. A request is the text
+ *
+ *     ID TIME_LIMIT
+ *     LIFESRC OPTIONS
+ *     PATTERN FILE...
+ *
+ * and is solved by the first idle one of `pool` processes forked once at
+ * start, so that requests only wait for a process to be free. A client
+ * may have several requests going on at once, each is answered as soon
+ * as it is solved. Returns 0 if the daemon could not start.
+ */
+int golsat_daemon_run(const char *path,
+                      int pool,
+                      golsat_daemon_solve solve,
+                      void *data);
+
+/*
+ * Send a request to the daemon at `path` and write its output to `out`.
+ * Returns the exit status of the request.
+ */
+int golsat_daemon_submit(const char *path,
+                         const struct golsat_request *request,
+                         FILE *out);
+
+#endif /* !GOLSAT_DAEMON_H */
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "network.h"
+
+/* largest host or port accepted in an address */
+#define _GOLSAT_NETWORK_NAME_MAX 256
+
+static int
+_golsat_network_unix(const char *path, struct sockaddr_un *addr)
+{
+    if (strlen(path) >= sizeof(addr->sun_path)) {
+        fprintf(stderr, "Socket path is too long: %s\n", path);
+        return 0;
+    }
+    memset(addr, 0, sizeof *addr);
+    addr->sun_family = AF_UNIX;
+    strcpy(addr->sun_path, path);
+
+    return 1;
+}
+
+/* keep sockets away from the lifesrc runs started meanwhile */
+static int
+_golsat_network_private(int fd)
+{
+    if (fd != -1) fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+/* resolve HOST:PORT, a NULL host gets the wildcard address */
+static struct addrinfo *
+_golsat_network_resolve(const char *address, int passive)
+{
+    char host[_GOLSAT_NETWORK_NAME_MAX];
+    const char *port = strrchr(address, ':');
+    struct addrinfo hints, *info;
+    int ret;
+
+    if (!port || (size_t)(port - address) >= sizeof(host)) {
+        fprintf(stderr, "Invalid address: %s\n", address);
+        return NULL;
+    }
+    memcpy(host, address, port - address);
+    host[port - address] = '\0';
+    ++port;
+
+    memset(&hints, 0, sizeof hints);
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (passive) hints.ai_flags = AI_PASSIVE;
+
+    if ((ret = getaddrinfo(*host ? host : NULL, port, &hints, &info)) != 0)
+    {
+        fprintf(stderr, "%s: %s\n", address, gai_strerror(ret));
+        return NULL;
+    }
+    return info;
+}
+
+int
+golsat_network_listen(const char *address)
+{
+    struct addrinfo *info, *it;
+    int fd = -1, on = 1;
+
+    if (strchr(address, '/')) {
+        struct sockaddr_un addr;
+
+        if (!_golsat_network_unix(address, &addr)) return -1;
+        /* a socket left behind by an earlier run would be in the way */
+        unlink(address);
+        if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1
+            || bind(fd, (struct sockaddr *)&addr, sizeof addr) == -1
+            || listen(fd, SOMAXCONN) == -1)
+        {
+            perror(address);
+            if (fd != -1) close(fd);
+            return -1;
+        }
+        return _golsat_network_private(fd);
+    }
+
+    if (!(info = _golsat_network_resolve(address, 1))) return -1;
+    for (it = info; it; it = it->ai_next) {
+        if ((fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol))
+            == -1)
+        {
+            continue;
+        }
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof on);
+        if (bind(fd, it->ai_addr, it->ai_addrlen) == 0
+            && listen(fd, SOMAXCONN) == 0)
+        {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    if (fd == -1) perror(address);
+    freeaddrinfo(info);
+
+    return _golsat_network_private(fd);
+}
+
+int
+golsat_network_connect(const char *address)
+{
+    struct addrinfo *info, *it;
+    int fd = -1;
+
+    if (strchr(address, '/')) {
+        struct sockaddr_un addr;
+
+        if (!_golsat_network_unix(address, &addr)) return -1;
+        if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) == -1
+            || connect(fd, (struct sockaddr *)&addr, sizeof addr) == -1)
+        {
+            perror(address);
+            if (fd != -1) close(fd);
+            return -1;
+        }
+        return _golsat_network_private(fd);
+    }
+
+    if (!(info = _golsat_network_resolve(address, 0))) return -1;
+    for (it = info; it; it = it->ai_next) {
+        if ((fd = socket(it->ai_family, it->ai_socktype, it->ai_protocol))
+            == -1)
+        {
+            continue;
+        }
+        if (connect(fd, it->ai_addr, it->ai_addrlen) == 0) break;
+        close(fd);
+        fd = -1;
+    }
+    if (fd == -1) perror(address);
+    freeaddrinfo(info);
+
+    return _golsat_network_private(fd);
+}
+
+int
+golsat_network_accept(int listen_fd)
+{
+    int fd;
+
+    do
+        fd = accept(listen_fd, NULL, NULL);
+    while (fd == -1 && errno == EINTR);
+    if (fd == -1) perror("accept");
+
+    return _golsat_network_private(fd);
+}
+
+int
+golsat_network_send(int fd, int type, const void *payload, size_t length)
+{
+    unsigned char header[REPORT_HEADER];
+    const unsigned char *data = header;
+    size_t size = sizeof(header);
+    ssize_t written;
+    int i;
+
+    header[0] = REPORT_MAGIC0;
+    header[1] = REPORT_MAGIC1;
+    header[2] = (unsigned char)type;
+    header[3] = REPORT_VERSION;
+    for (i = 0; i < 4; ++i)
+        header[4 + i] = (unsigned char)(length >> (8 * (3 - i)));
+
+    /* the header first, then the payload */
+    for (i = 0; i < 2; ++i) {
+        while (size) {
+            if ((written = write(fd, data, size)) < 0) {
+                if (errno == EINTR) continue;
+                return 0;
+            }
+            data += written;
+            size -= (size_t)written;
+        }
+        data = payload;
+        size = length;
+    }
+
+    return 1;
+}
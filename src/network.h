@@ -0,0 +1,48 @@
+#ifndef GOLSAT_NETWORK_H
+#define GOLSAT_NETWORK_H
+
+#include <stddef.h>
+
+#include "report.h"
+
+/*
+ * A coordinator hands out jobs to workers, and a daemon answers the
+ * requests of clients, over connections that carry frames laid out like
+ * the ones of lifesrc (see report.h), using these frame types:
+ */
+/* coordinator to worker, a job as text, see golsat_worker_run() */
+#define GOLSAT_NETWORK_JOB 16
+/* coordinator to worker, the 4 byte id of a job to give up */
+#define GOLSAT_NETWORK_CANCEL 17
+/* worker to coordinator, empty, sent every GOLSAT_NETWORK_HEARTBEAT_SECS */
+#define GOLSAT_NETWORK_HEARTBEAT 18
+/* worker to coordinator, the 4 byte id of a job and its REPORT_RESULT */
+#define GOLSAT_NETWORK_DONE 19
+/* client to daemon, a request as text, see golsat_daemon_run() */
+#define GOLSAT_NETWORK_REQUEST 20
+/* daemon to client, the 4 byte id of a request, the exit status byte and
+ * then the output of gol-sat */
+#define GOLSAT_NETWORK_ANSWER 21
+
+/* seconds between heartbeats */
+#define GOLSAT_NETWORK_HEARTBEAT_SECS 1
+/* a worker silent for this many seconds is considered lost */
+#define GOLSAT_NETWORK_LOST_SECS 5
+
+/*
+ * Addresses are either HOST:PORT for TCP, where HOST may be empty to
+ * listen on every interface, or the path of a Unix socket, which must
+ * contain a '/'. Both return a socket, or -1 after printing the error.
+ */
+int golsat_network_listen(const char *address);
+int golsat_network_connect(const char *address);
+/* accept a connection on a listening socket, or -1 after printing why */
+int golsat_network_accept(int listen_fd);
+
+/* write a whole frame, returns 0 on failure */
+int golsat_network_send(int fd,
+                        int type,
+                        const void *payload,
+                        size_t length);
+
+#endif /* !GOLSAT_NETWORK_H */
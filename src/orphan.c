@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pattern.h"
+#include "orphan.h"
+
+/* a predecessor row covers the tile plus one cell on each side */
+#define SPAN       (GOLSAT_ORPHAN_TILE + 2)
+#define ROW_STATES (1u << SPAN)
+#define ROW_MASK   (ROW_STATES - 1)
+
+struct _golsat_tile {
+    unsigned want[GOLSAT_ORPHAN_TILE]; /* expected live cells per row */
+    unsigned care[GOLSAT_ORPHAN_TILE]; /* cells that are not '?' */
+    unsigned allowed[SPAN]; /* predecessor cells that lie inside the board */
+    unsigned char *seen;    /* (row, upper, middle) states already refuted */
+};
+
+struct _golsat_tile_entry {
+    unsigned long cells;
+    unsigned bounds;
+    int used;
+    int orphan;
+};
+
+/* target row produced by three stacked predecessor rows, B3/S23 */
+static unsigned char _golsat_orphan_step[1u << (3 * SPAN)];
+static int _golsat_orphan_step_ready;
+
+static void
+_golsat_orphan_init_step(void)
+{
+    unsigned idx;
+
+    for (idx = 0; idx < (1u << (3 * SPAN)); ++idx) {
+        const unsigned a = (idx >> (2 * SPAN)) & ROW_MASK,
+                       b = (idx >> SPAN) & ROW_MASK, c = idx & ROW_MASK;
+        unsigned out = 0;
+        int x;
+
+        for (x = 0; x < GOLSAT_ORPHAN_TILE; ++x) {
+            const unsigned window = 0x7u << x;
+            int count = 0, i;
+
+            for (i = 0; i < 3; ++i) {
+                count += ((a & window) >> (x + i)) & 1;
+                count += ((c & window) >> (x + i)) & 1;
+            }
+            count += (b >> x) & 1;
+            count += (b >> (x + 2)) & 1;
+
+            if (count == 3 || (count == 2 && ((b >> (x + 1)) & 1)))
+                out |= 1u << x;
+        }
+        _golsat_orphan_step[idx] = (unsigned char)out;
+    }
+    _golsat_orphan_step_ready = 1;
+}
+
+/*
+ * Depth-first search for predecessor rows `row + 2` onwards, given that
+ * predecessor rows `row` and `row + 1` are `upper` and `middle`.
+ */
+static int
+_golsat_orphan_extend(struct _golsat_tile *tile,
+                      int row,
+                      unsigned upper,
+                      unsigned middle)
+{
+    const size_t state =
+        ((size_t)row << (2 * SPAN)) | (upper << SPAN) | middle;
+    unsigned lower;
+
+    if (row == GOLSAT_ORPHAN_TILE) return 1;
+    if (tile->seen[state]) return 0;
+    tile->seen[state] = 1;
+
+    for (lower = 0; lower < ROW_STATES; ++lower) {
+        unsigned out;
+
+        if (lower & ~tile->allowed[row + 2]) continue;
+
+        out = _golsat_orphan_step[(upper << (2 * SPAN)) | (middle << SPAN)
+                                  | lower];
+        if ((out ^ tile->want[row]) & tile->care[row]) continue;
+
+        if (_golsat_orphan_extend(tile, row + 1, middle, lower)) return 1;
+    }
+    return 0;
+}
+
+static int
+_golsat_orphan_tile_has_predecessor(struct _golsat_tile *tile)
+{
+    unsigned upper, middle;
+
+    memset(tile->seen, 0, (size_t)GOLSAT_ORPHAN_TILE << (2 * SPAN));
+
+    for (upper = 0; upper < ROW_STATES; ++upper) {
+        if (upper & ~tile->allowed[0]) continue;
+        for (middle = 0; middle < ROW_STATES; ++middle) {
+            if (middle & ~tile->allowed[1]) continue;
+            if (_golsat_orphan_extend(tile, 0, upper, middle)) return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Read the target window whose top-left corner is (x0, y0). Cells outside
+ * of the board belong to the dead frame, predecessor cells outside of it
+ * are forced dead.
+ */
+static void
+_golsat_orphan_load_tile(const struct golsat_pattern *pat,
+                         int x0,
+                         int y0,
+                         struct _golsat_tile *tile,
+                         unsigned long *cells,
+                         unsigned *bounds)
+{
+    unsigned cols = 0, rows = 0;
+    int x, y, i;
+
+    *cells = 0;
+    for (y = 0; y < GOLSAT_ORPHAN_TILE; ++y) {
+        tile->want[y] = tile->care[y] = 0;
+        for (x = 0; x < GOLSAT_ORPHAN_TILE; ++x) {
+            const int px = x0 + x, py = y0 + y;
+            enum golsat_cellstate state = GOLSAT_CELLSTATE_DEAD;
+
+            if (px >= 0 && px < pat->width && py >= 0 && py < pat->height)
+                state = golsat_pattern_get_cell(pat, px, py);
+
+            if (state == GOLSAT_CELLSTATE_UNKNOWN) continue;
+            tile->care[y] |= 1u << x;
+            if (state == GOLSAT_CELLSTATE_ALIVE) tile->want[y] |= 1u << x;
+        }
+        *cells |= (unsigned long)tile->want[y] << (y * GOLSAT_ORPHAN_TILE);
+        *cells |= (unsigned long)tile->care[y]
+                  << (16 + y * GOLSAT_ORPHAN_TILE);
+    }
+
+    for (i = 0; i < SPAN; ++i) {
+        const int px = x0 - 1 + i, py = y0 - 1 + i;
+
+        if (px >= 0 && px < pat->width) cols |= 1u << i;
+        if (py >= 0 && py < pat->height) rows |= 1u << i;
+    }
+    for (i = 0; i < SPAN; ++i)
+        tile->allowed[i] = (rows >> i) & 1 ? cols : 0;
+
+    *bounds = (rows << SPAN) | cols;
+}
+
+int
+golsat_orphan_scan(const struct golsat_pattern *pat,
+                   struct golsat_orphan *orphan)
+{
+    const int x_last = pat->width + 1 - GOLSAT_ORPHAN_TILE,
+              y_last = pat->height + 1 - GOLSAT_ORPHAN_TILE;
+    struct _golsat_tile tile;
+    struct _golsat_tile_entry *table;
+    size_t capacity = 1;
+    int x, y, found = 0;
+
+    if (x_last < -1 || y_last < -1) return 0;
+
+    while (capacity < 2 * (size_t)(x_last + 2) * (size_t)(y_last + 2))
+        capacity <<= 1;
+
+    table = calloc(capacity, sizeof *table);
+    tile.seen = malloc((size_t)GOLSAT_ORPHAN_TILE << (2 * SPAN));
+    if (!table || !tile.seen) {
+        free(table);
+        free(tile.seen);
+        return 0;
+    }
+    if (!_golsat_orphan_step_ready) _golsat_orphan_init_step();
+
+    for (y = -1; y <= y_last && !found; ++y) {
+        for (x = -1; x <= x_last && !found; ++x) {
+            struct _golsat_tile_entry *entry;
+            unsigned long cells;
+            unsigned bounds;
+            size_t slot;
+
+            _golsat_orphan_load_tile(pat, x, y, &tile, &cells, &bounds);
+
+            slot = (size_t)((cells * 2654435761ul) ^ (bounds * 40503u))
+                   & (capacity - 1);
+            for (entry = &table[slot]; entry->used;
+                 entry = &table[slot = (slot + 1) & (capacity - 1)])
+            {
+                if (entry->cells == cells && entry->bounds == bounds) break;
+            }
+
+            if (!entry->used) {
+                entry->used = 1;
+                entry->cells = cells;
+                entry->bounds = bounds;
+                entry->orphan = !_golsat_orphan_tile_has_predecessor(&tile);
+            }
+
+            if (entry->orphan) {
+                orphan->x = x;
+                orphan->y = y;
+                orphan->width = orphan->height = GOLSAT_ORPHAN_TILE;
+                found = 1;
+            }
+        }
+    }
+
+    free(tile.seen);
+    free(table);
+
+    return found;
+}
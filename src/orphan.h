@@ -0,0 +1,23 @@
+#ifndef GOLSAT_ORPHAN_H
+#define GOLSAT_ORPHAN_H
+
+/* side length of the target windows checked for predecessors */
+#define GOLSAT_ORPHAN_TILE 4
+
+struct golsat_orphan {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/*
+ * Scan every GOLSAT_ORPHAN_TILE x GOLSAT_ORPHAN_TILE window of the target
+ * (including the dead frame just outside of it) for a window that no
+ * in-board predecessor can produce. Returns 1 and fills `orphan` with the
+ * offending window if one is found, 0 otherwise.
+ */
+int golsat_orphan_scan(const struct golsat_pattern *pattern,
+                       struct golsat_orphan *orphan);
+
+#endif /* !GOLSAT_ORPHAN_H */
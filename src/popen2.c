@@ -2,9 +2,37 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "popen2.h"
 
+/*
+ * Run the blank separated words of `cmdline` as a program and its
+ * arguments, without a shell, so that no word is ever taken as a command.
+ */
+static void
+_popen2_exec(const char *cmdline)
+{
+    const size_t len = strlen(cmdline);
+    char *line, **argv, *word;
+    size_t count = 0;
+
+    if (!(line = malloc(len + 1))
+        || !(argv = malloc((len / 2 + 2) * sizeof *argv)))
+    {
+        perror("malloc");
+        return;
+    }
+    strcpy(line, cmdline);
+    for (word = strtok(line, " "); word; word = strtok(NULL, " "))
+        argv[count++] = word;
+    argv[count] = NULL;
+    if (!count) return;
+
+    execvp(argv[0], argv);
+    perror(argv[0]);
+}
+
 int
 popen2(const char *cmdline, struct popen2 *childinfo)
 {
@@ -26,10 +54,12 @@ popen2(const char *cmdline, struct popen2 *childinfo)
         dup2(pipe_stdin[0], 0);
         close(pipe_stdout[0]);
         dup2(pipe_stdout[1], 1);
-        execl("/bin/sh", "sh", "-c", cmdline, 0);
-        perror("execl");
+        _popen2_exec(cmdline);
         exit(99);
     }
+    /* keep only our ends, so the child closing stdout is seen as EOF */
+    close(pipe_stdin[0]);
+    close(pipe_stdout[1]);
     childinfo->child_pid = p;
     childinfo->to_child = pipe_stdin[1];
     childinfo->from_child = pipe_stdout[0];
@@ -8,6 +8,10 @@ struct popen2 {
     int from_child, to_child;
 };
 
+/*
+ * Start the program and arguments `cmdline` holds, separated by blanks,
+ * without a shell. Returns 0 on success.
+ */
 int popen2(const char *cmdline, struct popen2 *childinfo);
 
 #endif /* #!POPEN2_H */
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "pattern.h"
+#include "protocol.h"
+
+static unsigned long
+_golsat_protocol_get_num(const unsigned char *data, int size)
+{
+    unsigned long num = 0;
+
+    while (size--)
+        num = (num << 8) | *data++;
+    return num;
+}
+
+void
+golsat_protocol_init(struct golsat_protocol_reader *reader)
+{
+    reader->buffer = NULL;
+    reader->length = reader->capacity = reader->consumed = 0;
+}
+
+void
+golsat_protocol_cleanup(struct golsat_protocol_reader *reader)
+{
+    free(reader->buffer);
+    golsat_protocol_init(reader);
+}
+
+int
+golsat_protocol_feed(struct golsat_protocol_reader *reader,
+                     const void *data,
+                     size_t size)
+{
+    /* drop the frames handed out so far before growing */
+    if (reader->consumed) {
+        reader->length -= reader->consumed;
+        memmove(reader->buffer, reader->buffer + reader->consumed,
+                reader->length);
+        reader->consumed = 0;
+    }
+
+    if (reader->length + size > reader->capacity) {
+        size_t capacity = reader->capacity ? reader->capacity : 256;
+        unsigned char *tmp;
+
+        while (capacity < reader->length + size)
+            capacity *= 2;
+        if (!(tmp = realloc(reader->buffer, capacity))) return 0;
+        reader->buffer = tmp;
+        reader->capacity = capacity;
+    }
+
+    memcpy(reader->buffer + reader->length, data, size);
+    reader->length += size;
+
+    return 1;
+}
+
+int
+golsat_protocol_next(struct golsat_protocol_reader *reader,
+                     struct golsat_protocol_frame *frame)
+{
+    const unsigned char *header = reader->buffer + reader->consumed;
+    const size_t available = reader->length - reader->consumed;
+    unsigned long length;
+
+    if (available < REPORT_HEADER) return 0;
+
+    if (header[0] != REPORT_MAGIC0 || header[1] != REPORT_MAGIC1
+        || header[3] != REPORT_VERSION)
+    {
+        return -1;
+    }
+
+    length = _golsat_protocol_get_num(header + 4, 4);
+    if (available - REPORT_HEADER < length) return 0;
+
+    frame->type = header[2];
+    frame->payload = header + REPORT_HEADER;
+    frame->length = length;
+    reader->consumed += REPORT_HEADER + length;
+
+    return 1;
+}
+
+int
+golsat_progress_decode(const struct golsat_protocol_frame *frame,
+                       struct golsat_progress *progress)
+{
+    const unsigned char *data = frame->payload;
+
+    if (frame->type != REPORT_PROGRESS
+        || frame->length < REPORT_PROGRESS_SIZE)
+    {
+        return 0;
+    }
+
+    progress->fraction = (double)_golsat_protocol_get_num(data, 4)
+                         / REPORT_PROGRESS_ONE;
+    progress->decisions = _golsat_protocol_get_num(data + 4, 8);
+    progress->nanoseconds = _golsat_protocol_get_num(data + 12, 8);
+
+    return 1;
+}
+
+struct golsat_result *
+golsat_result_decode(const struct golsat_protocol_frame *frame)
+{
+    const unsigned char *data = frame->payload;
+    struct golsat_result *result;
+    size_t plane_size;
+    int flags;
+
+    if (frame->type != REPORT_RESULT || frame->length < REPORT_RESULT_SIZE)
+        return NULL;
+    if (!(result = calloc(1, sizeof *result))) return NULL;
+
+    result->status = data[0];
+    flags = data[1];
+    result->live_cells = (int)_golsat_protocol_get_num(data + 2, 4);
+    result->decisions = _golsat_protocol_get_num(data + 6, 8);
+    result->backtracks = _golsat_protocol_get_num(data + 14, 8);
+    result->set_cells = _golsat_protocol_get_num(data + 22, 8);
+    result->consistifies = _golsat_protocol_get_num(data + 30, 8);
+    result->conflicts = _golsat_protocol_get_num(data + 38, 8);
+    result->max_depth = _golsat_protocol_get_num(data + 46, 4);
+    result->nanoseconds = _golsat_protocol_get_num(data + 50, 8);
+    result->rows = (int)_golsat_protocol_get_num(data + 58, 2);
+    result->cols = (int)_golsat_protocol_get_num(data + 60, 2);
+
+    if (result->status != REPORT_FOUND) return result;
+
+    plane_size = REPORT_PLANE_SIZE(result->rows, result->cols);
+    if (frame->length
+        < REPORT_RESULT_SIZE + plane_size * (flags & REPORT_HAS_UNK ? 2 : 1))
+    {
+        fprintf(stderr, "Result frame is too short for its grid.\n");
+        free(result);
+        return NULL;
+    }
+
+    data += REPORT_RESULT_SIZE;
+    if (!(result->on_plane = malloc(plane_size))) {
+        free(result);
+        return NULL;
+    }
+    memcpy(result->on_plane, data, plane_size);
+
+    if (flags & REPORT_HAS_UNK) {
+        if (!(result->unknown_plane = malloc(plane_size))) {
+            golsat_result_cleanup(result);
+            return NULL;
+        }
+        memcpy(result->unknown_plane, data + plane_size, plane_size);
+    }
+
+    return result;
+}
+
+void
+golsat_result_cleanup(struct golsat_result *result)
+{
+    free(result->on_plane);
+    free(result->unknown_plane);
+    free(result);
+}
+
+enum golsat_cellstate
+golsat_result_get_cell(const struct golsat_result *result, int x, int y)
+{
+    const int bit = x + result->cols * y;
+    const int mask = 0x80 >> (bit % 8);
+
+    assert(x >= 0 && x < result->cols && y >= 0 && y < result->rows);
+    assert(result->on_plane != NULL);
+
+    if (result->unknown_plane && (result->unknown_plane[bit / 8] & mask))
+        return GOLSAT_CELLSTATE_UNKNOWN;
+    return (result->on_plane[bit / 8] & mask) ? GOLSAT_CELLSTATE_ALIVE
+                                              : GOLSAT_CELLSTATE_DEAD;
+}
@@ -0,0 +1,73 @@
+#ifndef GOLSAT_PROTOCOL_H
+#define GOLSAT_PROTOCOL_H
+
+#include <stddef.h>
+
+#include "pattern.h"
+#include "report.h"
+
+/* accumulates solver output until whole frames are available */
+struct golsat_protocol_reader {
+    unsigned char *buffer;
+    size_t length;
+    size_t capacity;
+    size_t consumed;
+};
+
+struct golsat_protocol_frame {
+    int type;
+    const unsigned char *payload;
+    size_t length;
+};
+
+/* decoded REPORT_RESULT frame */
+struct golsat_result {
+    int status;
+    int live_cells;
+    unsigned long decisions;
+    unsigned long backtracks;
+    unsigned long set_cells;
+    unsigned long consistifies;
+    unsigned long conflicts;
+    unsigned long max_depth;
+    unsigned long nanoseconds;
+    int rows;
+    int cols;
+    unsigned char *on_plane;
+    unsigned char *unknown_plane;
+};
+
+void golsat_protocol_init(struct golsat_protocol_reader *reader);
+void golsat_protocol_cleanup(struct golsat_protocol_reader *reader);
+
+/* append solver output, returns 0 on allocation failure */
+int golsat_protocol_feed(struct golsat_protocol_reader *reader,
+                         const void *data,
+                         size_t size);
+
+/*
+ * Extract the next complete frame. Returns 1 and fills `frame`, which
+ * stays valid until the next call, 0 if more output is needed, and -1 if
+ * the output is not made of frames.
+ */
+int golsat_protocol_next(struct golsat_protocol_reader *reader,
+                         struct golsat_protocol_frame *frame);
+
+/* decoded REPORT_PROGRESS frame */
+struct golsat_progress {
+    double fraction; /* estimated part of the search tree searched */
+    unsigned long decisions;
+    unsigned long nanoseconds;
+};
+
+/* returns 0 if `frame` is not a whole REPORT_PROGRESS frame */
+int golsat_progress_decode(const struct golsat_protocol_frame *frame,
+                           struct golsat_progress *progress);
+
+struct golsat_result *golsat_result_decode(
+    const struct golsat_protocol_frame *frame);
+void golsat_result_cleanup(struct golsat_result *result);
+enum golsat_cellstate golsat_result_get_cell(
+    const struct golsat_result *result, int x, int y);
+
+#endif /* !GOLSAT_PROTOCOL_H */
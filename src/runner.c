@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "runner.h"
+
+/* the lifesrc options that only the generic engine has */
+static const char *const _golsat_runner_generic[] = { "-s", "-nc", "-wc",
+                                                      "-uc" };
+
+/* the characters of the arguments of the options below */
+#define _GOLSAT_RUNNER_NUMBER "-0123456789"
+#define _GOLSAT_RUNNER_RULE "/,0123456789BSbs"
+
+/*
+ * The lifesrc options that only tune a search, with the characters their
+ * argument is made of, NULL for those that take none. Those naming files
+ * are left out.
+ */
+static const struct {
+    const char *name;
+    const char *argument;
+} _golsat_runner_tuning[] = {
+    { "-r", _GOLSAT_RUNNER_NUMBER },  { "-c", _GOLSAT_RUNNER_NUMBER },
+    { "-g", _GOLSAT_RUNNER_NUMBER },  { "-tr", _GOLSAT_RUNNER_NUMBER },
+    { "-tc", _GOLSAT_RUNNER_NUMBER }, { "-mt", _GOLSAT_RUNNER_NUMBER },
+    { "-mc", _GOLSAT_RUNNER_NUMBER }, { "-nc", _GOLSAT_RUNNER_NUMBER },
+    { "-wc", _GOLSAT_RUNNER_NUMBER }, { "-ur", _GOLSAT_RUNNER_NUMBER },
+    { "-uc", _GOLSAT_RUNNER_NUMBER }, { "-L", _GOLSAT_RUNNER_NUMBER },
+    { "-S", _GOLSAT_RUNNER_NUMBER },  { "-C", _GOLSAT_RUNNER_NUMBER },
+    { "-e", _GOLSAT_RUNNER_NUMBER },  { "-M", _GOLSAT_RUNNER_NUMBER },
+    { "-z", _GOLSAT_RUNNER_NUMBER },  { "-R", _GOLSAT_RUNNER_RULE },
+    { "-fr", NULL },                  { "-fc", NULL },
+    { "-fq", NULL },                  { "-sr", NULL },
+    { "-sc", NULL },                  { "-sp", NULL },
+    { "-sf", NULL },                  { "-sb", NULL },
+    { "-f", NULL },                   { "-fg", NULL },
+    { "-ow", NULL },                  { "-og", NULL },
+    { "-om", NULL },                  { "-oa", NULL },
+    { "-p", NULL },                   { "-a", NULL }
+};
+
+const char *
+golsat_runner_engine(const char *options)
+{
+    const size_t count =
+        sizeof(_golsat_runner_generic) / sizeof *_golsat_runner_generic;
+    size_t i, len;
+
+    if (access(GOLSAT_RUNNER_PARENT, X_OK) != 0) return GOLSAT_RUNNER_GENERIC;
+
+    for (; *options; options += len) {
+        options += strspn(options, " ");
+        len = strcspn(options, " ");
+        for (i = 0; i < count; ++i)
+            if (!strncmp(options, _golsat_runner_generic[i],
+                         strlen(_golsat_runner_generic[i])))
+            {
+                return GOLSAT_RUNNER_GENERIC;
+            }
+    }
+
+    return GOLSAT_RUNNER_PARENT;
+}
+
+int
+golsat_runner_tuning(const char *options)
+{
+    const size_t count =
+        sizeof(_golsat_runner_tuning) / sizeof *_golsat_runner_tuning;
+    size_t i, len, name_len;
+
+    for (; *options; options += len) {
+        options += strspn(options, " ");
+        if (!(len = strcspn(options, " "))) continue;
+
+        for (i = 0; i < count; ++i) {
+            const char *argument = _golsat_runner_tuning[i].argument;
+
+            name_len = strlen(_golsat_runner_tuning[i].name);
+            if (name_len > len
+                || strncmp(options, _golsat_runner_tuning[i].name, name_len))
+            {
+                continue;
+            }
+            if (!argument && name_len == len) break;
+            if (argument && name_len < len
+                && strspn(options + name_len, argument) == len - name_len)
+            {
+                break;
+            }
+        }
+        if (i == count) return 0;
+    }
+
+    return 1;
+}
+
+int
+golsat_runner_start(struct golsat_runner *runner, const char *command)
+{
+    runner->result = NULL;
+    runner->progressed = 0;
+    runner->malformed = 0;
+    runner->stopped = 0;
+
+    if (popen2(command, &runner->exec) != 0) {
+        perror("popen2");
+        return 0;
+    }
+    /* headless lifesrc takes no commands */
+    close(runner->exec.to_child);
+    golsat_protocol_init(&runner->reader);
+
+    return 1;
+}
+
+int
+golsat_runner_read(struct golsat_runner *runner)
+{
+    struct golsat_protocol_frame frame;
+    unsigned char chunk[4096];
+    ssize_t bytes_read;
+    int ret;
+
+    do
+        bytes_read = read(runner->exec.from_child, chunk, sizeof(chunk));
+    while (bytes_read < 0 && errno == EINTR);
+
+    if (bytes_read <= 0) return 0;
+    /* the rest of a malformed output is only drained */
+    if (runner->malformed) return 1;
+
+    if (!golsat_protocol_feed(&runner->reader, chunk, (size_t)bytes_read)) {
+        perror("golsat_protocol_feed");
+        return 0;
+    }
+    while ((ret = golsat_protocol_next(&runner->reader, &frame)) == 1) {
+        if (golsat_progress_decode(&frame, &runner->progress))
+            runner->progressed = 1;
+        if (frame.type != REPORT_RESULT || runner->result) continue;
+        runner->result = golsat_result_decode(&frame);
+    }
+    if (ret == -1) {
+        fprintf(stderr, "-- Error: malformed lifesrc output\n");
+        runner->malformed = 1;
+    }
+
+    return 1;
+}
+
+void
+golsat_runner_stop(struct golsat_runner *runner)
+{
+    kill(runner->exec.child_pid, SIGTERM);
+    runner->stopped = 1;
+}
+
+struct golsat_result *
+golsat_runner_finish(struct golsat_runner *runner)
+{
+    int exec_status;
+
+    close(runner->exec.from_child);
+    golsat_protocol_cleanup(&runner->reader);
+    waitpid(runner->exec.child_pid, &exec_status, 0);
+    assert((runner->stopped || WIFEXITED(exec_status) != 0)
+           && "lifesrc terminated abnormally");
+
+    /* no result frame means lifesrc was killed, most likely by `timeout` */
+    return runner->result;
+}
@@ -0,0 +1,61 @@
+#ifndef GOLSAT_RUNNER_H
+#define GOLSAT_RUNNER_H
+
+#include "popen2.h"
+#include "protocol.h"
+
+/* lifesrc built for parent searches only, which is faster at them */
+#define GOLSAT_RUNNER_PARENT "./lifesrc-parent"
+/* lifesrc with every option */
+#define GOLSAT_RUNNER_GENERIC "./lifesrc"
+
+/* a lifesrc run whose output is decoded as it arrives */
+struct golsat_runner {
+    struct popen2 exec;
+    struct golsat_protocol_reader reader;
+    struct golsat_result *result;
+    struct golsat_progress progress; /* the last estimate reported */
+    int progressed; /* set when `progress` changes, cleared by the caller */
+    int malformed;
+    int stopped;
+};
+
+/*
+ * The lifesrc to run a search for parents (`-p`) with `options` with: the
+ * parent engine, unless it was not built or one of the options needs the
+ * generic one.
+ */
+const char *golsat_runner_engine(const char *options);
+
+/*
+ * Whether `options` only holds lifesrc options that tune a search, with
+ * numbers or a rule as their arguments, and none that names a file. The
+ * options received from other machines must pass this.
+ */
+int golsat_runner_tuning(const char *options);
+
+/*
+ * Start `command`, a program and its arguments separated by blanks, which
+ * no shell sees. Returns 0 if the command could not be started.
+ */
+int golsat_runner_start(struct golsat_runner *runner, const char *command);
+
+/*
+ * Read the output available on `runner->exec.from_child` and decode the
+ * frames completed by it. Returns 0 once lifesrc has closed its output.
+ */
+int golsat_runner_read(struct golsat_runner *runner);
+
+/*
+ * Ask lifesrc to stop, it still writes its result frame unless the signal
+ * arrives before it is ready for it.
+ */
+void golsat_runner_stop(struct golsat_runner *runner);
+
+/*
+ * Wait for lifesrc to exit and hand over its result, which is NULL if it
+ * was killed before writing one. The caller cleans the result up.
+ */
+struct golsat_result *golsat_runner_finish(struct golsat_runner *runner);
+
+#endif /* !GOLSAT_RUNNER_H */
@@ -0,0 +1,346 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "session.h"
+
+/* bumped whenever the journal changes incompatibly */
+#define _GOLSAT_SESSION_VERSION 1
+
+static const char *const _golsat_session_outcomes[] = { "found", "none",
+                                                        "timeout" };
+
+/* FNV-1a, which is enough to tell patterns apart */
+static unsigned long
+_golsat_session_hash(const char *text)
+{
+    unsigned long hash = 2166136261ul;
+
+    for (; *text; ++text)
+        hash = ((hash ^ (unsigned char)*text) * 16777619ul) & 0xfffffffful;
+
+    return hash;
+}
+
+/* make what was written so far survive a crash */
+static int
+_golsat_session_sync(FILE *journal)
+{
+    return fflush(journal) == 0 && fsync(fileno(journal)) == 0;
+}
+
+/* read an ancestor written by golsat_session_end, NULL if it is damaged */
+static struct golsat_result *
+_golsat_session_read_board(FILE *journal,
+                           const int width,
+                           const int height,
+                           char **line,
+                           size_t *size)
+{
+    const size_t plane_size = REPORT_PLANE_SIZE(height, width);
+    struct golsat_result *result;
+    int x, y;
+
+    if (!(result = calloc(1, sizeof *result))) return NULL;
+    result->status = REPORT_FOUND;
+    result->rows = height;
+    result->cols = width;
+    if (!(result->on_plane = calloc(plane_size, 1))
+        || !(result->unknown_plane = calloc(plane_size, 1)))
+    {
+        goto _damaged;
+    }
+
+    for (y = 0; y < height; ++y) {
+        if (getline(line, size, journal) != (ssize_t)width + 1
+            || (*line)[width] != '\n')
+        {
+            goto _damaged;
+        }
+        for (x = 0; x < width; ++x) {
+            const int bit = x + width * y;
+            const unsigned char mask = (unsigned char)(0x80 >> (bit % 8));
+
+            switch ((*line)[x]) {
+            case 'O':
+                result->on_plane[bit / 8] |= mask;
+                break;
+            case '?':
+                result->unknown_plane[bit / 8] |= mask;
+                break;
+            case '.':
+                break;
+            default:
+                goto _damaged;
+            }
+        }
+    }
+
+    return result;
+
+_damaged:
+    golsat_result_cleanup(result);
+    return NULL;
+}
+
+/* forget the probes not replayed yet, which start at `offset` */
+static void
+_golsat_session_drop(struct golsat_session *session, const long offset)
+{
+    while (session->count > session->next) {
+        struct golsat_session_probe *probe =
+            &session->probes[--session->count];
+
+        if (probe->result) golsat_result_cleanup(probe->result);
+    }
+    session->started = -1;
+
+    fflush(session->journal);
+    if (ftruncate(fileno(session->journal), (off_t)offset) != 0)
+        perror("ftruncate");
+    fseek(session->journal, offset, SEEK_SET);
+}
+
+static int
+_golsat_session_add(struct golsat_session *session,
+                    const struct golsat_session_probe *probe,
+                    const long offset)
+{
+    struct golsat_session_probe *probes;
+    long *offsets;
+
+    if (!(probes = realloc(session->probes,
+                           (session->count + 1) * sizeof *probes)))
+    {
+        return 0;
+    }
+    session->probes = probes;
+    if (!(offsets = realloc(session->offsets,
+                            (session->count + 1) * sizeof *offsets)))
+    {
+        return 0;
+    }
+    session->offsets = offsets;
+
+    probes[session->count] = *probe;
+    offsets[session->count++] = offset;
+
+    return 1;
+}
+
+/*
+ * Read the probes of the journal back. A crash may have cut the last
+ * record short, everything from the first damaged line on is dropped.
+ */
+static int
+_golsat_session_read(struct golsat_session *session,
+                     const int width,
+                     const int height)
+{
+    struct golsat_session_probe probe;
+    char *line = NULL, outcome[16];
+    size_t size = 0;
+    long offset, end;
+    ssize_t length;
+    int ok = 1, i;
+
+    end = ftell(session->journal);
+    for (;;) {
+        offset = end;
+        if ((length = getline(&line, &size, session->journal)) <= 0
+            || line[length - 1] != '\n')
+        {
+            break;
+        }
+
+        if (sscanf(line, "start %d", &probe.max_cells) == 1) {
+            session->started = probe.max_cells;
+            end = ftell(session->journal);
+            continue;
+        }
+        if (sscanf(line, "probe %d %15s %d %lu", &probe.max_cells, outcome,
+                   &probe.live_cells, &probe.wall_ns)
+            != 4)
+        {
+            break;
+        }
+        for (i = 0; i <= GOLSAT_OUTCOME_TIMEOUT; ++i)
+            if (!strcmp(outcome, _golsat_session_outcomes[i])) break;
+        if (i > GOLSAT_OUTCOME_TIMEOUT) break;
+        probe.outcome = (enum golsat_outcome)i;
+
+        probe.result = NULL;
+        if (probe.outcome == GOLSAT_OUTCOME_FOUND) {
+            if (!(probe.result = _golsat_session_read_board(
+                      session->journal, width, height, &line, &size)))
+            {
+                break;
+            }
+            probe.result->live_cells = probe.live_cells;
+        }
+        if (!_golsat_session_add(session, &probe, offset)) {
+            if (probe.result) golsat_result_cleanup(probe.result);
+            ok = 0;
+            break;
+        }
+        session->started = -1;
+        end = ftell(session->journal);
+    }
+    free(line);
+
+    /* the journal goes on after its last whole record */
+    fflush(session->journal);
+    if (ftruncate(fileno(session->journal), (off_t)end) != 0) ok = 0;
+    fseek(session->journal, end, SEEK_SET);
+
+    return ok;
+}
+
+struct golsat_session *
+golsat_session_open(const char *path,
+                    const char *text,
+                    const int steps,
+                    const char *rule,
+                    const int width,
+                    const int height)
+{
+    struct golsat_session *session;
+    char *header, *line = NULL;
+    size_t size = 0;
+
+    if (!(session = calloc(1, sizeof *session))) return NULL;
+    session->started = -1;
+
+    header = malloc(strlen(rule) + 128);
+    session->checkpoint = malloc(strlen(path) + sizeof(".ck"));
+    if (!header || !session->checkpoint) goto _error;
+    sprintf(header, "golsat-session %d %08lx %d %s %d %d\n",
+            _GOLSAT_SESSION_VERSION, _golsat_session_hash(text), steps, rule,
+            width, height);
+    sprintf(session->checkpoint, "%s.ck", path);
+
+    if ((session->journal = fopen(path, "r+"))) {
+        if (getline(&line, &size, session->journal) != -1
+            && !strcmp(line, header))
+        {
+            free(line);
+            free(header);
+            if (!_golsat_session_read(session, width, height)) {
+                golsat_session_cleanup(session);
+                return NULL;
+            }
+            return session;
+        }
+        fprintf(stderr, "-- %s is the journal of another minimization, "
+                        "starting over\n",
+                path);
+        fclose(session->journal);
+        session->journal = NULL;
+    }
+    free(line);
+
+    remove(session->checkpoint);
+    if (!(session->journal = fopen(path, "w+"))) goto _error;
+    fputs(header, session->journal);
+    if (!_golsat_session_sync(session->journal)) goto _error;
+    free(header);
+
+    return session;
+
+_error:
+    perror(path);
+    free(header);
+    golsat_session_cleanup(session);
+    return NULL;
+}
+
+void
+golsat_session_cleanup(struct golsat_session *session)
+{
+    while (session->count > session->next) {
+        struct golsat_session_probe *probe =
+            &session->probes[--session->count];
+
+        if (probe->result) golsat_result_cleanup(probe->result);
+    }
+    if (session->journal) fclose(session->journal);
+    free(session->probes);
+    free(session->offsets);
+    free(session->checkpoint);
+    free(session);
+}
+
+int
+golsat_session_replay(struct golsat_session *session,
+                      const int max_cells,
+                      struct golsat_session_probe *probe)
+{
+    if (session->next == session->count) return 0;
+    if (session->probes[session->next].max_cells != max_cells) {
+        /* another time limit or options took the search elsewhere */
+        _golsat_session_drop(session, session->offsets[session->next]);
+        return 0;
+    }
+
+    *probe = session->probes[session->next];
+    session->probes[session->next++].result = NULL;
+
+    return 1;
+}
+
+int
+golsat_session_begin(struct golsat_session *session, const int max_cells)
+{
+    const int resume = session->started == max_cells;
+    FILE *f_checkpoint;
+
+    session->started = -1;
+    fprintf(session->journal, "start %d\n", max_cells);
+    _golsat_session_sync(session->journal);
+
+    if (!resume) {
+        remove(session->checkpoint);
+        return 0;
+    }
+    if (!(f_checkpoint = fopen(session->checkpoint, "rb"))) return 0;
+    fclose(f_checkpoint);
+
+    return 1;
+}
+
+int
+golsat_session_end(struct golsat_session *session,
+                   const struct golsat_session_probe *probe)
+{
+    const struct golsat_result *result = probe->result;
+    int x, y;
+
+    fprintf(session->journal, "probe %d %s %d %lu\n", probe->max_cells,
+            _golsat_session_outcomes[probe->outcome], probe->live_cells,
+            probe->wall_ns);
+    if (probe->outcome == GOLSAT_OUTCOME_FOUND && result) {
+        for (y = 0; y < result->rows; ++y) {
+            for (x = 0; x < result->cols; ++x) {
+                switch (golsat_result_get_cell(result, x, y)) {
+                case GOLSAT_CELLSTATE_ALIVE:
+                    fputc('O', session->journal);
+                    break;
+                case GOLSAT_CELLSTATE_DEAD:
+                    fputc('.', session->journal);
+                    break;
+                case GOLSAT_CELLSTATE_UNKNOWN:
+                    fputc('?', session->journal);
+                    break;
+                }
+            }
+            fputc('\n', session->journal);
+        }
+    }
+    /* the probe is over, its checkpoint would only mislead a rerun */
+    remove(session->checkpoint);
+
+    return _golsat_session_sync(session->journal);
+}
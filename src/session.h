@@ -0,0 +1,73 @@
+#ifndef GOLSAT_SESSION_H
+#define GOLSAT_SESSION_H
+
+#include <stdio.h>
+
+#include "protocol.h"
+#include "stats.h"
+
+/* longest path of a session journal, its checkpoint adds a suffix */
+#define GOLSAT_SESSION_PATH_MAX 256
+/* thousands of searches between the checkpoints of a probe, see -db */
+#define GOLSAT_SESSION_DUMP 1000
+
+/* the outcome of a probe as kept by a journal */
+struct golsat_session_probe {
+    int max_cells; /* 0 if the probe had no cell limit */
+    enum golsat_outcome outcome;
+    int live_cells;
+    unsigned long wall_ns;
+    struct golsat_result *result; /* the ancestor if found, or NULL */
+};
+
+/*
+ * A journal of the probes of a minimization, appended to and synced as
+ * each probe ends, so that a minimization of the same pattern started
+ * with the same journal takes the outcomes of the probes made before
+ * instead of running them again. A probe interrupted in the middle can
+ * go on from the engine checkpoint kept next to the journal.
+ */
+struct golsat_session {
+    FILE *journal;
+    char *checkpoint; /* path of the engine checkpoint */
+    struct golsat_session_probe *probes; /* read back from the journal */
+    long *offsets;                       /* where each of them starts */
+    size_t count;
+    size_t next; /* the next one to be replayed */
+    int started; /* limit of the probe interrupted last, -1 if none */
+};
+
+/*
+ * Open the journal at `path`, creating it if needed. `text` identifies
+ * the minimization together with the number of `steps` and `rule`, a
+ * journal of another one is started over. Returns NULL on failure.
+ */
+struct golsat_session *golsat_session_open(const char *path,
+                                           const char *text,
+                                           int steps,
+                                           const char *rule,
+                                           int width,
+                                           int height);
+void golsat_session_cleanup(struct golsat_session *session);
+
+/*
+ * Take the outcome of the next probe from the journal if it was made
+ * with `max_cells`, `probe->result` is then owned by the caller. Returns
+ * 0 once the journal holds no more probes, or the minimization went
+ * another way, in which case the rest of the journal is dropped.
+ */
+int golsat_session_replay(struct golsat_session *session,
+                          int max_cells,
+                          struct golsat_session_probe *probe);
+
+/*
+ * Note that a probe with `max_cells` starts. Returns 1 if it was the
+ * probe interrupted last and its engine checkpoint can be resumed.
+ */
+int golsat_session_begin(struct golsat_session *session, int max_cells);
+
+/* add the outcome of a probe, returns 0 if it cannot be written */
+int golsat_session_end(struct golsat_session *session,
+                       const struct golsat_session_probe *probe);
+
+#endif /* !GOLSAT_SESSION_H */
@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stats.h"
+
+static const char *const _golsat_outcome_names[] = { "found", "none",
+                                                     "timeout" };
+
+unsigned long
+golsat_stats_clock(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)now.tv_sec * 1000000000ul
+           + (unsigned long)now.tv_nsec;
+}
+
+struct golsat_stats *
+golsat_stats_create(void)
+{
+    struct golsat_stats *stats = calloc(1, sizeof *stats);
+
+    if (stats) stats->minimum = -1;
+    return stats;
+}
+
+void
+golsat_stats_cleanup(struct golsat_stats *stats)
+{
+    free(stats->probes);
+    free(stats);
+}
+
+int
+golsat_stats_add(struct golsat_stats *stats,
+                 const struct golsat_probe_stats *probe)
+{
+    if (stats->count == stats->capacity) {
+        const size_t capacity = stats->capacity ? stats->capacity * 2 : 16;
+        struct golsat_probe_stats *tmp =
+            realloc(stats->probes, capacity * sizeof *tmp);
+
+        if (!tmp) return 0;
+        stats->probes = tmp;
+        stats->capacity = capacity;
+    }
+    stats->probes[stats->count++] = *probe;
+    return 1;
+}
+
+static void
+_golsat_stats_total(const struct golsat_stats *stats,
+                    struct golsat_probe_stats *total)
+{
+    size_t i;
+
+    memset(total, 0, sizeof *total);
+    for (i = 0; i < stats->count; ++i) {
+        const struct golsat_probe_stats *probe = &stats->probes[i];
+
+        total->runs += probe->runs;
+        total->decisions += probe->decisions;
+        total->backtracks += probe->backtracks;
+        total->set_cells += probe->set_cells;
+        total->consistifies += probe->consistifies;
+        total->conflicts += probe->conflicts;
+        if (probe->max_depth > total->max_depth)
+            total->max_depth = probe->max_depth;
+        total->engine_ns += probe->engine_ns;
+        total->wall_ns += probe->wall_ns;
+        total->has_engine |= probe->has_engine;
+    }
+}
+
+static double
+_golsat_stats_nodes_per_sec(const struct golsat_probe_stats *probe)
+{
+    if (!probe->engine_ns) return 0.0;
+    return probe->decisions / (probe->engine_ns / 1e9);
+}
+
+static void
+_golsat_stats_print_row(const struct golsat_probe_stats *probe, FILE *out)
+{
+    fprintf(out, "%10.1f ", probe->wall_ns / 1e6);
+    if (!probe->has_engine)
+        fprintf(out, "%10s %11s %11s %12s %12s %11s %7s %11s", "-", "-",
+                "-", "-", "-", "-", "-", "-");
+    else
+        fprintf(out, "%10.1f %11lu %11lu %12lu %12lu %11lu %7lu %11.0f",
+                probe->engine_ns / 1e6, probe->decisions,
+                probe->backtracks, probe->set_cells, probe->consistifies,
+                probe->conflicts, probe->max_depth,
+                _golsat_stats_nodes_per_sec(probe));
+    if (probe->has_progress)
+        fprintf(out, " %6.2f\n", probe->progress * 100);
+    else
+        fprintf(out, " %6s\n", "-");
+}
+
+void
+golsat_stats_print_table(const struct golsat_stats *stats, FILE *out)
+{
+    struct golsat_probe_stats total;
+    size_t i;
+
+    fprintf(out,
+            "%5s %5s %-7s %5s %10s %10s %11s %11s %12s %12s %11s %7s %11s "
+            "%6s\n",
+            "probe", "mt", "outcome", "cells", "wall ms", "engine ms",
+            "decisions", "backtracks", "setCell", "consistify", "conflicts",
+            "depth", "nodes/s", "done%");
+
+    for (i = 0; i < stats->count; ++i) {
+        const struct golsat_probe_stats *probe = &stats->probes[i];
+
+        fprintf(out, "%5lu ", (unsigned long)i + 1);
+        if (probe->max_cells)
+            fprintf(out, "%5d ", probe->max_cells);
+        else
+            fprintf(out, "%5s ", "-");
+        fprintf(out, "%-7s ", _golsat_outcome_names[probe->outcome]);
+        if (probe->outcome == GOLSAT_OUTCOME_FOUND)
+            fprintf(out, "%5d ", probe->live_cells);
+        else
+            fprintf(out, "%5s ", "-");
+        _golsat_stats_print_row(probe, out);
+    }
+
+    _golsat_stats_total(stats, &total);
+    fprintf(out, "%-26s", "total");
+    _golsat_stats_print_row(&total, out);
+}
+
+static void
+_golsat_stats_print_json_counters(const struct golsat_probe_stats *probe,
+                                  FILE *out)
+{
+    fprintf(out, "\"runs\": %lu, \"wall_ns\": %lu", probe->runs,
+            probe->wall_ns);
+    /* how long the whole search tree would take at the same pace */
+    if (probe->has_progress && probe->progress > 0)
+        fprintf(out, ", \"progress\": %.9f, \"estimated_ns\": %.0f",
+                probe->progress, probe->progress_ns / probe->progress);
+    else if (probe->has_progress)
+        fputs(", \"progress\": 0, \"estimated_ns\": null", out);
+    if (!probe->has_engine) return;
+    fprintf(out,
+            ", \"engine_ns\": %lu, \"decisions\": %lu, \"backtracks\": %lu"
+            ", \"set_cells\": %lu, \"consistifies\": %lu, \"conflicts\": %lu"
+            ", \"max_depth\": %lu, \"nodes_per_sec\": %.0f",
+            probe->engine_ns, probe->decisions, probe->backtracks,
+            probe->set_cells, probe->consistifies, probe->conflicts,
+            probe->max_depth, _golsat_stats_nodes_per_sec(probe));
+}
+
+void
+golsat_stats_print_json(const struct golsat_stats *stats,
+                        const char *pattern,
+                        FILE *out)
+{
+    struct golsat_probe_stats total;
+    size_t i, timeouts;
+
+    fputs("{\n  \"pattern\": \"", out);
+    for (; *pattern; ++pattern) {
+        if (*pattern == '"' || *pattern == '\\') fputc('\\', out);
+        fputc(*pattern, out);
+    }
+    fputs("\",\n", out);
+    if (stats->minimum != -1)
+        fprintf(out, "  \"minimum\": %d,\n", stats->minimum);
+    else
+        fputs("  \"minimum\": null,\n", out);
+    fputs("  \"probes\": [", out);
+
+    for (i = 0; i < stats->count; ++i) {
+        const struct golsat_probe_stats *probe = &stats->probes[i];
+
+        fprintf(out, "%s\n    { \"max_cells\": %d, \"outcome\": \"%s\", ",
+                i ? "," : "", probe->max_cells,
+                _golsat_outcome_names[probe->outcome]);
+        if (probe->outcome == GOLSAT_OUTCOME_FOUND)
+            fprintf(out, "\"live_cells\": %d, ", probe->live_cells);
+        _golsat_stats_print_json_counters(probe, out);
+        fputs(" }", out);
+    }
+
+    _golsat_stats_total(stats, &total);
+    for (timeouts = i = 0; i < stats->count; ++i)
+        if (stats->probes[i].outcome == GOLSAT_OUTCOME_TIMEOUT) ++timeouts;
+    fprintf(out, "\n  ],\n  \"total\": { \"probes\": %lu, \"timeouts\": %lu, ",
+            (unsigned long)stats->count, (unsigned long)timeouts);
+    _golsat_stats_print_json_counters(&total, out);
+    fputs(" }\n}\n", out);
+}
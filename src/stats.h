@@ -0,0 +1,54 @@
+#ifndef GOLSAT_STATS_H
+#define GOLSAT_STATS_H
+
+#include <stddef.h>
+
+enum golsat_outcome {
+    GOLSAT_OUTCOME_FOUND,
+    GOLSAT_OUTCOME_NONE,
+    GOLSAT_OUTCOME_TIMEOUT
+};
+
+/* counters of a single probe, summed over its lifesrc runs */
+struct golsat_probe_stats {
+    int max_cells; /* 0 if the probe had no cell limit */
+    enum golsat_outcome outcome;
+    int live_cells;
+    unsigned long runs; /* restarts and portfolio runs included */
+    int has_engine; /* lifesrc reported the counters below */
+    unsigned long decisions;
+    unsigned long backtracks;
+    unsigned long set_cells;
+    unsigned long consistifies;
+    unsigned long conflicts;
+    unsigned long max_depth;
+    unsigned long engine_ns; /* time spent searching, as seen by lifesrc */
+    unsigned long wall_ns;   /* time spent waiting for lifesrc */
+    int has_progress; /* lifesrc estimated the progress below */
+    double progress;  /* largest part of the search tree searched */
+    unsigned long progress_ns; /* wall time when it was estimated */
+};
+
+struct golsat_stats {
+    int minimum; /* smallest population found, -1 if none */
+    struct golsat_probe_stats *probes;
+    size_t count;
+    size_t capacity;
+};
+
+/* monotonic clock in nanoseconds */
+unsigned long golsat_stats_clock(void);
+
+struct golsat_stats *golsat_stats_create(void);
+void golsat_stats_cleanup(struct golsat_stats *stats);
+int golsat_stats_add(struct golsat_stats *stats,
+                     const struct golsat_probe_stats *probe);
+
+/* human readable table, one row per probe followed by the totals */
+void golsat_stats_print_table(const struct golsat_stats *stats, FILE *out);
+/* the same data as a JSON object */
+void golsat_stats_print_json(const struct golsat_stats *stats,
+                             const char *pattern,
+                             FILE *out);
+
+#endif /* !GOLSAT_STATS_H */
@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "step.h"
+
+void
+golsat_rule_life(struct golsat_rule *rule)
+{
+    rule->birth = 1u << 3;
+    rule->survival = (1u << 2) | (1u << 3);
+}
+
+int
+golsat_rule_parse(const char *text, struct golsat_rule *rule)
+{
+    unsigned long bits = 0;
+    int i;
+
+    rule->birth = rule->survival = 0;
+    if (*text == '\0') return 0;
+
+    if (!strchr(text, ',') && !strchr(text, '/')) {
+        /* two bits per neighbour count, birth being the lower one */
+        for (; *text; ++text) {
+            if (*text >= '0' && *text <= '9')
+                bits = (bits << 4) + (unsigned long)(*text - '0');
+            else if (*text >= 'a' && *text <= 'f')
+                bits = (bits << 4) + (unsigned long)(*text - 'a' + 10);
+            else if (*text >= 'A' && *text <= 'F')
+                bits = (bits << 4) + (unsigned long)(*text - 'A' + 10);
+            else
+                return 0;
+            if (bits >> 18) return 0;
+        }
+        for (i = 0; i < 9; ++i, bits >>= 2) {
+            if (bits & 1) rule->birth |= 1u << i;
+            if (bits & 2) rule->survival |= 1u << i;
+        }
+        return 1;
+    }
+
+    if (*text == 'b' || *text == 'B') ++text;
+    while (*text >= '0' && *text <= '8')
+        rule->birth |= 1u << (*text++ - '0');
+    if (*text != ',' && *text != '/') return 0;
+    ++text;
+    if (*text == 's' || *text == 'S') ++text;
+    while (*text >= '0' && *text <= '8')
+        rule->survival |= 1u << (*text++ - '0');
+
+    return *text == '\0';
+}
+
+struct golsat_board *
+golsat_board_create(int width, int height)
+{
+    struct golsat_board *board;
+
+    if (!(board = malloc(sizeof *board))) return NULL;
+    board->width = width;
+    board->height = height;
+    board->stride = (width + 2 + GOLSAT_WORD_BITS - 1) / GOLSAT_WORD_BITS;
+    board->words = calloc(board->stride * (height + 2), sizeof *board->words);
+    if (!board->words) {
+        free(board);
+        return NULL;
+    }
+
+    return board;
+}
+
+void
+golsat_board_cleanup(struct golsat_board *board)
+{
+    free(board->words);
+    free(board);
+}
+
+int
+golsat_board_get(const struct golsat_board *board, int x, int y)
+{
+    const unsigned long *row = board->words + (y + 1) * board->stride;
+
+    return (int)(row[(x + 1) / GOLSAT_WORD_BITS]
+                 >> ((x + 1) % GOLSAT_WORD_BITS))
+           & 1;
+}
+
+void
+golsat_board_set(struct golsat_board *board, int x, int y, int alive)
+{
+    unsigned long *word = board->words + (y + 1) * board->stride
+                          + (x + 1) / GOLSAT_WORD_BITS;
+    const unsigned long bit = 1ul << ((x + 1) % GOLSAT_WORD_BITS);
+
+    if (alive)
+        *word |= bit;
+    else
+        *word &= ~bit;
+}
+
+static int
+_golsat_step_popcount(unsigned long word)
+{
+    int count = 0;
+
+    for (; word; word &= word - 1)
+        ++count;
+
+    return count;
+}
+
+/* the cells of a row shifted so that each sees its west or east neighbour */
+static unsigned long
+_golsat_step_west(const unsigned long *row, size_t w)
+{
+    return (row[w] << 1) | (w ? row[w - 1] >> (GOLSAT_WORD_BITS - 1) : 0);
+}
+
+static unsigned long
+_golsat_step_east(const unsigned long *row, size_t w, size_t stride)
+{
+    return (row[w] >> 1)
+           | (w + 1 < stride ? row[w + 1] << (GOLSAT_WORD_BITS - 1) : 0);
+}
+
+int
+golsat_board_step(const struct golsat_board *board,
+                  struct golsat_board *next,
+                  const struct golsat_rule *rule)
+{
+    const size_t stride = board->stride, last = stride - 1;
+    const int rows = board->height + 2, frame = board->width + 1;
+    const unsigned long tail =
+        (frame + 1) % GOLSAT_WORD_BITS
+            ? (1ul << ((frame + 1) % GOLSAT_WORD_BITS)) - 1
+            : ~0ul;
+    int births = 0, y, n;
+    size_t w;
+
+    for (y = 0; y < rows; ++y) {
+        const unsigned long *up = y > 0 ? board->words + (y - 1) * stride
+                                        : NULL,
+                            *row = board->words + y * stride,
+                            *down = y + 1 < rows ? row + stride : NULL;
+        unsigned long *out = next->words + y * stride;
+
+        for (w = 0; w < stride; ++w) {
+            unsigned long uw = 0, uc = 0, ue = 0, dw = 0, dc = 0, de = 0;
+            unsigned long rw, re, s1, s2, s3, c1, c2, c3, c4, c5, c6, t;
+            unsigned long count[4], born = 0, kept = 0;
+
+            if (up) {
+                uw = _golsat_step_west(up, w);
+                uc = up[w];
+                ue = _golsat_step_east(up, w, stride);
+            }
+            rw = _golsat_step_west(row, w);
+            re = _golsat_step_east(row, w, stride);
+            if (down) {
+                dw = _golsat_step_west(down, w);
+                dc = down[w];
+                de = _golsat_step_east(down, w, stride);
+            }
+
+            /* add the eight neighbours up bit by bit, with full adders */
+            s1 = uw ^ uc ^ ue;
+            c1 = (uw & uc) | (ue & (uw ^ uc));
+            s2 = dw ^ dc ^ de;
+            c2 = (dw & dc) | (de & (dw ^ dc));
+            s3 = rw ^ re;
+            c3 = rw & re;
+            count[0] = s1 ^ s2 ^ s3;
+            c4 = (s1 & s2) | (s3 & (s1 ^ s2));
+            t = c1 ^ c2 ^ c3;
+            c5 = (c1 & c2) | (c3 & (c1 ^ c2));
+            count[1] = t ^ c4;
+            c6 = t & c4;
+            count[2] = c5 ^ c6;
+            count[3] = c5 & c6;
+
+            for (n = 0; n <= 8; ++n) {
+                unsigned long equal;
+
+                if (!(((rule->birth | rule->survival) >> n) & 1)) continue;
+                equal = (n & 1 ? count[0] : ~count[0])
+                        & (n & 2 ? count[1] : ~count[1])
+                        & (n & 4 ? count[2] : ~count[2])
+                        & (n & 8 ? count[3] : ~count[3]);
+                if ((rule->birth >> n) & 1) born |= equal;
+                if ((rule->survival >> n) & 1) kept |= equal;
+            }
+            out[w] = (row[w] & kept) | (~row[w] & born);
+        }
+        out[last] &= tail;
+
+        /* the frame stays dead, births there are only counted */
+        if (y == 0 || y == rows - 1) {
+            for (w = 0; w < stride; ++w) {
+                births += _golsat_step_popcount(out[w]);
+                out[w] = 0;
+            }
+            continue;
+        }
+        births += (int)(out[0] & 1);
+        births += (int)(out[frame / GOLSAT_WORD_BITS]
+                        >> (frame % GOLSAT_WORD_BITS))
+                  & 1;
+        out[0] &= ~1ul;
+        out[frame / GOLSAT_WORD_BITS] &= ~(1ul << (frame % GOLSAT_WORD_BITS));
+    }
+
+    return births;
+}
+
+int
+golsat_step(const unsigned char *cells,
+            unsigned char *next,
+            int width,
+            int height)
+{
+    struct golsat_board *board, *stepped;
+    struct golsat_rule rule;
+    int births = -1, x, y;
+
+    board = golsat_board_create(width, height);
+    stepped = golsat_board_create(width, height);
+    if (!board || !stepped) goto _cleanup;
+
+    for (y = 0; y < height; ++y)
+        for (x = 0; x < width; ++x)
+            golsat_board_set(board, x, y, cells[x + y * width]);
+
+    golsat_rule_life(&rule);
+    births = golsat_board_step(board, stepped, &rule);
+
+    for (y = 0; y < height; ++y)
+        for (x = 0; x < width; ++x)
+            next[x + y * width] =
+                (unsigned char)golsat_board_get(stepped, x, y);
+
+_cleanup:
+    if (board) golsat_board_cleanup(board);
+    if (stepped) golsat_board_cleanup(stepped);
+
+    return births;
+}
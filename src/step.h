@@ -0,0 +1,65 @@
+#ifndef GOLSAT_STEP_H
+#define GOLSAT_STEP_H
+
+#include <stddef.h>
+
+/* cells packed in a word of a board */
+#define GOLSAT_WORD_BITS (sizeof(unsigned long) * 8)
+
+/* bit n of `birth` or `survival` is set if n live neighbours do that */
+struct golsat_rule {
+    unsigned birth;
+    unsigned survival;
+};
+
+/*
+ * A board packed GOLSAT_WORD_BITS cells per word, row by row, surrounded
+ * by a dead frame one cell wide. Cell (x, y) is bit (x + 1) % BITS of
+ * word (x + 1) / BITS of row y + 1.
+ */
+struct golsat_board {
+    int width;
+    int height;
+    size_t stride; /* words per row */
+    unsigned long *words;
+};
+
+/* B3/S23 */
+void golsat_rule_life(struct golsat_rule *rule);
+
+/*
+ * Parse a rule the way lifesrc's -R does: born/survive digits separated
+ * by '/' or ',', optionally prefixed by B and S, or Wolfram's hex format.
+ * Returns 0 if `text` is not a rule.
+ */
+int golsat_rule_parse(const char *text, struct golsat_rule *rule);
+
+/* returns NULL on allocation failure, the board starts out dead */
+struct golsat_board *golsat_board_create(int width, int height);
+void golsat_board_cleanup(struct golsat_board *board);
+int golsat_board_get(const struct golsat_board *board, int x, int y);
+void golsat_board_set(struct golsat_board *board, int x, int y, int alive);
+
+/*
+ * Compute the next generation of `board` into `next`, which has the same
+ * size, a word of cells at a time. Cells that would be born in the frame
+ * are counted and returned, so 0 means the result fits the board; `next`
+ * is left with a dead frame either way.
+ */
+int golsat_board_step(const struct golsat_board *board,
+                      struct golsat_board *next,
+                      const struct golsat_rule *rule);
+
+/*
+ * Compute the next B3/S23 generation of a `width` x `height` board whose
+ * surroundings are dead. Boards hold one byte per cell, row by row, 1 for
+ * alive and 0 for dead. Cells that would be born outside of the board are
+ * counted and returned, so 0 means the result fits the board, and -1 is
+ * returned on allocation failure.
+ */
+int golsat_step(const unsigned char *cells,
+                unsigned char *next,
+                int width,
+                int height);
+
+#endif /* !GOLSAT_STEP_H */
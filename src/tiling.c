@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "commandline.h"
+#include "tiling.h"
+
+/* a row of `plane`, which keeps the rows a window of `tiling->kept` long */
+static unsigned char *
+_golsat_tiling_row(const struct golsat_tiling *tiling,
+                   unsigned char *plane,
+                   const int y)
+{
+    return plane + (size_t)(y % tiling->kept) * tiling->width;
+}
+
+/* the next cell of the target in the format of pattern.c, -1 at the end */
+static int
+_golsat_tiling_cell(FILE *in)
+{
+    int c;
+
+    while ((c = fgetc(in)) != EOF) {
+        switch (c) {
+        case '.':
+        case '0':
+            return GOLSAT_CELLSTATE_DEAD;
+        case 'X':
+        case '1':
+            return GOLSAT_CELLSTATE_ALIVE;
+        case '?':
+            return GOLSAT_CELLSTATE_UNKNOWN;
+        }
+    }
+
+    return -1;
+}
+
+/* read the target rows before `rows`, returns 0 if they are not there */
+static int
+_golsat_tiling_read(struct golsat_tiling *tiling, const int rows)
+{
+    unsigned char *row;
+    int x, cell;
+
+    for (; tiling->read < rows; ++tiling->read) {
+        row = _golsat_tiling_row(tiling, tiling->target, tiling->read);
+        for (x = 0; x < tiling->width; ++x) {
+            if ((cell = _golsat_tiling_cell(tiling->in)) == -1) {
+                fprintf(stderr, "Pattern parsing failed when parsing cell "
+                                "(not enough characters).\n");
+                return 0;
+            }
+            row[x] = (unsigned char)cell;
+        }
+    }
+    if (tiling->read == tiling->height
+        && _golsat_tiling_cell(tiling->in) != -1)
+    {
+        fprintf(stderr, "Pattern parsing failed when parsing cells "
+                        "(too many characters).\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+struct golsat_tiling *
+golsat_tiling_create(FILE *in,
+                     FILE *out,
+                     const int size,
+                     const int steps,
+                     const struct golsat_rule *rule)
+{
+    struct golsat_tiling *tiling;
+
+    if (!(tiling = calloc(1, sizeof *tiling))) return NULL;
+    if (fscanf(in, "%d %d", &tiling->width, &tiling->height) != 2
+        || tiling->width <= 0 || tiling->height <= 0)
+    {
+        fprintf(stderr,
+                "Pattern parsing failed when reading WIDTH and HEIGHT.\n");
+        free(tiling);
+        return NULL;
+    }
+    tiling->in = in;
+    tiling->out = out;
+    tiling->size = size;
+    tiling->steps = steps;
+    tiling->rule = *rule;
+    tiling->columns = (tiling->width + size - 1) / size;
+    tiling->bands = (tiling->height + size - 1) / size;
+
+    /*
+     * Solving a band can take the band above back, which is when the one
+     * above that is written out. The rows checked then reach two times
+     * `steps` rows above it, and the rows read all the margins below the
+     * band solved.
+     */
+    tiling->kept = 3 * size + (GOLSAT_TILING_MARGINS + 2) * steps + 1;
+    if (tiling->kept > tiling->height) tiling->kept = tiling->height;
+    tiling->target = malloc((size_t)tiling->kept * tiling->width);
+    tiling->ancestor = calloc((size_t)tiling->kept * tiling->width, 1);
+    if (!tiling->target || !tiling->ancestor) {
+        golsat_tiling_cleanup(tiling);
+        return NULL;
+    }
+
+    fprintf(out, "%d %d\n", tiling->width, tiling->height);
+
+    return tiling;
+}
+
+void
+golsat_tiling_cleanup(struct golsat_tiling *tiling)
+{
+    free(tiling->target);
+    free(tiling->ancestor);
+    free(tiling);
+}
+
+/* frame the board of `tile`, its margins cut off at the target's edges */
+static void
+_golsat_tiling_frame(const struct golsat_tiling *tiling,
+                     struct golsat_tile *tile)
+{
+    const int margin = GOLSAT_TILING_MARGINS * tiling->steps;
+    int end;
+
+    tile->board_x = tile->x > margin ? tile->x - margin : 0;
+    end = tile->x + tile->width + margin;
+    tile->board_width =
+        (end < tiling->width ? end : tiling->width) - tile->board_x;
+    tile->board_y = tile->y > margin ? tile->y - margin : 0;
+    end = tile->y + tile->height + margin;
+    tile->board_height =
+        (end < tiling->height ? end : tiling->height) - tile->board_y;
+}
+
+void
+golsat_tiling_tile(const struct golsat_tiling *tiling,
+                   const int index,
+                   struct golsat_tile *tile)
+{
+    tile->index = index;
+    tile->band = index / tiling->columns;
+    tile->column = index % tiling->columns;
+    tile->x = tile->column * tiling->size;
+    tile->y = tile->band * tiling->size;
+    tile->width = tiling->width - tile->x < tiling->size
+                      ? tiling->width - tile->x
+                      : tiling->size;
+    tile->height = tiling->height - tile->y < tiling->size
+                       ? tiling->height - tile->y
+                       : tiling->size;
+    _golsat_tiling_frame(tiling, tile);
+}
+
+int
+golsat_tiling_join(const struct golsat_tiling *tiling,
+                   struct golsat_tile *tile,
+                   const struct golsat_tile *other)
+{
+    struct golsat_tile joined = *tile;
+    int end;
+
+    joined.x = tile->x < other->x ? tile->x : other->x;
+    end = tile->x + tile->width > other->x + other->width
+              ? tile->x + tile->width
+              : other->x + other->width;
+    joined.width = end - joined.x;
+    joined.y = tile->y < other->y ? tile->y : other->y;
+    end = tile->y + tile->height > other->y + other->height
+              ? tile->y + tile->height
+              : other->y + other->height;
+    joined.height = end - joined.y;
+    _golsat_tiling_frame(tiling, &joined);
+    /* more tiles than two side by side take lifesrc too long */
+    if (joined.width * joined.height
+            > tile->width * tile->height + other->width * other->height
+        || joined.board_width > GOLSAT_TILE_BOARD_MAX
+        || joined.board_height > GOLSAT_TILE_BOARD_MAX)
+        return 0;
+    *tile = joined;
+
+    return 1;
+}
+
+/* how far the cell (`x`, `y`) lies from `tile`, diagonally too */
+static int
+_golsat_tiling_distance(const struct golsat_tile *tile,
+                        const int x,
+                        const int y)
+{
+    int dx = 0, dy = 0;
+
+    if (x < tile->x)
+        dx = tile->x - x;
+    else if (x >= tile->x + tile->width)
+        dx = x - (tile->x + tile->width) + 1;
+    if (y < tile->y)
+        dy = tile->y - y;
+    else if (y >= tile->y + tile->height)
+        dy = y - (tile->y + tile->height) + 1;
+
+    return dx > dy ? dx : dy;
+}
+
+/* whether the cell (`x`, `y`) is a loose one */
+static int
+_golsat_tiling_loose(const struct golsat_tiling *tiling,
+                     const int x,
+                     const int y)
+{
+    int i;
+
+    for (i = 0; i < tiling->loose_count; ++i)
+        if (tiling->loose[i] == y * tiling->width + x) return 1;
+
+    return 0;
+}
+
+/* the tile giving the cell (`x`, `y`) to the board of `tile`, or -1 */
+static int
+_golsat_tiling_giver(const struct golsat_tiling *tiling,
+                     const struct golsat_tile *tile,
+                     const int x,
+                     const int y)
+{
+    const int distance = _golsat_tiling_distance(tile, x, y),
+              owner = golsat_tiling_owner(tiling, y * tiling->width + x);
+
+    return distance > 0
+                   && distance <= (GOLSAT_TILING_CHECKED + 1) * tiling->steps
+                   && owner < tile->index
+               ? owner
+               : -1;
+}
+
+struct golsat_pattern *
+golsat_tiling_board(struct golsat_tiling *tiling,
+                    const struct golsat_tile *tile,
+                    FILE *f_ancestor)
+{
+    struct golsat_pattern *board;
+    int x, y;
+
+    if (!_golsat_tiling_read(tiling, tile->board_y + tile->board_height))
+        return NULL;
+
+    if (!(board = calloc(1, sizeof *board))) return NULL;
+    board->width = tile->board_width;
+    board->height = tile->board_height;
+    if (!(board->cells = malloc((size_t)board->width * board->height
+                                * sizeof *board->cells)))
+    {
+        free(board);
+        return NULL;
+    }
+
+    for (y = tile->board_y; y < tile->board_y + tile->board_height; ++y) {
+        const unsigned char
+            *target = _golsat_tiling_row(tiling, tiling->target, y),
+            *ancestor = _golsat_tiling_row(tiling, tiling->ancestor, y);
+        enum golsat_cellstate *cell =
+            board->cells + (y - tile->board_y) * board->width;
+
+        for (x = tile->board_x; x < tile->board_x + tile->board_width;
+             ++x, ++cell)
+        {
+            *cell = _golsat_tiling_distance(tile, x, y)
+                            <= GOLSAT_TILING_CHECKED * tiling->steps
+                        ? (enum golsat_cellstate)target[x]
+                        : GOLSAT_CELLSTATE_UNKNOWN;
+
+            if (_golsat_tiling_giver(tiling, tile, x, y) == -1
+                || _golsat_tiling_loose(tiling, x, y))
+                fputc('?', f_ancestor);
+            else
+                fputc(ancestor[x] ? 'O' : '.', f_ancestor);
+        }
+        fputc('\n', f_ancestor);
+    }
+
+    return board;
+}
+
+int
+golsat_tiling_owner(const struct golsat_tiling *tiling, const int cell)
+{
+    return (cell / tiling->width / tiling->size) * tiling->columns
+           + cell % tiling->width / tiling->size;
+}
+
+int
+golsat_tiling_backjump(const struct golsat_tiling *tiling,
+                       const struct golsat_tile *tile,
+                       const int floor)
+{
+    int last = -1, owner, x, y;
+
+    for (y = tile->board_y; y < tile->board_y + tile->board_height; ++y)
+        for (x = tile->board_x; x < tile->board_x + tile->board_width; ++x)
+            if ((owner = _golsat_tiling_giver(tiling, tile, x, y)) > last)
+                last = owner;
+
+    return last >= floor ? last : -1;
+}
+
+int
+golsat_tiling_given(const struct golsat_tiling *tiling,
+                    const struct golsat_tile *tile,
+                    const int floor,
+                    int *cells)
+{
+    int count = 0, owner, x, y;
+
+    /* in the order the tiles giving them were solved */
+    for (owner = floor; owner < tile->index; ++owner) {
+        for (y = tile->board_y; y < tile->board_y + tile->board_height;
+             ++y)
+        {
+            for (x = tile->board_x; x < tile->board_x + tile->board_width;
+                 ++x)
+            {
+                if (_golsat_tiling_giver(tiling, tile, x, y) == owner)
+                    cells[count++] = y * tiling->width + x;
+            }
+        }
+    }
+
+    return count;
+}
+
+char *
+golsat_tiling_nogood(const struct golsat_tiling *tiling,
+                     const struct golsat_tile *tile,
+                     const int *cells,
+                     const int count)
+{
+    char *nogood, *end;
+    int owned = 0, i;
+
+    for (i = 0; i < count; ++i)
+        owned += golsat_tiling_owner(tiling, cells[i]) == tile->index;
+    if (!owned || owned > GOLSAT_NOGOOD_SIZE) return NULL;
+
+    /* the rows and columns of lifesrc have at most 3 digits */
+    if (!(nogood = end = malloc((size_t)owned * 12 + 2))) return NULL;
+
+    for (i = 0; i < count; ++i) {
+        const int x = cells[i] % tiling->width, y = cells[i] / tiling->width;
+
+        if (golsat_tiling_owner(tiling, cells[i]) != tile->index) continue;
+        end += sprintf(end, "%d %d 0 %d ", y - tile->board_y + 1,
+                       x - tile->board_x + 1,
+                       _golsat_tiling_row(tiling, tiling->ancestor, y)[x]);
+    }
+    strcpy(end, "\n");
+
+    return nogood;
+}
+
+int
+golsat_tiling_keep(struct golsat_tiling *tiling,
+                   const struct golsat_tile *tile,
+                   const struct golsat_result *result)
+{
+    int live_cells = 0, x, y;
+
+    for (y = tile->y; y < tile->y + tile->height; ++y) {
+        unsigned char *row = _golsat_tiling_row(tiling, tiling->ancestor, y);
+
+        for (x = tile->x; x < tile->x + tile->width; ++x) {
+            row[x] = golsat_result_get_cell(result, x - tile->board_x,
+                                            y - tile->board_y)
+                     == GOLSAT_CELLSTATE_ALIVE;
+            live_cells += row[x];
+        }
+    }
+
+    return live_cells;
+}
+
+/*
+ * Check the target rows from `tiling->verified` up to `end`, stepping the
+ * ancestor rows they depend on forward on a board of their own. The rows
+ * past either end of that board are taken as dead, which only affects
+ * the rows within `steps` of its ends, none of them checked unless the
+ * end is that of the target.
+ */
+static int
+_golsat_tiling_verify(struct golsat_tiling *tiling, const int end)
+{
+    const int first = tiling->verified > tiling->steps
+                          ? tiling->verified - tiling->steps
+                          : 0,
+              last = end + tiling->steps < tiling->height
+                         ? end + tiling->steps
+                         : tiling->height;
+    struct golsat_board *board, *next, *swap;
+    int ok = 0, x, y, step;
+
+    board = golsat_board_create(tiling->width, last - first);
+    next = golsat_board_create(tiling->width, last - first);
+    if (!board || !next) goto _cleanup;
+
+    for (y = first; y < last; ++y) {
+        const unsigned char *row =
+            _golsat_tiling_row(tiling, tiling->ancestor, y);
+
+        for (x = 0; x < tiling->width; ++x)
+            golsat_board_set(board, x, y - first, row[x]);
+    }
+
+    /* births past the sides are left to lifesrc, which rules them out */
+    for (step = 0; step < tiling->steps; ++step) {
+        golsat_board_step(board, next, &tiling->rule);
+        swap = board;
+        board = next;
+        next = swap;
+    }
+
+    for (y = tiling->verified; y < end; ++y) {
+        const unsigned char *row =
+            _golsat_tiling_row(tiling, tiling->target, y);
+
+        for (x = 0; x < tiling->width; ++x) {
+            if (row[x] != GOLSAT_CELLSTATE_UNKNOWN
+                && (row[x] == GOLSAT_CELLSTATE_ALIVE)
+                       != golsat_board_get(board, x, y - first))
+            {
+                goto _cleanup;
+            }
+        }
+    }
+    tiling->verified = end;
+    ok = 1;
+
+_cleanup:
+    if (board) golsat_board_cleanup(board);
+    if (next) golsat_board_cleanup(next);
+
+    return ok;
+}
+
+int
+golsat_tiling_commit(struct golsat_tiling *tiling, const int rows)
+{
+    const int end = rows == tiling->height ? rows : rows - tiling->steps;
+    int x;
+
+    for (; tiling->written < rows; ++tiling->written) {
+        const unsigned char *row =
+            _golsat_tiling_row(tiling, tiling->ancestor, tiling->written);
+
+        for (x = 0; x < tiling->width; ++x) {
+            fputc(row[x] ? '1' : '0', tiling->out);
+            tiling->live_cells += row[x];
+        }
+        fputc('\n', tiling->out);
+    }
+    fflush(tiling->out);
+
+    return end <= tiling->verified || _golsat_tiling_verify(tiling, end);
+}
+
+void
+golsat_tiling_abandon(struct golsat_tiling *tiling)
+{
+    int x;
+
+    for (; tiling->written < tiling->height; ++tiling->written) {
+        for (x = 0; x < tiling->width; ++x)
+            fputc('0', tiling->out);
+        fputc('\n', tiling->out);
+    }
+}
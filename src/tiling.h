@@ -0,0 +1,159 @@
+#ifndef GOLSAT_TILING_H
+#define GOLSAT_TILING_H
+
+#include <stdio.h>
+
+#include "pattern.h"
+#include "protocol.h"
+#include "step.h"
+
+/* margins of `steps` cells past a tile which the target is checked in */
+#define GOLSAT_TILING_CHECKED 2
+/* margins of `steps` cells the board of a tile reaches past it */
+#define GOLSAT_TILING_MARGINS (GOLSAT_TILING_CHECKED + 2)
+/* most cells of a nogood, see NOGOOD_SIZE */
+#define GOLSAT_NOGOOD_SIZE 256
+
+/*
+ * A target too large to be searched at once, solved a square tile at a
+ * time: the tiles are taken in bands from top to bottom, and from left to
+ * right within a band. The board lifesrc searches for a tile reaches
+ * GOLSAT_TILING_MARGINS margins of `steps` cells past it:
+ *
+ *   - the target is checked up to GOLSAT_TILING_CHECKED margins past the
+ *     tile, the rest of the board being unknown, so that the target cells
+ *     next to tiles solved before are checked against the tile too, and
+ *     the tile leaves its neighbours solved after it some room;
+ *   - the ancestor cells up to one margin further that belong to tiles
+ *     solved before are given, as they determine those target cells
+ *     together with the tile;
+ *   - the outermost margin is left free, as lifesrc takes the cells past
+ *     its board as dead in every generation.
+ *
+ * Only the rows of the target and ancestor near the bands being solved
+ * are kept, the ancestor rows which can no longer change are written out
+ * as they come.
+ */
+struct golsat_tiling {
+    FILE *in;  /* the target past the rows read */
+    FILE *out; /* the ancestor, in the format gol-sat prints */
+    int width;
+    int height;
+    int size; /* side of a tile */
+    int steps;
+    struct golsat_rule rule;
+    int columns; /* tiles in a band */
+    int bands;
+    int kept;     /* rows of the windows below, a row y is kept at y % kept */
+    int read;     /* target rows read */
+    int written;  /* ancestor rows written */
+    int verified; /* target rows the written ancestor was checked against */
+    int live_cells; /* in the ancestor rows written */
+    unsigned char *target;   /* enum golsat_cellstate */
+    unsigned char *ancestor; /* 1 if alive */
+    /* given ancestor cells left unknown on boards, at y * width + x */
+    const int *loose;
+    int loose_count;
+};
+
+/*
+ * A tile and the board lifesrc searches for it, which may be widened to
+ * cover tiles solved after it too.
+ */
+struct golsat_tile {
+    int index; /* in the order the tiles are solved */
+    int band;
+    int column;
+    int x, y, width, height;
+    int board_x, board_y, board_width, board_height;
+};
+
+/*
+ * Read the size of the target from `in`, the cells being read as they are
+ * needed. Returns NULL if the size cannot be read, or on allocation
+ * failure.
+ */
+struct golsat_tiling *golsat_tiling_create(FILE *in,
+                                           FILE *out,
+                                           int size,
+                                           int steps,
+                                           const struct golsat_rule *rule);
+void golsat_tiling_cleanup(struct golsat_tiling *tiling);
+
+void golsat_tiling_tile(const struct golsat_tiling *tiling,
+                        int index,
+                        struct golsat_tile *tile);
+
+/*
+ * Widen `tile` to cover `other`, a tile solved after it which has no
+ * ancestor with the cells `tile` gave it, so that both are solved on one
+ * board. Returns 0, leaving `tile` as it is, unless they are side by side
+ * and their board is not larger than lifesrc searches. The board keeps the
+ * corner of that of `tile`, and so the cells it was told to rule out.
+ */
+int golsat_tiling_join(const struct golsat_tiling *tiling,
+                       struct golsat_tile *tile,
+                       const struct golsat_tile *other);
+
+/*
+ * The tile solved last of those giving cells to the board of `tile`, or
+ * -1 if it has none from tile `floor` on.
+ */
+int golsat_tiling_backjump(const struct golsat_tiling *tiling,
+                           const struct golsat_tile *tile,
+                           int floor);
+
+/*
+ * The target lifesrc searches for `tile`, having written the ancestor
+ * cells given by the tiles solved before it, but for the loose ones, to
+ * `f_ancestor` in lifesrc's format. Returns NULL if the target cannot be
+ * read, or on allocation failure.
+ */
+struct golsat_pattern *golsat_tiling_board(struct golsat_tiling *tiling,
+                                           const struct golsat_tile *tile,
+                                           FILE *f_ancestor);
+
+/* the tile the ancestor cell at y * width + x belongs to */
+int golsat_tiling_owner(const struct golsat_tiling *tiling, int cell);
+
+/*
+ * Store the ancestor cells given to the board of `tile` by its neighbours
+ * from tile `floor` on in `cells`, at y * width + x, those of the tiles
+ * solved first coming first. `cells` has room for every cell of the
+ * board. Returns their number.
+ */
+int golsat_tiling_given(const struct golsat_tiling *tiling,
+                        const struct golsat_tile *tile,
+                        int floor,
+                        int *cells);
+
+/*
+ * The ancestor at those of `count` `cells` which belong to `tile`, as a
+ * line of "row col gen state" numbers on the board of `tile`, which is
+ * how lifesrc reads the nogoods it is to rule out. Returns NULL if there
+ * are none or more than GOLSAT_NOGOOD_SIZE, or on allocation failure.
+ */
+char *golsat_tiling_nogood(const struct golsat_tiling *tiling,
+                           const struct golsat_tile *tile,
+                           const int *cells,
+                           int count);
+
+/*
+ * Keep the ancestor of `tile` found by lifesrc for its board, its unknown
+ * cells taken as dead. Returns its number of live cells.
+ */
+int golsat_tiling_keep(struct golsat_tiling *tiling,
+                       const struct golsat_tile *tile,
+                       const struct golsat_result *result);
+
+/*
+ * Write the ancestor rows before `rows`, whose tiles are all solved for
+ * good, and check the target rows they determine on their own. Returns 0
+ * if the ancestor does not evolve into them, or on allocation failure.
+ */
+int golsat_tiling_commit(struct golsat_tiling *tiling, int rows);
+
+/* write the rows left as dead, once no ancestor is to be found */
+void golsat_tiling_abandon(struct golsat_tiling *tiling);
+
+#endif /* !GOLSAT_TILING_H */
@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "worker.h"
+#include "network.h"
+#include "popen2.h"
+#include "protocol.h"
+#include "runner.h"
+#include "stats.h"
+
+/* longest file name of a job */
+#define _GOLSAT_WORKER_PATH_MAX 64
+/* longest lifesrc command line of a job */
+#define _GOLSAT_WORKER_COMMAND_MAX 2048
+
+struct _golsat_worker {
+    int fd;
+    struct golsat_protocol_reader reader;
+    char pattern_path[_GOLSAT_WORKER_PATH_MAX];
+    char cube_path[_GOLSAT_WORKER_PATH_MAX];
+    /* the job being run, if any */
+    int running;
+    unsigned char id[4];
+    struct popen2 exec;
+    struct golsat_protocol_reader output;
+    unsigned char *result;
+    size_t result_length;
+};
+
+static int
+_golsat_worker_write(const char *path, const char *text)
+{
+    FILE *f;
+
+    if (!(f = fopen(path, "w"))) {
+        perror(path);
+        return 0;
+    }
+    fputs(text, f);
+    fputc('\n', f);
+
+    return fclose(f) == 0;
+}
+
+/* report the result of the job, which is empty if lifesrc was killed */
+static void
+_golsat_worker_finish(struct _golsat_worker *worker)
+{
+    unsigned char *done;
+    int exec_status;
+
+    close(worker->exec.from_child);
+    golsat_protocol_cleanup(&worker->output);
+    waitpid(worker->exec.child_pid, &exec_status, 0);
+    worker->running = 0;
+
+    if ((done = malloc(sizeof(worker->id) + worker->result_length))) {
+        memcpy(done, worker->id, sizeof(worker->id));
+        if (worker->result)
+            memcpy(done + sizeof(worker->id), worker->result,
+                   worker->result_length);
+        golsat_network_send(worker->fd, GOLSAT_NETWORK_DONE, done,
+                            sizeof(worker->id) + worker->result_length);
+        free(done);
+    }
+    free(worker->result);
+    worker->result = NULL;
+    worker->result_length = 0;
+}
+
+/* keep the result frame of the job, returns 0 once lifesrc is done */
+static int
+_golsat_worker_read(struct _golsat_worker *worker)
+{
+    struct golsat_protocol_frame frame;
+    unsigned char chunk[4096];
+    ssize_t bytes_read;
+
+    do
+        bytes_read = read(worker->exec.from_child, chunk, sizeof(chunk));
+    while (bytes_read < 0 && errno == EINTR);
+
+    if (bytes_read <= 0) return 0;
+    if (!golsat_protocol_feed(&worker->output, chunk, (size_t)bytes_read))
+        return 1;
+
+    while (golsat_protocol_next(&worker->output, &frame) == 1) {
+        if (frame.type != REPORT_RESULT || worker->result) continue;
+        if (!(worker->result = malloc(frame.length))) continue;
+        memcpy(worker->result, frame.payload, frame.length);
+        worker->result_length = frame.length;
+    }
+
+    return 1;
+}
+
+/* stop the job and wait for its result */
+static void
+_golsat_worker_stop(struct _golsat_worker *worker)
+{
+    kill(worker->exec.child_pid, SIGTERM);
+    while (_golsat_worker_read(worker))
+        continue;
+    _golsat_worker_finish(worker);
+}
+
+static void
+_golsat_worker_start(struct _golsat_worker *worker,
+                     const struct golsat_protocol_frame *frame)
+{
+    char command[_GOLSAT_WORKER_COMMAND_MAX];
+    char *text, *arguments, *cube, *pattern, *end;
+    unsigned long id;
+    int timeout;
+
+    if (worker->running) _golsat_worker_stop(worker);
+
+    if (!(text = malloc(frame->length + 1))) return;
+    memcpy(text, frame->payload, frame->length);
+    text[frame->length] = '\0';
+
+    id = strtoul(text, &end, 10);
+    timeout = (int)strtol(end, &end, 10);
+    worker->id[0] = (unsigned char)(id >> 24);
+    worker->id[1] = (unsigned char)(id >> 16);
+    worker->id[2] = (unsigned char)(id >> 8);
+    worker->id[3] = (unsigned char)id;
+
+    arguments = end + 1;
+    if (*end != '\n' || !(end = strchr(arguments, '\n'))) goto _malformed;
+    *end = '\0';
+    cube = end + 1;
+    if (!(end = strchr(cube, '\n'))) goto _malformed;
+    *end = '\0';
+    pattern = end + 1;
+    if (strlen(arguments) + 3 * _GOLSAT_WORKER_PATH_MAX
+        >= sizeof(command))
+    {
+        goto _malformed;
+    }
+    /* the job comes from the network, it may only tune the search */
+    if (timeout <= 0 || !golsat_runner_tuning(arguments)
+        || strspn(cube, "0123456789 ") != strlen(cube))
+    {
+        goto _malformed;
+    }
+
+    if (!_golsat_worker_write(worker->pattern_path, pattern)
+        || (*cube && !_golsat_worker_write(worker->cube_path, cube)))
+    {
+        goto _malformed;
+    }
+    sprintf(command, "timeout -k 1 %d %s %s%s%s -i %s", timeout,
+            golsat_runner_engine(arguments), arguments, *cube ? " -k1 " : "",
+            *cube ? worker->cube_path : "", worker->pattern_path);
+    free(text);
+
+    if (popen2(command, &worker->exec) != 0) {
+        perror("popen2");
+        golsat_network_send(worker->fd, GOLSAT_NETWORK_DONE, worker->id,
+                            sizeof(worker->id));
+        return;
+    }
+    close(worker->exec.to_child);
+    golsat_protocol_init(&worker->output);
+    worker->running = 1;
+    return;
+
+_malformed:
+    fprintf(stderr, "-- Error: malformed job\n");
+    free(text);
+    golsat_network_send(worker->fd, GOLSAT_NETWORK_DONE, worker->id,
+                        sizeof(worker->id));
+}
+
+/* handle the frames of the coordinator, returns 0 once it is gone */
+static int
+_golsat_worker_receive(struct _golsat_worker *worker)
+{
+    struct golsat_protocol_frame frame;
+    unsigned char chunk[4096];
+    ssize_t bytes_read;
+    int ret;
+
+    do
+        bytes_read = read(worker->fd, chunk, sizeof(chunk));
+    while (bytes_read < 0 && errno == EINTR);
+
+    if (bytes_read <= 0) return 0;
+    if (!golsat_protocol_feed(&worker->reader, chunk, (size_t)bytes_read))
+        return 0;
+
+    while ((ret = golsat_protocol_next(&worker->reader, &frame)) == 1) {
+        switch (frame.type) {
+        case GOLSAT_NETWORK_JOB:
+            _golsat_worker_start(worker, &frame);
+            break;
+        case GOLSAT_NETWORK_CANCEL:
+            /* the result of a cancelled job is ignored, keep it short */
+            if (worker->running && frame.length == sizeof(worker->id)
+                && !memcmp(frame.payload, worker->id, sizeof(worker->id)))
+            {
+                kill(worker->exec.child_pid, SIGTERM);
+            }
+            break;
+        }
+    }
+
+    return ret != -1;
+}
+
+int
+golsat_worker_run(const char *address)
+{
+    const unsigned long heartbeat =
+        GOLSAT_NETWORK_HEARTBEAT_SECS * 1000000000ul;
+    struct _golsat_worker worker = { 0 };
+    unsigned long last_beat = 0;
+    struct pollfd fds[2];
+    int count;
+
+    if ((worker.fd = golsat_network_connect(address)) == -1) return 0;
+    /* a coordinator going away is noticed by reading instead */
+    signal(SIGPIPE, SIG_IGN);
+
+    sprintf(worker.pattern_path, "golsat-worker-%ld.txt", (long)getpid());
+    sprintf(worker.cube_path, "golsat-worker-%ld.cube", (long)getpid());
+    golsat_protocol_init(&worker.reader);
+
+    for (;;) {
+        const unsigned long now = golsat_stats_clock();
+
+        if (now - last_beat >= heartbeat) {
+            if (!golsat_network_send(worker.fd, GOLSAT_NETWORK_HEARTBEAT,
+                                     NULL, 0))
+            {
+                break;
+            }
+            last_beat = now;
+        }
+
+        fds[0].fd = worker.fd;
+        fds[0].events = POLLIN;
+        count = 1;
+        if (worker.running) {
+            fds[1].fd = worker.exec.from_child;
+            fds[1].events = POLLIN;
+            count = 2;
+        }
+        if (poll(fds, count, GOLSAT_NETWORK_HEARTBEAT_SECS * 1000) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            break;
+        }
+
+        if (count == 2 && fds[1].revents && !_golsat_worker_read(&worker))
+            _golsat_worker_finish(&worker);
+        if (fds[0].revents && !_golsat_worker_receive(&worker)) break;
+    }
+
+    if (worker.running) _golsat_worker_stop(&worker);
+    golsat_protocol_cleanup(&worker.reader);
+    close(worker.fd);
+    remove(worker.pattern_path);
+    remove(worker.cube_path);
+
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef GOLSAT_WORKER_H
+#define GOLSAT_WORKER_H
+
+/*
+ * Serve the coordinator at `address` (see network.h) until it closes the
+ * connection, running one lifesrc job at a time with ./lifesrc. A job is
+ * the text
+ *
+ *     ID TIMEOUT
+ *     LIFESRC OPTIONS
+ *     CUBE LINE, EMPTY FOR NONE
+ *     PATTERN IN LIFESRC'S FORMAT...
+ *
+ * and is answered with GOLSAT_NETWORK_DONE. Returns 0 if the coordinator
+ * could not be reached.
+ */
+int golsat_worker_run(const char *address);
+
+#endif /* !GOLSAT_WORKER_H */